@@ -0,0 +1,617 @@
+/**
+ *	FILE: bench_math.cpp
+ *	Benchmarks of the vec/mat/quat/curve/intercept/visibility/geometry kernels.
+ *	Single-object functions loop over the batch (scalar mode only); batch
+ *	functions run in every mode. Inputs are fixed pseudo-random values so runs
+ *	are comparable across commits.
+ */
+
+#include "benchmark.h"
+
+// Includes: Standard
+#include <vector>
+
+// Includes: Project
+#include "../src/vec.h"
+#include "../src/mat.h"
+#include "../src/quat.h"
+#include "../src/vecstream.h"
+#include "../src/curve.h"
+#include "../src/curvestream.h"
+#include "../src/spline.h"
+#include "../src/math3d.h"
+#include "../src/geometry.h"
+#include "../src/parallel.h"
+#include "../src/hierarchy.h"
+#include "../src/camera.h"
+#include "../src/trig.h"
+
+//////////////////////////////////////////////////////////
+// Input data
+//////////////////////////////////////////////////////////
+
+// Fixed-seed generator: values in [-1, 1)
+static float GetRandom(uint32_t& rSeed)
+{
+	rSeed = rSeed * 1664525u + 1013904223u;
+	return (float)(rSeed >> 8) * (2.0f / 16777216.0f) - 1.0f;
+}
+
+static vec3f GetRandomVec3(uint32_t& rSeed, float fScale)
+{
+	float x = GetRandom(rSeed);
+	float y = GetRandom(rSeed);
+	float z = GetRandom(rSeed);
+	return vec3f(fScale * x, fScale * y, fScale * z);
+}
+
+static void FillStream(vec3fStream& rStream, size_t count, float fScale, uint32_t seed)
+{
+	rStream.Resize(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		rStream.Set(i, GetRandomVec3(seed, fScale));
+	}
+}
+
+static void FillVector(std::vector<vec3f>& rVecs, size_t count, float fScale, uint32_t seed)
+{
+	rVecs.resize(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		rVecs[i] = GetRandomVec3(seed, fScale);
+	}
+}
+
+//////////////////////////////////////////////////////////
+// vec / mat
+//////////////////////////////////////////////////////////
+
+static void BM_Vec3CrossDot(BenchmarkState& rState)
+{
+	std::vector<vec3f> vecs;
+	FillVector(vecs, rState.GetBatchSize() + 1, 1.0f, 1);
+	while (rState.KeepRunning())
+	{
+		for (size_t i = 0; i < rState.GetBatchSize(); i++)
+		{
+			vec3f cross = vec3f::CrossProduct(vecs[i], vecs[i + 1]);
+			DoNotOptimize(vec3f::DotProduct(cross, vecs[i]));
+		}
+	}
+}
+BENCHMARK(BM_Vec3CrossDot, 100000, BENCH_MODES_SINGLE);
+
+static void BM_Mat44Multiply(BenchmarkState& rState)
+{
+	uint32_t seed = 2;
+	std::vector<mat44> mats(rState.GetBatchSize() + 1);
+	for (size_t i = 0; i < mats.size(); i++)
+	{
+		for (int r = 0; r < 4; r++)
+		{
+			for (int c = 0; c < 4; c++)
+			{
+				mats[i][r][c] = GetRandom(seed);
+			}
+		}
+	}
+
+	while (rState.KeepRunning())
+	{
+		for (size_t i = 0; i < rState.GetBatchSize(); i++)
+		{
+			DoNotOptimize(mats[i] * mats[i + 1]);
+		}
+	}
+}
+BENCHMARK(BM_Mat44Multiply, 100000, BENCH_MODES_SINGLE);
+
+static void BM_Mat44Inverse(BenchmarkState& rState)
+{
+	uint32_t seed = 3;
+	std::vector<mat44> mats(rState.GetBatchSize());
+	for (size_t i = 0; i < mats.size(); i++)
+	{
+		mats[i] = Quaternion::GetRotationR(GetRandomVec3(seed, 1.0f), GetRandom(seed)).GetRotationMatrix44();
+		mats[i][0][3] = GetRandom(seed);
+	}
+
+	mat44 inverse;
+	while (rState.KeepRunning())
+	{
+		for (size_t i = 0; i < rState.GetBatchSize(); i++)
+		{
+			DoNotOptimize(mats[i].TryGetInverse(inverse));
+			DoNotOptimize(inverse);
+		}
+	}
+}
+BENCHMARK(BM_Mat44Inverse, 100000, BENCH_MODES_SINGLE);
+
+static void BM_Mat44TransformPointsSoA(BenchmarkState& rState)
+{
+	vec3fStream points, result;
+	FillStream(points, rState.GetBatchSize(), 100.0f, 4);
+	result.Resize(rState.GetBatchSize());
+	mat44 transform = Quaternion::GetRotationD(vec3f(1.0f, 2.0f, 3.0f), 30.0f).GetRotationMatrix44();
+	transform[0][3] = 5.0f;
+
+	while (rState.KeepRunning())
+	{
+		transform.TransformPoints(points, result);
+	}
+}
+BENCHMARK(BM_Mat44TransformPointsSoA, BENCH_SIZE_MAX, BENCH_MODES_ALL);
+
+//////////////////////////////////////////////////////////
+// trig
+//////////////////////////////////////////////////////////
+
+static void FillAngles(std::vector<float>& rAngles, size_t count, float fRange, uint32_t seed)
+{
+	rAngles.resize(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		rAngles[i] = fRange * GetRandom(seed);
+	}
+}
+
+// Baseline: what the rotation builders used to do
+static void BM_SinCosLibm(BenchmarkState& rState)
+{
+	std::vector<float> angles;
+	FillAngles(angles, rState.GetBatchSize(), 360.0f, 23);
+
+	while (rState.KeepRunning())
+	{
+		for (size_t i = 0; i < rState.GetBatchSize(); i++)
+		{
+			double radians = angles[i] * (M_PI / 180.0);
+			DoNotOptimize((float)sin(radians) + (float)cos(radians));
+		}
+	}
+}
+BENCHMARK(BM_SinCosLibm, 100000, BENCH_MODES_SINGLE);
+
+static void BM_SinCosD(BenchmarkState& rState)
+{
+	std::vector<float> angles;
+	FillAngles(angles, rState.GetBatchSize(), 360.0f, 23);
+
+	while (rState.KeepRunning())
+	{
+		for (size_t i = 0; i < rState.GetBatchSize(); i++)
+		{
+			float s, c;
+			SinCosD(angles[i], s, c);
+			DoNotOptimize(s + c);
+		}
+	}
+}
+BENCHMARK(BM_SinCosD, 100000, BENCH_MODES_SINGLE);
+
+static void BM_SinCosTableD(BenchmarkState& rState)
+{
+	std::vector<float> angles;
+	FillAngles(angles, rState.GetBatchSize(), 360.0f, 23);
+
+	while (rState.KeepRunning())
+	{
+		for (size_t i = 0; i < rState.GetBatchSize(); i++)
+		{
+			float s, c;
+			SinCosTableD(angles[i], s, c);
+			DoNotOptimize(s + c);
+		}
+	}
+}
+BENCHMARK(BM_SinCosTableD, 100000, BENCH_MODES_SINGLE);
+
+static void BM_SinCosBatch(BenchmarkState& rState)
+{
+	std::vector<float> angles, sins(rState.GetBatchSize()), coss(rState.GetBatchSize());
+	FillAngles(angles, rState.GetBatchSize(), 10.0f, 24);
+
+	while (rState.KeepRunning())
+	{
+		SinCos(angles.data(), sins.data(), coss.data(), angles.size());
+	}
+}
+BENCHMARK(BM_SinCosBatch, BENCH_SIZE_MAX, BENCH_MODES_ALL);
+
+// Per-entity rotations from an axis & a heading
+static void BM_QuatGetRotationsD(BenchmarkState& rState)
+{
+	vec3fStream axes;
+	FillStream(axes, rState.GetBatchSize(), 1.0f, 25);
+	std::vector<float> angles;
+	FillAngles(angles, rState.GetBatchSize(), 360.0f, 26);
+	vec4fStream rotations;
+
+	while (rState.KeepRunning())
+	{
+		Quaternion::GetRotationsD(axes, angles.data(), rotations);
+	}
+}
+BENCHMARK(BM_QuatGetRotationsD, BENCH_SIZE_MAX, BENCH_MODES_ALL);
+
+//////////////////////////////////////////////////////////
+// quat
+//////////////////////////////////////////////////////////
+
+static void BM_QuatRotateVector(BenchmarkState& rState)
+{
+	std::vector<vec3f> vecs;
+	FillVector(vecs, rState.GetBatchSize(), 1.0f, 5);
+	Quaternion rotation = Quaternion::GetRotationD(vec3f(0.0f, 1.0f, 1.0f), 45.0f);
+
+	while (rState.KeepRunning())
+	{
+		for (size_t i = 0; i < rState.GetBatchSize(); i++)
+		{
+			DoNotOptimize(rotation.RotateVector(vecs[i]));
+		}
+	}
+}
+BENCHMARK(BM_QuatRotateVector, BENCH_SIZE_MAX, BENCH_MODES_SINGLE);
+
+// Baseline: builds the rotation (trig & Hamilton products) for every vector
+static void BM_QuatRotateVectorR(BenchmarkState& rState)
+{
+	std::vector<vec3f> vecs;
+	FillVector(vecs, rState.GetBatchSize(), 1.0f, 5);
+	vec3f axis(0.0f, 1.0f, 1.0f);
+	float angle_rad = DegreesToRadians(45.0f);
+
+	while (rState.KeepRunning())
+	{
+		for (size_t i = 0; i < rState.GetBatchSize(); i++)
+		{
+			DoNotOptimize(Quaternion::RotateVectorR(vecs[i], axis, angle_rad));
+		}
+	}
+}
+BENCHMARK(BM_QuatRotateVectorR, BENCH_SIZE_MAX, BENCH_MODES_SINGLE);
+
+static void BM_QuatRotateVectorsAoS(BenchmarkState& rState)
+{
+	std::vector<vec3f> vecs, result(rState.GetBatchSize());
+	FillVector(vecs, rState.GetBatchSize(), 1.0f, 6);
+	Quaternion rotation = Quaternion::GetRotationD(vec3f(0.0f, 1.0f, 1.0f), 45.0f);
+
+	while (rState.KeepRunning())
+	{
+		rotation.RotateVectors(vecs.data(), result.data(), vecs.size());
+	}
+}
+BENCHMARK(BM_QuatRotateVectorsAoS, BENCH_SIZE_MAX, BENCH_MODES_ALL);
+
+static void BM_QuatRotateVectorsSoA(BenchmarkState& rState)
+{
+	vec3fStream vecs, result;
+	FillStream(vecs, rState.GetBatchSize(), 1.0f, 7);
+	result.Resize(rState.GetBatchSize());
+	Quaternion rotation = Quaternion::GetRotationD(vec3f(0.0f, 1.0f, 1.0f), 45.0f);
+
+	while (rState.KeepRunning())
+	{
+		rotation.RotateVectors(vecs, result);
+	}
+}
+BENCHMARK(BM_QuatRotateVectorsSoA, BENCH_SIZE_MAX, BENCH_MODES_ALL);
+
+static void BM_QuatNlerpSoA(BenchmarkState& rState)
+{
+	uint32_t seed = 8;
+	size_t count = rState.GetBatchSize();
+	vec4fStream quats0(count), quats1(count), result(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		Quaternion q0 = Quaternion::GetRotationR(GetRandomVec3(seed, 1.0f), 3.0f * GetRandom(seed));
+		Quaternion q1 = Quaternion::GetRotationR(GetRandomVec3(seed, 1.0f), 3.0f * GetRandom(seed));
+		quats0.Set(i, vec4f(q0.i(), q0.j(), q0.k(), q0.w()));
+		quats1.Set(i, vec4f(q1.i(), q1.j(), q1.k(), q1.w()));
+	}
+
+	while (rState.KeepRunning())
+	{
+		Quaternion::Nlerp(quats0, quats1, 0.3f, result);
+	}
+}
+BENCHMARK(BM_QuatNlerpSoA, BENCH_SIZE_MAX, BENCH_MODES_ALL);
+
+//////////////////////////////////////////////////////////
+// Curves
+//////////////////////////////////////////////////////////
+
+static void BM_Bezier3DCubeGetPoint(BenchmarkState& rState)
+{
+	Bezier3DCube curve(vec3f(0.0f, 0.0f, 0.0f), vec3f(1.0f, 2.0f, 0.0f), vec3f(3.0f, -1.0f, 1.0f), vec3f(4.0f, 0.0f, 2.0f));
+	float t_step = 1.0f / (float)rState.GetBatchSize();
+
+	while (rState.KeepRunning())
+	{
+		for (size_t i = 0; i < rState.GetBatchSize(); i++)
+		{
+			DoNotOptimize(curve.GetPoint(t_step * i));
+		}
+	}
+}
+BENCHMARK(BM_Bezier3DCubeGetPoint, 100000, BENCH_MODES_SINGLE);
+
+static void BM_Bezier2DCubeStreamAtT(BenchmarkState& rState)
+{
+	uint32_t seed = 9;
+	size_t count = rState.GetBatchSize();
+	Bezier2DCubeStream curves(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		vec2f controls[4];
+		for (int k = 0; k < 4; k++)
+		{
+			float x = GetRandom(seed);
+			controls[k] = vec2f(x, GetRandom(seed));
+		}
+		curves.SetCurve(i, controls);
+	}
+	vec2fStream result(count);
+
+	while (rState.KeepRunning())
+	{
+		curves.GetPoints(0.4f, result);
+	}
+}
+BENCHMARK(BM_Bezier2DCubeStreamAtT, BENCH_SIZE_MAX, BENCH_MODES_ALL);
+
+static void BM_SplineCatmullRomUniform(BenchmarkState& rState)
+{
+	std::vector<vec3f> controls;
+	FillVector(controls, 64, 10.0f, 10);
+	Spline3D spline(SPLINE_CATMULL_ROM, controls.data(), controls.size());
+	std::vector<vec3f> result(rState.GetBatchSize());
+
+	while (rState.KeepRunning())
+	{
+		spline.GetPointsUniform(result.data(), result.size());
+	}
+}
+BENCHMARK(BM_SplineCatmullRomUniform, BENCH_SIZE_MAX, BENCH_MODE_BIT(BENCH_SCALAR) | BENCH_MODE_BIT(BENCH_THREADED));
+
+//////////////////////////////////////////////////////////
+// Intercept & visibility
+//////////////////////////////////////////////////////////
+
+static void BM_TargetIntercept(BenchmarkState& rState)
+{
+	std::vector<vec3f> pos_msl, pos_target, vel_target;
+	FillVector(pos_msl, rState.GetBatchSize(), 100.0f, 11);
+	FillVector(pos_target, rState.GetBatchSize(), 100.0f, 12);
+	FillVector(vel_target, rState.GetBatchSize(), 5.0f, 13);
+
+	while (rState.KeepRunning())
+	{
+		for (size_t i = 0; i < rState.GetBatchSize(); i++)
+		{
+			DoNotOptimize(GetTargetIntercept(pos_msl[i], 10.0f, pos_target[i], vel_target[i]));
+		}
+	}
+}
+BENCHMARK(BM_TargetIntercept, 100000, BENCH_MODES_SINGLE);
+
+static void BM_TargetIntercepts(BenchmarkState& rState)
+{
+	size_t count = rState.GetBatchSize();
+	vec3fStream pos_msl, pos_target, vel_target, dir_result(count);
+	FillStream(pos_msl, count, 100.0f, 11);
+	FillStream(pos_target, count, 100.0f, 12);
+	FillStream(vel_target, count, 5.0f, 13);
+	std::vector<float> speed_msl(count, 10.0f);
+	bool* p_can_intercept = new bool[count];
+
+	while (rState.KeepRunning())
+	{
+		GetTargetIntercepts(pos_msl, speed_msl.data(), pos_target, vel_target, dir_result, p_can_intercept);
+	}
+	delete[] p_can_intercept;
+}
+BENCHMARK(BM_TargetIntercepts, BENCH_SIZE_MAX, BENCH_MODES_ALL);
+
+static void BM_SolveInterceptTimes(BenchmarkState& rState)
+{
+	size_t count = rState.GetBatchSize();
+	vec3fStream pos1, vel1, pos2, vel2;
+	FillStream(pos1, count, 100.0f, 14);
+	FillStream(vel1, count, 5.0f, 15);
+	FillStream(pos2, count, 100.0f, 16);
+	FillStream(vel2, count, 5.0f, 17);
+	std::vector<float> times(count);
+	std::vector<InterceptStatus> status(count);
+
+	while (rState.KeepRunning())
+	{
+		SolveInterceptTimes(pos1, vel1, pos2, vel2, 2.0f, times.data(), status.data());
+	}
+}
+BENCHMARK(BM_SolveInterceptTimes, BENCH_SIZE_MAX, BENCH_MODES_ALL);
+
+// 16 sentries against batch / 16 targets (ops: sentry/target pairs)
+static void BM_Visibility2D(BenchmarkState& rState)
+{
+	const size_t num_sentries = 16;
+	size_t num_targets = (rState.GetBatchSize() + num_sentries - 1) / num_sentries;
+	uint32_t seed = 18;
+
+	vec2fStream pos_sentries(num_sentries), dir_sentries(num_sentries), pos_targets(num_targets);
+	std::vector<float> ranges(num_sentries, 50.0f), half_angles(num_sentries, 0.6f);
+	for (size_t s = 0; s < num_sentries; s++)
+	{
+		float x = GetRandom(seed);
+		pos_sentries.Set(s, vec2f(100.0f * x, 100.0f * GetRandom(seed)));
+		x = GetRandom(seed);
+		dir_sentries.Set(s, vec2f(x, GetRandom(seed)));
+	}
+	for (size_t t = 0; t < num_targets; t++)
+	{
+		float x = GetRandom(seed);
+		pos_targets.Set(t, vec2f(100.0f * x, 100.0f * GetRandom(seed)));
+	}
+	std::vector<uint32_t> visible(num_sentries * VISIBILITY_WORDS(num_targets));
+
+	rState.SetOpsPerIteration(num_sentries * num_targets);
+	while (rState.KeepRunning())
+	{
+		GetVisibility2D(pos_sentries, dir_sentries, ranges.data(), half_angles.data(), pos_targets, visible.data());
+	}
+}
+BENCHMARK(BM_Visibility2D, BENCH_SIZE_MAX, BENCH_MODES_ALL);
+
+static void BM_FrustumCullSpheres(BenchmarkState& rState)
+{
+	size_t count = rState.GetBatchSize();
+	vec3fStream centers;
+	FillStream(centers, count, 100.0f, 19);
+	std::vector<float> radii(count, 1.0f);
+	std::vector<uint32_t> visible(VISIBILITY_WORDS(count));
+
+	// 90 degree perspective looking down -z
+	const float n = 1.0f, f = 100.0f;
+	Frustum frustum
+	(
+		mat44
+		(
+			vec4f(1.0f, 0.0f, 0.0f, 0.0f),
+			vec4f(0.0f, 1.0f, 0.0f, 0.0f),
+			vec4f(0.0f, 0.0f, -(f + n) / (f - n), -2.0f * f * n / (f - n)),
+			vec4f(0.0f, 0.0f, -1.0f, 0.0f)
+		)
+	);
+
+	while (rState.KeepRunning())
+	{
+		frustum.CullSpheres(centers, radii.data(), visible.data());
+	}
+}
+BENCHMARK(BM_FrustumCullSpheres, BENCH_SIZE_MAX, BENCH_MODES_ALL);
+
+//////////////////////////////////////////////////////////
+// Geometry
+//////////////////////////////////////////////////////////
+
+static void BM_RaysTriangle(BenchmarkState& rState)
+{
+	size_t count = rState.GetBatchSize();
+	vec3fStream origins, dirs;
+	FillStream(origins, count, 10.0f, 20);
+	FillStream(dirs, count, 10.0f, 21);
+	std::vector<float> t_max(count, 1.0f), times(count);
+	std::vector<uint32_t> hits(RAY_HIT_WORDS(count));
+	Triangle tri(vec3f(-5.0f, -5.0f, 0.0f), vec3f(5.0f, -5.0f, 0.0f), vec3f(0.0f, 5.0f, 0.0f));
+
+	while (rState.KeepRunning())
+	{
+		IntersectRays(origins, dirs, t_max.data(), tri, hits.data(), times.data());
+	}
+}
+BENCHMARK(BM_RaysTriangle, BENCH_SIZE_MAX, BENCH_MODES_ALL);
+
+//////////////////////////////////////////////////////////
+// parallel
+//////////////////////////////////////////////////////////
+
+// Scheduling cost & scaling of ParallelFor() itself: a trivial body over the batch
+static void BM_ParallelForSum(BenchmarkState& rState)
+{
+	size_t count = rState.GetBatchSize();
+	std::vector<float> values(count, 1.0f);
+	std::vector<float> sums(count);
+
+	while (rState.KeepRunning())
+	{
+		ParallelFor(count, 1 << 14, [&](size_t begin, size_t end)
+		{
+			float sum = 0.0f;
+			for (size_t i = begin; i < end; i++)
+			{
+				sum += values[i];
+			}
+			sums[begin] = sum;
+		});
+		DoNotOptimize(sums[0]);
+	}
+}
+BENCHMARK(BM_ParallelForSum, BENCH_SIZE_MAX, BENCH_MODE_BIT(BENCH_SCALAR) | BENCH_MODE_BIT(BENCH_THREADED));
+
+//////////////////////////////////////////////////////////
+// hierarchy
+//////////////////////////////////////////////////////////
+
+// Forest of 64-node trees, each node parented to one of the previous few in its tree
+static void BuildHierarchy(TransformHierarchy& rHierarchy, size_t count)
+{
+	uint32_t seed = 22;
+	rHierarchy.Reserve(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		size_t tree_offset = i % 64;
+		int32_t parent = (tree_offset == 0 ? HIERARCHY_NO_PARENT : (int32_t)(i - 1 - (size_t)(4.0f * (GetRandom(seed) + 1.0f)) % tree_offset));
+		mat44 local = Quaternion::GetRotationD(GetRandomVec3(seed, 1.0f), 20.0f).GetRotationMatrix44();
+		local[0][3] = 1.0f;
+		rHierarchy.AddNode(parent, local);
+	}
+	rHierarchy.UpdateWorld();
+}
+
+// Every node moved
+static void BM_HierarchyUpdateAll(BenchmarkState& rState)
+{
+	TransformHierarchy hierarchy;
+	BuildHierarchy(hierarchy, rState.GetBatchSize());
+
+	while (rState.KeepRunning())
+	{
+		for (size_t i = 0; i < hierarchy.Size(); i += 64)
+		{
+			hierarchy.SetLocal((uint32_t)i, hierarchy.GetLocal((uint32_t)i));
+		}
+		hierarchy.UpdateWorld();
+	}
+}
+BENCHMARK(BM_HierarchyUpdateAll, 1000000, BENCH_MODE_BIT(BENCH_SCALAR) | BENCH_MODE_BIT(BENCH_THREADED));
+
+// Mostly static scene: one tree in 100 moved (ops: every node in the scene)
+static void BM_HierarchyUpdateFew(BenchmarkState& rState)
+{
+	TransformHierarchy hierarchy;
+	BuildHierarchy(hierarchy, rState.GetBatchSize());
+
+	while (rState.KeepRunning())
+	{
+		for (size_t i = 0; i < hierarchy.Size(); i += 6400)
+		{
+			hierarchy.SetLocal((uint32_t)i, hierarchy.GetLocal((uint32_t)i));
+		}
+		hierarchy.UpdateWorld();
+	}
+}
+BENCHMARK(BM_HierarchyUpdateFew, 1000000, BENCH_MODES_SINGLE);
+
+//////////////////////////////////////////////////////////
+// Camera
+//////////////////////////////////////////////////////////
+
+// Per-object shader constants from the cached view-projection
+static void BM_CameraModelViewProjs(BenchmarkState& rState)
+{
+	TransformHierarchy hierarchy;
+	BuildHierarchy(hierarchy, rState.GetBatchSize());
+	std::vector<mat44> mvps(hierarchy.Size());
+	Camera camera;
+	camera.SetLookAt(vec3f(0.0f, 10.0f, 30.0f), vec3f(0.0f, 0.0f, 0.0f), vec3f(0.0f, 1.0f, 0.0f));
+
+	while (rState.KeepRunning())
+	{
+		camera.GetModelViewProjs(hierarchy.GetWorlds(), mvps.data(), hierarchy.Size());
+	}
+}
+BENCHMARK(BM_CameraModelViewProjs, 1000000, BENCH_MODE_BIT(BENCH_SCALAR) | BENCH_MODE_BIT(BENCH_THREADED));
@@ -0,0 +1,380 @@
+#include "benchmark.h"
+#include "../src/simd.h"
+#include "../src/parallel.h"
+
+// Includes: Standard
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <vector>
+
+#if defined _MSC_VER && (defined _M_X64 || defined _M_IX86)
+#include <intrin.h>
+#define BENCH_HAS_TSC
+#elif (defined __GNUC__) && (defined __x86_64__ || defined __i386__)
+#include <x86intrin.h>
+#define BENCH_HAS_TSC
+#endif
+
+// Calibration: never run more iterations than this in one measurement
+#define BENCH_ITERATIONS_MAX	1000000000
+
+static uint64_t ReadCycleCounter()
+{
+#if defined BENCH_HAS_TSC
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+//////////////////////////////////////////////////////////
+// CLASS: BenchmarkState
+//////////////////////////////////////////////////////////
+
+BenchmarkState::BenchmarkState(size_t batchSize, BenchmarkMode mode, size_t iterations) :
+	m_batchSize(batchSize),
+	m_mode(mode),
+	m_iterations(iterations),
+	m_iterationsLeft(iterations),
+	m_opsPerIteration(batchSize),
+	m_bStarted(false),
+	m_cyclesStart(0),
+	m_elapsedNs(0.0),
+	m_elapsedCycles(0)
+{
+}
+
+bool BenchmarkState::KeepRunning()
+{
+	if (!m_bStarted)
+	{
+		m_bStarted = true;
+		m_timeStart = std::chrono::steady_clock::now();
+		m_cyclesStart = ReadCycleCounter();
+	}
+
+	if (m_iterationsLeft > 0)
+	{
+		m_iterationsLeft--;
+		return true;
+	}
+
+	m_elapsedCycles = ReadCycleCounter() - m_cyclesStart;
+	m_elapsedNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - m_timeStart).count();
+	return false;
+}
+
+#if !defined __GNUC__
+void BenchmarkEscape(const void* p)
+{
+	static const void* volatile s_pSink;
+	s_pSink = p;
+}
+#endif
+
+//////////////////////////////////////////////////////////
+// Registry
+//////////////////////////////////////////////////////////
+
+struct BenchmarkInfo
+{
+	const char* szName;
+	BenchmarkFn fnBenchmark;
+	size_t maxBatchSize;
+	unsigned modes;
+};
+
+// :NOTE: Function-local so registration from other files' static initializers is safe
+static std::vector<BenchmarkInfo>& GetBenchmarks()
+{
+	static std::vector<BenchmarkInfo> s_benchmarks;
+	return s_benchmarks;
+}
+
+int RegisterBenchmark(const char* szName, BenchmarkFn fnBenchmark, size_t maxBatchSize, unsigned modes)
+{
+	BenchmarkInfo info = { szName, fnBenchmark, maxBatchSize, modes };
+	GetBenchmarks().push_back(info);
+	return (int)GetBenchmarks().size();
+}
+
+//////////////////////////////////////////////////////////
+// Running
+//////////////////////////////////////////////////////////
+
+static const char* MODE_NAMES[BENCH_NUM_MODES] = { "scalar", "simd", "threaded" };
+static const char* SIMD_LEVEL_NAMES[] = { "scalar", "sse", "avx2", "avx512" };
+
+struct BenchmarkResult
+{
+	std::string name;
+	size_t batchSize;
+	BenchmarkMode mode;
+	size_t iterations;
+	double nsPerOp;
+	double opsPerSecond;
+	double cyclesPerOp;
+};
+
+struct BenchmarkOptions
+{
+	const char* szFilter;
+	double minTimeNs;
+	size_t maxBatchSize;
+	const char* szJsonPath;
+	const char* szComparePath;
+	double thresholdPercent;
+};
+
+static void SetMode(BenchmarkMode mode)
+{
+	SetSimdLevel(mode == BENCH_SCALAR ? SIMD_SCALAR : GetSimdLevelMax());
+	SetParallelThreadCount(mode == BENCH_THREADED ? 0 : 1);	// 0: hardware thread count
+}
+
+// Run with growing iteration counts until one run lasts at least the min time
+static BenchmarkResult RunBenchmark(const BenchmarkInfo& info, size_t batchSize, BenchmarkMode mode, double minTimeNs)
+{
+	SetMode(mode);
+
+	size_t iterations = 1;
+	for (;;)
+	{
+		BenchmarkState state(batchSize, mode, iterations);
+		info.fnBenchmark(state);
+
+		double elapsed_ns = state.GetElapsedNs();
+		if (elapsed_ns >= minTimeNs || iterations >= BENCH_ITERATIONS_MAX)
+		{
+			double num_ops = (double)state.GetOpsPerIteration() * (double)iterations;
+			BenchmarkResult result;
+			result.name = std::string(info.szName) + "/" + MODE_NAMES[mode] + "/" + std::to_string((unsigned long long)batchSize);
+			result.batchSize = batchSize;
+			result.mode = mode;
+			result.iterations = iterations;
+			result.nsPerOp = elapsed_ns / num_ops;
+			result.opsPerSecond = (elapsed_ns > 0.0 ? num_ops * 1.0e9 / elapsed_ns : 0.0);
+			result.cyclesPerOp = (double)state.GetElapsedCycles() / num_ops;
+			return result;
+		}
+
+		// Aim 40% past the min time, growing at most 10x per step (first runs are noisy)
+		double scale = (elapsed_ns > 0.0 ? 1.4 * minTimeNs / elapsed_ns : 10.0);
+		scale = (scale > 10.0 ? 10.0 : (scale < 1.5 ? 1.5 : scale));
+		double next = (double)iterations * scale;
+		iterations = (next > (double)BENCH_ITERATIONS_MAX ? (size_t)BENCH_ITERATIONS_MAX : (size_t)next);
+	}
+}
+
+static bool WriteJson(const char* szPath, const std::vector<BenchmarkResult>& results)
+{
+	FILE* p_file = fopen(szPath, "w");
+	if (p_file == NULL)
+	{
+		return false;
+	}
+
+	char date[64];
+	time_t now = time(NULL);
+	strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+	fprintf(p_file, "{\n");
+	fprintf(p_file, "  \"context\": {\"date\": \"%s\", \"simd_level_max\": \"%s\", \"num_threads\": %u, \"debug\": %s},\n",
+			date, SIMD_LEVEL_NAMES[GetSimdLevelMax()], GetParallelThreadCount(),
+#if defined _DEBUG
+			"true"
+#else
+			"false"
+#endif
+			);
+	fprintf(p_file, "  \"benchmarks\": [\n");
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const BenchmarkResult& result = results[i];
+		fprintf(p_file, "    {\"name\": \"%s\", \"mode\": \"%s\", \"batch_size\": %llu, \"iterations\": %llu, \"ns_per_op\": %.6g, \"ops_per_second\": %.6g, \"cycles_per_op\": %.6g}%s\n",
+				result.name.c_str(), MODE_NAMES[result.mode], (unsigned long long)result.batchSize, (unsigned long long)result.iterations,
+				result.nsPerOp, result.opsPerSecond, result.cyclesPerOp, (i + 1 < results.size() ? "," : ""));
+	}
+	fprintf(p_file, "  ]\n}\n");
+	fclose(p_file);
+	return true;
+}
+
+// Reads (name, ns_per_op) pairs back from a file written by WriteJson()
+// :NOTE: Not a general JSON parser; relies on one benchmark per line
+static bool ReadJson(const char* szPath, std::vector<std::pair<std::string, double> >& rResults)
+{
+	FILE* p_file = fopen(szPath, "r");
+	if (p_file == NULL)
+	{
+		return false;
+	}
+
+	char line[1024];
+	while (fgets(line, sizeof(line), p_file) != NULL)
+	{
+		const char* p_name = strstr(line, "\"name\": \"");
+		const char* p_ns = strstr(line, "\"ns_per_op\": ");
+		if (p_name == NULL || p_ns == NULL)
+		{
+			continue;
+		}
+		p_name += strlen("\"name\": \"");
+		const char* p_name_end = strchr(p_name, '"');
+		if (p_name_end == NULL)
+		{
+			continue;
+		}
+		rResults.push_back(std::make_pair(std::string(p_name, p_name_end), strtod(p_ns + strlen("\"ns_per_op\": "), NULL)));
+	}
+	fclose(p_file);
+	return true;
+}
+
+// Prints each benchmark's change against the baseline; returns the number slower than the threshold
+static int CompareResults(const char* szPath, const std::vector<BenchmarkResult>& results, double thresholdPercent)
+{
+	std::vector<std::pair<std::string, double> > baseline;
+	if (!ReadJson(szPath, baseline))
+	{
+		fprintf(stderr, "Can't read baseline '%s'\n", szPath);
+		return 0;
+	}
+
+	printf("\n%-48s %12s %12s %9s\n", "Comparison", "Base ns/op", "ns/op", "Change");
+	int num_regressions = 0;
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		for (size_t b = 0; b < baseline.size(); b++)
+		{
+			if (baseline[b].first != results[i].name || !(baseline[b].second > 0.0))
+			{
+				continue;
+			}
+
+			double change = 100.0 * (results[i].nsPerOp - baseline[b].second) / baseline[b].second;
+			bool b_regression = (change > thresholdPercent);
+			printf("%-48s %12.3f %12.3f %+8.1f%%%s\n", results[i].name.c_str(), baseline[b].second, results[i].nsPerOp, change, (b_regression ? "  REGRESSION" : ""));
+			num_regressions += (b_regression ? 1 : 0);
+			break;
+		}
+	}
+	return num_regressions;
+}
+
+static void PrintUsage()
+{
+	printf("Usage: Benchmark_3DGEP [options]\n");
+	printf("  --filter=TEXT        Only run benchmarks whose name contains TEXT\n");
+	printf("  --min-time=SECONDS   Minimum timed duration of each measurement (default 0.1)\n");
+	printf("  --max-size=N         Largest batch size (default %d)\n", BENCH_SIZE_MAX);
+	printf("  --json=PATH          Write the results as JSON\n");
+	printf("  --compare=PATH       Compare against a previous --json file\n");
+	printf("  --threshold=PERCENT  Slowdown that counts as a regression (default 10); exit code 1 if any\n");
+	printf("  --list               List the benchmarks\n");
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options = { "", 1.0e8, BENCH_SIZE_MAX, NULL, NULL, 10.0 };
+	bool b_list = false;
+	for (int i = 1; i < argc; i++)
+	{
+		const char* p_arg = argv[i];
+		if (strncmp(p_arg, "--filter=", 9) == 0)
+		{
+			options.szFilter = p_arg + 9;
+		}
+		else if (strncmp(p_arg, "--min-time=", 11) == 0)
+		{
+			options.minTimeNs = atof(p_arg + 11) * 1.0e9;
+		}
+		else if (strncmp(p_arg, "--max-size=", 11) == 0)
+		{
+			options.maxBatchSize = (size_t)strtoull(p_arg + 11, NULL, 10);
+		}
+		else if (strncmp(p_arg, "--json=", 7) == 0)
+		{
+			options.szJsonPath = p_arg + 7;
+		}
+		else if (strncmp(p_arg, "--compare=", 10) == 0)
+		{
+			options.szComparePath = p_arg + 10;
+		}
+		else if (strncmp(p_arg, "--threshold=", 12) == 0)
+		{
+			options.thresholdPercent = atof(p_arg + 12);
+		}
+		else if (strcmp(p_arg, "--list") == 0)
+		{
+			b_list = true;
+		}
+		else
+		{
+			PrintUsage();
+			return (strcmp(p_arg, "--help") == 0 ? 0 : 2);
+		}
+	}
+
+	const std::vector<BenchmarkInfo>& benchmarks = GetBenchmarks();
+	if (b_list)
+	{
+		for (size_t i = 0; i < benchmarks.size(); i++)
+		{
+			printf("%s\n", benchmarks[i].szName);
+		}
+		return 0;
+	}
+
+	printf("SIMD: %s, threads: %u, cycle counter: %s\n", SIMD_LEVEL_NAMES[GetSimdLevelMax()], GetParallelThreadCount(),
+#if defined BENCH_HAS_TSC
+		   "tsc"
+#else
+		   "none"
+#endif
+		   );
+	printf("%-48s %12s %14s %10s %12s\n", "Benchmark", "ns/op", "ops/s", "cycles/op", "iterations");
+
+	std::vector<BenchmarkResult> results;
+	for (size_t i = 0; i < benchmarks.size(); i++)
+	{
+		const BenchmarkInfo& info = benchmarks[i];
+		if (strstr(info.szName, options.szFilter) == NULL)
+		{
+			continue;
+		}
+
+		size_t max_batch_size = (info.maxBatchSize < options.maxBatchSize ? info.maxBatchSize : options.maxBatchSize);
+		for (size_t batch_size = 1; batch_size <= max_batch_size; batch_size *= 10)
+		{
+			for (int mode = 0; mode < BENCH_NUM_MODES; mode++)
+			{
+				if ((info.modes & BENCH_MODE_BIT(mode)) == 0)
+				{
+					continue;
+				}
+
+				BenchmarkResult result = RunBenchmark(info, batch_size, (BenchmarkMode)mode, options.minTimeNs);
+				printf("%-48s %12.3f %14.4g %10.2f %12llu\n", result.name.c_str(), result.nsPerOp, result.opsPerSecond, result.cyclesPerOp,
+					   (unsigned long long)result.iterations);
+				fflush(stdout);
+				results.push_back(result);
+			}
+		}
+	}
+	SetMode(BENCH_THREADED);
+
+	if (options.szJsonPath != NULL && !WriteJson(options.szJsonPath, results))
+	{
+		fprintf(stderr, "Can't write '%s'\n", options.szJsonPath);
+		return 2;
+	}
+	if (options.szComparePath != NULL && CompareResults(options.szComparePath, results, options.thresholdPercent) > 0)
+	{
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,143 @@
+#pragma once
+#ifndef __BENCHMARK_H__
+#define __BENCHMARK_H__
+
+/**
+ *	FILE: benchmark.h
+ *	Small benchmark harness in the style of Google Benchmark. Each registered
+ *	benchmark is run at batch sizes 1, 10, 100, ... up to its max size, in
+ *	each of its modes (scalar kernels, SIMD kernels, SIMD + threads), and is
+ *	repeated until it has run for a minimum time.
+ *
+ *	Reports ns/op, ops/s & cycles/op (x86 time stamp counter; 0 elsewhere),
+ *	& writes JSON (one benchmark per line) that --compare diffs against a
+ *	previous run. See PrintUsage() in benchmark.cpp for the options.
+ *
+ *	A benchmark sets up its data, then times a KeepRunning() loop:
+ *		static void BM_Foo(BenchmarkState& rState)
+ *		{
+ *			std::vector<float> data(rState.GetBatchSize());
+ *			while (rState.KeepRunning())
+ *			{
+ *				Foo(data.data(), data.size());
+ *			}
+ *		}
+ *		BENCHMARK(BM_Foo, BENCH_SIZE_MAX, BENCH_MODES_ALL);
+ */
+
+// Includes: Standard
+#include <stddef.h>
+#include <stdint.h>
+#include <chrono>
+
+// Largest batch size any benchmark runs at
+#define BENCH_SIZE_MAX		10000000
+
+enum BenchmarkMode
+{
+	BENCH_SCALAR = 0,	// Scalar kernels, 1 thread
+	BENCH_SIMD,			// Widest SIMD kernels, 1 thread
+	BENCH_THREADED,		// Widest SIMD kernels, all threads
+	BENCH_NUM_MODES,
+};
+
+#define BENCH_MODE_BIT(MODE)	(1u << (MODE))
+#define BENCH_MODES_ALL			((1u << BENCH_NUM_MODES) - 1)
+// Benchmarks of single-object (non-batch) functions: only the scalar mode means anything
+#define BENCH_MODES_SINGLE		BENCH_MODE_BIT(BENCH_SCALAR)
+
+/**
+ *	CLASS: BenchmarkState
+ *	Passed to each benchmark run; times the KeepRunning() loop.
+ */
+class BenchmarkState
+{
+protected:
+	size_t m_batchSize;
+	BenchmarkMode m_mode;
+	size_t m_iterations;
+	size_t m_iterationsLeft;
+	size_t m_opsPerIteration;
+	bool m_bStarted;
+
+	std::chrono::steady_clock::time_point m_timeStart;
+	uint64_t m_cyclesStart;
+	double m_elapsedNs;
+	uint64_t m_elapsedCycles;
+
+public:
+	BenchmarkState(size_t batchSize, BenchmarkMode mode, size_t iterations);
+
+	size_t GetBatchSize() const
+	{
+		return m_batchSize;
+	}
+
+	BenchmarkMode GetMode() const
+	{
+		return m_mode;
+	}
+
+	// Ops done by one loop iteration (defaults to the batch size)
+	void SetOpsPerIteration(size_t numOps)
+	{
+		m_opsPerIteration = numOps;
+	}
+
+	size_t GetOpsPerIteration() const
+	{
+		return m_opsPerIteration;
+	}
+
+	// True while more timed iterations are due; the first call starts the clock
+	bool KeepRunning();
+
+	size_t GetIterations() const
+	{
+		return m_iterations;
+	}
+
+	double GetElapsedNs() const
+	{
+		return m_elapsedNs;
+	}
+
+	uint64_t GetElapsedCycles() const
+	{
+		return m_elapsedCycles;
+	}
+};
+
+typedef void (*BenchmarkFn)(BenchmarkState& rState);
+
+/**
+ *	Register a benchmark (use BENCHMARK() at file scope)
+ *	@param	szName			Name (unique)
+ *	@param	fnBenchmark		Benchmark function
+ *	@param	maxBatchSize	Largest batch size to run it at
+ *	@param	modes			BENCH_MODE_BIT() flags of the modes to run it in
+ */
+int RegisterBenchmark(const char* szName, BenchmarkFn fnBenchmark, size_t maxBatchSize, unsigned modes);
+
+#define BENCHMARK(FN, MAX_BATCH_SIZE, MODES)	\
+	static int s_registered_##FN = RegisterBenchmark(#FN, FN, MAX_BATCH_SIZE, MODES);
+
+// Keep the compiler from dropping a result that is never read
+#if defined __GNUC__
+template <class T>
+inline void DoNotOptimize(const T& value)
+{
+	asm volatile("" : : "r,m"(value) : "memory");
+}
+#else
+// :NOTE: No inline asm on MSVC x64: hand the address to a function in another translation unit
+void BenchmarkEscape(const void* p);
+
+template <class T>
+inline void DoNotOptimize(const T& value)
+{
+	BenchmarkEscape(&value);
+}
+#endif
+
+#endif // #ifndef __BENCHMARK_H__
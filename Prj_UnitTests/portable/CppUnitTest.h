@@ -0,0 +1,167 @@
+#pragma once
+#ifndef __CPPUNITTEST_PORTABLE_H__
+#define __CPPUNITTEST_PORTABLE_H__
+
+/**
+ *	FILE: CppUnitTest.h (portable)
+ *	Stand-in for the subset of Visual Studio's CppUnitTestFramework the tests
+ *	use (TEST_CLASS, TEST_METHOD, Assert), so the same test files build into a
+ *	plain console runner (test_main.cpp) on any platform & run under CTest.
+ *	The CMake build puts this directory first on the test include path.
+ *
+ *	Needs C++17 (each TEST_METHOD registers itself through an inline static member).
+ */
+
+// Includes: Standard
+#include <stddef.h>
+#include <stdio.h>
+#include <math.h>
+#include <string>
+#include <vector>
+
+namespace Microsoft { namespace VisualStudio { namespace CppUnitTestFramework {
+
+typedef void (*TestFn)();
+
+struct TestInfo
+{
+	const char* szClass;
+	const char* szMethod;
+	TestFn fnRun;
+};
+
+// Every registered test method, in declaration order within each file
+inline std::vector<TestInfo>& GetTests()
+{
+	static std::vector<TestInfo> s_tests;
+	return s_tests;
+}
+
+struct TestRegistrar
+{
+	TestRegistrar(const char* szClass, const char* szMethod, TestFn fnRun)
+	{
+		TestInfo info = { szClass, szMethod, fnRun };
+		GetTests().push_back(info);
+	}
+};
+
+// Base of every TEST_CLASS (gives TEST_METHOD the class type & name)
+template <class T, class Name>
+class TestClassBase
+{
+protected:
+	typedef T TestClassType;
+
+	static const char* GetTestClassName()
+	{
+		return Name::Get();
+	}
+};
+
+// Thrown by a failed Assert; the runner reports it & moves on to the next test
+struct AssertFailure
+{
+	std::string message;
+};
+
+inline std::string ToString(bool b)					{ return (b ? "true" : "false"); }
+inline std::string ToString(int i)					{ return std::to_string(i); }
+inline std::string ToString(unsigned i)				{ return std::to_string(i); }
+inline std::string ToString(long i)					{ return std::to_string(i); }
+inline std::string ToString(unsigned long i)		{ return std::to_string(i); }
+inline std::string ToString(long long i)			{ return std::to_string(i); }
+inline std::string ToString(unsigned long long i)	{ return std::to_string(i); }
+inline std::string ToString(double d)
+{
+	char buffer[32];
+	snprintf(buffer, sizeof(buffer), "%.9g", d);
+	return buffer;
+}
+inline std::string ToString(float f)				{ return ToString((double)f); }
+template <class T>
+std::string ToString(const T&)
+{
+	return "<value>";
+}
+
+class Assert
+{
+protected:
+	static void Fail(const std::string& message, const wchar_t* szMessage)
+	{
+		AssertFailure failure;
+		failure.message = message;
+		if (szMessage != NULL)
+		{
+			failure.message += " - ";
+			for (const wchar_t* p = szMessage; *p != L'\0'; p++)
+			{
+				failure.message += (char)*p;
+			}
+		}
+		throw failure;
+	}
+
+public:
+	static void IsTrue(bool bCondition, const wchar_t* szMessage = NULL)
+	{
+		if (!bCondition)
+		{
+			Fail("IsTrue failed", szMessage);
+		}
+	}
+
+	static void IsFalse(bool bCondition, const wchar_t* szMessage = NULL)
+	{
+		if (bCondition)
+		{
+			Fail("IsFalse failed", szMessage);
+		}
+	}
+
+	template <class T>
+	static void AreEqual(const T& expected, const T& actual, const wchar_t* szMessage = NULL)
+	{
+		if (!(expected == actual))
+		{
+			Fail("AreEqual failed: expected " + ToString(expected) + ", got " + ToString(actual), szMessage);
+		}
+	}
+
+	static void AreEqual(float expected, float actual, float tolerance, const wchar_t* szMessage = NULL)
+	{
+		if (!(fabsf(expected - actual) <= tolerance))
+		{
+			Fail("AreEqual failed: expected " + ToString(expected) + ", got " + ToString(actual) +
+				 " (tolerance " + ToString(tolerance) + ")", szMessage);
+		}
+	}
+
+	static void AreEqual(double expected, double actual, double tolerance, const wchar_t* szMessage = NULL)
+	{
+		if (!(fabs(expected - actual) <= tolerance))
+		{
+			Fail("AreEqual failed: expected " + ToString(expected) + ", got " + ToString(actual) +
+				 " (tolerance " + ToString(tolerance) + ")", szMessage);
+		}
+	}
+};
+
+}}}	// namespace Microsoft::VisualStudio::CppUnitTestFramework
+
+#define TEST_CLASS(className)																	\
+	struct className##_Name { static const char* Get() { return #className; } };				\
+	class className : public ::Microsoft::VisualStudio::CppUnitTestFramework::TestClassBase<className, className##_Name>
+
+#define TEST_METHOD(methodName)																	\
+	static void Run_##methodName()																\
+	{																							\
+		TestClassType test;																		\
+		test.methodName();																		\
+	}																							\
+	static inline ::Microsoft::VisualStudio::CppUnitTestFramework::TestRegistrar s_register_##methodName{	\
+		GetTestClassName(), #methodName, &Run_##methodName };									\
+	void methodName()
+
+#endif // #ifndef __CPPUNITTEST_PORTABLE_H__
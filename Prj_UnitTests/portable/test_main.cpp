@@ -0,0 +1,70 @@
+/**
+ *	FILE: test_main.cpp (portable)
+ *	Console runner for the tests registered through the portable CppUnitTest.h.
+ *	Usage: 3dgep_tests [--list] [filter]
+ *	Runs every test whose "Class::Method" name contains filter; the exit code is
+ *	the number of failed tests.
+ */
+
+#include "CppUnitTest.h"
+
+// Includes: Standard
+#include <string.h>
+#include <exception>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+int main(int argc, char** argv)
+{
+	const char* sz_filter = NULL;
+	bool b_list = false;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--list") == 0)
+		{
+			b_list = true;
+		}
+		else
+		{
+			sz_filter = argv[i];
+		}
+	}
+
+	int num_run = 0, num_failed = 0;
+	for (const TestInfo& test : GetTests())
+	{
+		std::string name = std::string(test.szClass) + "::" + test.szMethod;
+		if (sz_filter != NULL && name.find(sz_filter) == std::string::npos)
+		{
+			continue;
+		}
+		if (b_list)
+		{
+			printf("%s\n", name.c_str());
+			continue;
+		}
+
+		num_run++;
+		try
+		{
+			test.fnRun();
+			printf("[ PASS ] %s\n", name.c_str());
+		}
+		catch (const AssertFailure& failure)
+		{
+			printf("[ FAIL ] %s: %s\n", name.c_str(), failure.message.c_str());
+			num_failed++;
+		}
+		catch (const std::exception& e)
+		{
+			printf("[ FAIL ] %s: exception: %s\n", name.c_str(), e.what());
+			num_failed++;
+		}
+	}
+
+	if (!b_list)
+	{
+		printf("%d tests, %d failed\n", num_run, num_failed);
+	}
+	return num_failed;
+}
@@ -5,7 +5,10 @@
 
 #pragma once
 
+// The portable build (UNITTEST_PORTABLE, see CMakeLists.txt) has no Windows SDK
+#if !defined UNITTEST_PORTABLE
 #include "targetver.h"
+#endif
 
 // Headers for CppUnitTest
 #include "CppUnitTest.h"
@@ -1,12 +1,157 @@
-#include "stdafx.h"
+﻿#include "stdafx.h"
 #include "CppUnitTest.h"
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <string.h>
+#include <stdint.h>
+
 #include "../src/math3d.h"
+#include "../src/vecstream.h"
+#include "../src/mat.h"
+#include "../src/quat.h"
+#include "../src/transform.h"
+#include "../src/curve.h"
+#include "../src/curvestream.h"
+#include "../src/spline.h"
+#include "../src/spatial.h"
+#include "../src/geometry.h"
+#include "../src/parallel.h"
+#include "../src/hierarchy.h"
+#include "../src/camera.h"
+#include "../src/trig.h"
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
 namespace UnitTest_3DGEP
 {		
+	/////////////////////////////////////////////
+	// Property & differential test helpers
+
+	// Deterministic pseudo-random inputs (xorshift32), so a failing property test fails the same way every run
+	class TestRandom
+	{
+	protected:
+		uint32_t m_state;
+
+	public:
+		explicit TestRandom(uint32_t seed) : m_state(seed != 0 ? seed : 1) {}
+
+		uint32_t Next()
+		{
+			m_state ^= m_state << 13;
+			m_state ^= m_state >> 17;
+			m_state ^= m_state << 5;
+			return m_state;
+		}
+
+		// Uniform in [fMin, fMax)
+		float Range(float fMin, float fMax)
+		{
+			return fMin + (fMax - fMin) * ((Next() >> 8) * (1.0f / 16777216.0f));
+		}
+
+		vec2f Vec2(float fMin, float fMax)
+		{
+			float x = Range(fMin, fMax);
+			return vec2f(x, Range(fMin, fMax));
+		}
+
+		vec3f Vec3(float fMin, float fMax)
+		{
+			float x = Range(fMin, fMax);
+			float y = Range(fMin, fMax);
+			return vec3f(x, y, Range(fMin, fMax));
+		}
+	};
+
+	// Distance between two floats in units in the last place (0: bit-identical; +0 & -0 are 0 apart)
+	static uint32_t GetUlpDistance(float a, float b)
+	{
+		int32_t bits_a, bits_b;
+		memcpy(&bits_a, &a, sizeof(a));
+		memcpy(&bits_b, &b, sizeof(b));
+
+		// Sign-magnitude -> two's complement, so adjacent floats are adjacent integers
+		bits_a = (bits_a < 0 ? INT32_MIN - bits_a : bits_a);
+		bits_b = (bits_b < 0 ? INT32_MIN - bits_b : bits_b);
+		int64_t diff = (int64_t)bits_a - (int64_t)bits_b;
+		return (uint32_t)(diff < 0 ? -diff : diff);
+	}
+
+	// Passes within maxUlps, or within fAbsTolerance for results near 0 (where ULPs are tiny); NaN matches NaN
+	static void AssertWithinUlps(float expected, float actual, uint32_t maxUlps, float fAbsTolerance = 0.0f)
+	{
+		if ((expected != expected) && (actual != actual))
+		{
+			return;
+		}
+		if (GetUlpDistance(expected, actual) > maxUlps && !(fabsf(expected - actual) <= fAbsTolerance))
+		{
+			Assert::AreEqual(expected, actual, fAbsTolerance);
+		}
+	}
+
+	// Outputs of one run of the kernels under test: floats (compared in ULPs) & bit masks (compared exactly)
+	struct KernelResults
+	{
+		std::vector<float> values;
+		std::vector<uint32_t> words;
+
+		void Add(const float* pValues, size_t count)
+		{
+			values.insert(values.end(), pValues, pValues + count);
+		}
+
+		void Add(const uint32_t* pWords, size_t count)
+		{
+			words.insert(words.end(), pWords, pWords + count);
+		}
+
+		template <unsigned numComps>
+		void Add(const vecfStream<numComps>& s)
+		{
+			for (unsigned c = 0; c < numComps; c++)
+			{
+				Add(s.Comp(c), s.Size());
+			}
+		}
+	};
+
+	/**
+	 *	Runs fnKernels(KernelResults&) at every SIMD level this CPU supports & checks each run
+	 *	against the scalar one. The batch kernels promise bit-identical results at every level,
+	 *	so maxUlps is 0 unless a kernel documents otherwise.
+	 */
+	template <class F>
+	static void AssertEveryLevelMatchesScalar(F fnKernels, uint32_t maxUlps = 0)
+	{
+		SimdLevel level = GetSimdLevel();
+		KernelResults results_scalar;
+		SetSimdLevel(SIMD_SCALAR);
+		fnKernels(results_scalar);
+
+		for (int lvl = SIMD_SCALAR + 1; lvl <= GetSimdLevelMax(); lvl++)
+		{
+			SetSimdLevel((SimdLevel)lvl);
+			KernelResults results;
+			fnKernels(results);
+
+			Assert::AreEqual(results_scalar.values.size(), results.values.size());
+			Assert::AreEqual(results_scalar.words.size(), results.words.size());
+			for (size_t i = 0; i < results.values.size(); i++)
+			{
+				AssertWithinUlps(results_scalar.values[i], results.values[i], maxUlps);
+			}
+			for (size_t i = 0; i < results.words.size(); i++)
+			{
+				Assert::AreEqual(results_scalar.words[i], results.words[i]);
+			}
+		}
+		SetSimdLevel(level);
+	}
+
 	TEST_CLASS(UnitTest1)
 	{
 	public:
@@ -23,4 +168,2042 @@ namespace UnitTest_3DGEP
 		}
 
 	};
-}
\ No newline at end of file
+
+	TEST_CLASS(VecStreamTests)
+	{
+	public:
+		// Stream results match the per-vector vec3f functions
+		TEST_METHOD(Stream3MatchesVec3f)
+		{
+			vec3f vecs1[5] = { vec3f(1, 2, 3), vec3f(-4, 5, 0.5f), vec3f(0, 0, 1), vec3f(7, -8, 9), vec3f(0.1f, 0.2f, 0.3f) };
+			vec3f vecs2[5] = { vec3f(3, 2, 1), vec3f(1, 1, 1), vec3f(2, 0, 0), vec3f(-1, -1, 2), vec3f(5, 4, 3) };
+			vec3fStream s1(vecs1, 5), s2(vecs2, 5), s_cross;
+			float dots[5];
+
+			vec3fStream::CrossProduct(s1, s2, s_cross);
+			vec3fStream::DotProduct(s1, s2, dots);
+			for (int i = 0; i < 5; i++)
+			{
+				vec3f cross = vec3f::CrossProduct(vecs1[i], vecs2[i]);
+				Assert::AreEqual(cross.x(), s_cross.Get(i).x());
+				Assert::AreEqual(cross.y(), s_cross.Get(i).y());
+				Assert::AreEqual(cross.z(), s_cross.Get(i).z());
+				Assert::AreEqual(vec3f::DotProduct(vecs1[i], vecs2[i]), dots[i]);
+			}
+		}
+
+		// SIMD & scalar paths are bit-identical (odd count exercises the scalar tail)
+		TEST_METHOD(Stream3ScalarMatchesSIMD)
+		{
+			const int count = 37;
+			vec3fStream s_in(count);
+			for (int i = 0; i < count; i++)
+			{
+				s_in.Set(i, vec3f(0.37f * i - 3.0f, 1.0f / (i + 1), (float)(i * i) - 11.5f));
+			}
+
+			vec3fStream s_simd = s_in, s_scalar = s_in;
+			float mag_simd[count], mag_scalar[count];
+
+			SimdLevel level = GetSimdLevel();
+			s_simd.Normalize();
+			s_in.Mag(mag_simd);
+			SetSimdLevel(SIMD_SCALAR);
+			s_scalar.Normalize();
+			s_in.Mag(mag_scalar);
+			SetSimdLevel(level);
+
+			for (int i = 0; i < count; i++)
+			{
+				Assert::AreEqual(mag_scalar[i], mag_simd[i]);
+				Assert::AreEqual(s_scalar.X()[i], s_simd.X()[i]);
+				Assert::AreEqual(s_scalar.Y()[i], s_simd.Y()[i]);
+				Assert::AreEqual(s_scalar.Z()[i], s_simd.Z()[i]);
+			}
+		}
+
+		// Every level this CPU runs (SSE, AVX2, AVX-512 copies) gives the scalar kernels' results
+		TEST_METHOD(EveryLevelMatchesScalar)
+		{
+			const int count = 45;
+			vec3fStream s_in(count), s_other(count);
+			for (int i = 0; i < count; i++)
+			{
+				s_in.Set(i, vec3f(0.37f * i - 3.0f, 1.0f / (i + 1), (float)(i * i) - 11.5f));
+				s_other.Set(i, vec3f(1.5f - 0.1f * i, (float)(i % 7), 0.25f * i));
+			}
+			Quaternion q_rot = Quaternion::GetRotationD(vec3f(1.0f, 2.0f, -0.5f), 37.0f);
+
+			SimdLevel level = GetSimdLevel();
+			vec3fStream norm_scalar, cross_scalar, rot_scalar;
+			float times_scalar[count];
+			InterceptStatus statuses[count];
+			for (int lvl = SIMD_SCALAR; lvl <= GetSimdLevelMax(); lvl++)
+			{
+				SetSimdLevel((SimdLevel)lvl);
+				vec3fStream s_norm = s_in, s_cross, s_rot;
+				s_norm.Normalize();
+				vec3fStream::CrossProduct(s_in, s_other, s_cross);
+				q_rot.RotateVectors(s_in, s_rot);
+				float times[count];
+				SolveInterceptTimes(s_in, s_other, s_other, s_in, 1.5f, times, statuses);
+
+				if (lvl == SIMD_SCALAR)
+				{
+					norm_scalar = s_norm;
+					cross_scalar = s_cross;
+					rot_scalar = s_rot;
+					std::copy(times, times + count, times_scalar);
+					continue;
+				}
+				for (int i = 0; i < count; i++)
+				{
+					for (int c = 0; c < 3; c++)
+					{
+						Assert::AreEqual(norm_scalar.Get(i)[c], s_norm.Get(i)[c]);
+						Assert::AreEqual(cross_scalar.Get(i)[c], s_cross.Get(i)[c]);
+						Assert::AreEqual(rot_scalar.Get(i)[c], s_rot.Get(i)[c]);
+					}
+					Assert::AreEqual(times_scalar[i], times[i]);
+				}
+			}
+			SetSimdLevel(level);
+		}
+	};
+
+	TEST_CLASS(TransformTests)
+	{
+	public:
+		// Bulk transforms match operator*(mat44, vec4f), for both AoS & SoA layouts
+		TEST_METHOD(TransformPointsMatchesMultiply)
+		{
+			mat44 mat = mat44::GetMatrixRotYD(30.0f) * mat44::GetMatrixScale(2.0f);
+			mat[0][3] = 5.0f;
+			mat[1][3] = -2.0f;
+			mat[2][3] = 0.5f;
+
+			const int count = 103;
+			vec3f points[count], result[count];
+			for (int i = 0; i < count; i++)
+			{
+				points[i] = vec3f(0.5f * i, 1.0f - i, 0.25f * i * i);
+			}
+			vec3fStream s_points(points, count), s_result;
+
+			mat.TransformPoints(points, result, count);
+			mat.TransformPoints(s_points, s_result);
+			for (int i = 0; i < count; i++)
+			{
+				vec4f expected = mat * vec4f(points[i].x(), points[i].y(), points[i].z(), 1.0f);
+				for (int c = 0; c < 3; c++)
+				{
+					Assert::AreEqual(expected[c], result[i][c]);
+					Assert::AreEqual(expected[c], s_result.Get(i)[c]);
+				}
+			}
+
+			// In place
+			mat.TransformDirections(points, points, count);
+			for (int i = 0; i < count; i++)
+			{
+				vec4f expected = mat * vec4f(s_points.Get(i).x(), s_points.Get(i).y(), s_points.Get(i).z(), 0.0f);
+				for (int c = 0; c < 3; c++)
+				{
+					Assert::AreEqual(expected[c], points[i][c], 1e-4f);
+				}
+			}
+		}
+
+		// Every index is visited exactly once regardless of chunking
+		TEST_METHOD(ParallelForCoversRange)
+		{
+			const size_t count = 1001;
+			int visits[count] = { 0 };
+			ParallelFor(count, 10, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					visits[i]++;
+				}
+			});
+			for (size_t i = 0; i < count; i++)
+			{
+				Assert::AreEqual(1, visits[i]);
+			}
+		}
+
+		// Uneven chunks, nested calls, calls from several threads at once & more threads than cores
+		TEST_METHOD(ParallelForStealsNestsAndShares)
+		{
+			const size_t count = 3000;
+			unsigned num_threads = GetParallelThreadCount();
+			SetParallelThreadCount(2 * num_threads + 3);
+
+			std::vector<std::atomic<int>> visits(count);
+			for (size_t i = 0; i < count; i++)
+			{
+				visits[i] = 0;
+			}
+			std::atomic<unsigned> total(0);
+			ParallelFor(count, 1, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; i++)
+				{
+					// Later indices cost far more, so early finishers have to steal
+					volatile unsigned work = 0;
+					for (size_t k = 0; k < i * 10; k++)
+					{
+						work = work + 1;
+					}
+					visits[i]++;
+				}
+				ParallelFor(end - begin, 1, [&](size_t nestedBegin, size_t nestedEnd)
+				{
+					total += (unsigned)(nestedEnd - nestedBegin);
+				});
+			});
+			for (size_t i = 0; i < count; i++)
+			{
+				Assert::AreEqual(1, visits[i].load());
+			}
+			Assert::AreEqual((unsigned)count, total.load());
+
+			// Independent callers share the pool
+			std::atomic<unsigned> sums[4];
+			std::vector<std::thread> callers;
+			for (unsigned c = 0; c < 4; c++)
+			{
+				sums[c] = 0;
+				callers.push_back(std::thread([&sums, c]()
+				{
+					for (int repeat = 0; repeat < 50; repeat++)
+					{
+						ParallelFor(1000 + c, 7, [&sums, c](size_t begin, size_t end)
+						{
+							sums[c] += (unsigned)(end - begin);
+						});
+					}
+				}));
+			}
+			for (size_t c = 0; c < callers.size(); c++)
+			{
+				callers[c].join();
+			}
+			for (unsigned c = 0; c < 4; c++)
+			{
+				Assert::AreEqual(50u * (1000 + c), sums[c].load());
+			}
+			SetParallelThreadCount(0);
+		}
+	};
+
+	TEST_CLASS(QuatTests)
+	{
+	public:
+		// Prepared-quaternion rotation matches the Hamilton product path; bulk matches single
+		TEST_METHOD(RotateVectorsMatchesRotateVector)
+		{
+			vec3f v_axis(1.0f, 2.0f, -0.5f);
+			Quaternion q_rot = Quaternion::GetRotationD(v_axis, 37.0f);
+
+			const int count = 301;
+			vec3f vecs[count], result[count];
+			for (int i = 0; i < count; i++)
+			{
+				vecs[i] = vec3f(0.5f * i, 1.0f - i, 0.01f * i * i);
+			}
+			vec3fStream s_vecs(vecs, count), s_result;
+
+			q_rot.RotateVectors(vecs, result, count);
+			q_rot.RotateVectors(s_vecs, s_result);
+			for (int i = 0; i < count; i++)
+			{
+				vec3f expected = q_rot.RotateVector(vecs[i]);
+				vec3f v_hamilton = Quaternion::RotateVectorD(vecs[i], v_axis, 37.0f);
+				for (int c = 0; c < 3; c++)
+				{
+					Assert::AreEqual(expected[c], result[i][c]);
+					Assert::AreEqual(expected[c], s_result.Get(i)[c]);
+					Assert::AreEqual(v_hamilton[c], expected[c], 1e-4f * (1.0f + fabsf(v_hamilton[c])));
+				}
+			}
+
+			// In place
+			q_rot.RotateVectors(vecs, vecs, count);
+			for (int i = 0; i < count; i++)
+			{
+				Assert::AreEqual(result[i][0], vecs[i][0]);
+				Assert::AreEqual(result[i][2], vecs[i][2]);
+			}
+		}
+
+		// Quaternion -> matrix -> quaternion, & the matrix rotates like the quaternion
+		TEST_METHOD(RotationMatrixRoundTrip)
+		{
+			const float angles[] = { 10.0f, 95.0f, 179.0f, 250.0f };
+			for (float angle : angles)
+			{
+				Quaternion q_rot = Quaternion::GetRotationD(vec3f(-0.3f, 1.0f, 0.6f), angle);
+				mat44 mat_rot = q_rot.GetRotationMatrix44();
+
+				vec3f v(1.5f, -2.0f, 0.25f);
+				vec3f v_quat = q_rot.RotateVector(v);
+				vec4f v_mat = mat_rot * vec4f(v.x(), v.y(), v.z(), 0.0f);
+
+				Quaternion q_back = Quaternion::GetRotationFromMatrix(mat_rot);
+				// q & -q are the same rotation
+				float sign = (q_back.w() * q_rot.w() + vec3f::DotProduct(q_back.GetImaginaryVector(), q_rot.GetImaginaryVector())) < 0.0f ? -1.0f : 1.0f;
+				Assert::AreEqual(q_rot.w(), sign * q_back.w(), 1e-5f);
+				for (int c = 0; c < 3; c++)
+				{
+					Assert::AreEqual(v_quat[c], v_mat[c], 1e-5f);
+					Assert::AreEqual(q_rot.GetImaginaryVector()[c], sign * q_back.GetImaginaryVector()[c], 1e-5f);
+				}
+			}
+		}
+
+		// Nlerp tracks Slerp; the batched Nlerp matches the single version exactly
+		TEST_METHOD(NlerpMatchesSlerp)
+		{
+			Quaternion q0 = Quaternion::GetRotationD(vec3f(0.0f, 0.0f, 1.0f), 0.0f);
+			Quaternion q1 = Quaternion::GetRotationD(vec3f(0.0f, 0.0f, 1.0f), 90.0f);
+			Quaternion q_half = Quaternion::Slerp(q0, q1, 0.5f);
+			Assert::AreEqual(Quaternion::GetRotationD(vec3f(0.0f, 0.0f, 1.0f), 45.0f).k(), q_half.k(), 1e-6f);
+
+			const int count = 77;
+			vec4fStream quats0(count), quats1(count), result;
+			for (int i = 0; i < count; i++)
+			{
+				Quaternion q_a = Quaternion::GetRotationD(vec3f(1.0f, 0.1f * i, -0.5f), 3.0f * i);
+				Quaternion q_b = Quaternion::GetRotationD(vec3f(-0.2f, 1.0f, 0.05f * i), 170.0f - 4.0f * i);
+				quats0.Set(i, vec4f(q_a.i(), q_a.j(), q_a.k(), q_a.w()));
+				quats1.Set(i, vec4f(q_b.i(), q_b.j(), q_b.k(), q_b.w()));
+			}
+
+			const float t = 0.3f;
+			Quaternion::Nlerp(quats0, quats1, t, result);
+			for (int i = 0; i < count; i++)
+			{
+				Quaternion q_a(quats0.Get(i)), q_b(quats1.Get(i));
+				Quaternion q_nlerp = Quaternion::Nlerp(q_a, q_b, t);
+				Quaternion q_slerp = Quaternion::Slerp(q_a, q_b, t);
+
+				vec4f v_batch = result.Get(i);
+				Assert::AreEqual(q_nlerp.i(), v_batch[0]);
+				Assert::AreEqual(q_nlerp.j(), v_batch[1]);
+				Assert::AreEqual(q_nlerp.k(), v_batch[2]);
+				Assert::AreEqual(q_nlerp.w(), v_batch[3]);
+
+				Assert::AreEqual(q_slerp.w(), q_nlerp.w(), 1e-3f);
+				Assert::AreEqual(q_slerp.i(), q_nlerp.i(), 1e-3f);
+			}
+		}
+
+		// Composed TRS transforms match the product of their matrices
+		TEST_METHOD(TransformComposeMatchesMatrix)
+		{
+			Transform tf_parent(vec3f(1.0f, 2.0f, 3.0f), Quaternion::GetRotationD(vec3f(0.0f, 1.0f, 0.0f), 40.0f), 2.0f);
+			Transform tf_child(vec3f(-4.0f, 0.5f, 0.0f), Quaternion::GetRotationD(vec3f(1.0f, 0.0f, 1.0f), -75.0f), 0.5f);
+
+			mat44 mat_expected = tf_parent.GetMatrix() * tf_child.GetMatrix();
+			Transform tf_composed = tf_parent * tf_child;
+			mat44 mat_composed = tf_composed.GetMatrix();
+
+			mat44 mat_identity = (tf_composed * tf_composed.GetInverse()).GetMatrix();
+			vec3f point(0.3f, -1.2f, 2.2f);
+			vec3f point_tf = tf_composed.TransformPoint(point);
+			vec4f point_mat = mat_expected * vec4f(point.x(), point.y(), point.z(), 1.0f);
+			for (int r = 0; r < 4; r++)
+			{
+				for (int c = 0; c < 4; c++)
+				{
+					Assert::AreEqual(mat_expected[r][c], mat_composed[r][c], 1e-5f);
+					Assert::AreEqual(MAT44_IDENTITY[r][c], mat_identity[r][c], 1e-5f);
+				}
+				if (r < 3)
+				{
+					Assert::AreEqual(point_mat[r], point_tf[r], 1e-5f);
+				}
+			}
+		}
+	};
+
+	TEST_CLASS(HierarchyTests)
+	{
+	public:
+		// World matrix by walking up to the root (same multiplication order as the sweep)
+		static mat44 GetWorldSlow(const TransformHierarchy& hierarchy, uint32_t idx)
+		{
+			int32_t parent = hierarchy.GetParent(idx);
+			if (parent == HIERARCHY_NO_PARENT)
+			{
+				return hierarchy.GetLocal(idx);
+			}
+			return GetWorldSlow(hierarchy, (uint32_t)parent) * hierarchy.GetLocal(idx);
+		}
+
+		static void AssertWorldsMatch(const TransformHierarchy& hierarchy)
+		{
+			for (uint32_t i = 0; i < hierarchy.Size(); i++)
+			{
+				mat44 expected = GetWorldSlow(hierarchy, i);
+				for (int r = 0; r < 4; r++)
+				{
+					for (int c = 0; c < 4; c++)
+					{
+						Assert::AreEqual(expected[r][c], hierarchy.GetWorld(i)[r][c]);
+					}
+				}
+			}
+		}
+
+		static Transform GetRandomTransform(TestRandom& rng)
+		{
+			return Transform(rng.Vec3(-2.0f, 2.0f), Quaternion::GetRotationD(rng.Vec3(-1.0f, 1.0f), rng.Range(-180.0f, 180.0f)), rng.Range(0.8f, 1.25f));
+		}
+
+		// Random forest (roots added midway, children attached to old trees): only dirty subtrees change
+		TEST_METHOD(DirtySubtreesMatchFullRecompute)
+		{
+			TestRandom rng(0x5CE4u);
+			TransformHierarchy hierarchy;
+			for (int i = 0; i < 400; i++)
+			{
+				int32_t parent = (i % 37 == 0 ? HIERARCHY_NO_PARENT : (int32_t)(rng.Next() % i));
+				hierarchy.AddNode(parent, GetRandomTransform(rng).GetMatrix());
+			}
+			Assert::IsTrue(hierarchy.IsDirty());
+			hierarchy.UpdateWorld();
+			Assert::IsFalse(hierarchy.IsDirty());
+			AssertWorldsMatch(hierarchy);
+
+			for (int frame = 0; frame < 10; frame++)
+			{
+				std::vector<mat44> worlds_before(hierarchy.GetWorlds(), hierarchy.GetWorlds() + hierarchy.Size());
+				uint32_t moved = rng.Next() % hierarchy.Size();
+				hierarchy.SetLocal(moved, GetRandomTransform(rng));
+				hierarchy.UpdateWorld();
+				AssertWorldsMatch(hierarchy);
+
+				// Nodes outside the moved subtree keep their matrices
+				for (uint32_t i = 0; i < hierarchy.Size(); i++)
+				{
+					bool b_in_subtree = false;
+					for (int32_t node = (int32_t)i; node != HIERARCHY_NO_PARENT; node = hierarchy.GetParent(node))
+					{
+						b_in_subtree = b_in_subtree || (node == (int32_t)moved);
+					}
+					if (!b_in_subtree)
+					{
+						Assert::IsTrue(memcmp(&worlds_before[i], &hierarchy.GetWorld(i), sizeof(mat44)) == 0);
+					}
+				}
+			}
+
+			// Nothing moved: nothing to do
+			hierarchy.UpdateWorld();
+			Assert::IsFalse(hierarchy.IsDirty());
+		}
+
+		// Many islands, large enough to run in parallel, give the single-threaded results
+		TEST_METHOD(ParallelMatchesSerial)
+		{
+			TestRandom rng(0x15A1u);
+			TransformHierarchy hierarchy;
+			const int num_nodes = 6 * HIERARCHY_PARALLEL_GRAIN;
+			for (int i = 0; i < num_nodes; i++)
+			{
+				int32_t parent = (i % 500 == 0 ? HIERARCHY_NO_PARENT : (int32_t)(i - 1 - rng.Next() % std::min(i % 500, 20)));
+				hierarchy.AddNode(parent, GetRandomTransform(rng).GetMatrix());
+			}
+
+			unsigned num_threads = GetParallelThreadCount();
+			SetParallelThreadCount(4);
+			hierarchy.UpdateWorld();
+			AssertWorldsMatch(hierarchy);
+
+			for (int i = 0; i < num_nodes; i += 97)
+			{
+				hierarchy.SetLocal(i, GetRandomTransform(rng));
+			}
+			hierarchy.UpdateWorld();
+			SetParallelThreadCount(num_threads);
+			AssertWorldsMatch(hierarchy);
+		}
+	};
+
+	TEST_CLASS(CameraTests)
+	{
+	public:
+		// Exposes the cache state
+		class TestCamera : public Camera
+		{
+		public:
+			bool IsCacheClean() const
+			{
+				return m_dirtyFlags == 0;
+			}
+		};
+
+		static void AssertIdentity(const mat44& mat, float fTolerance)
+		{
+			for (int r = 0; r < 4; r++)
+			{
+				for (int c = 0; c < 4; c++)
+				{
+					Assert::AreEqual(r == c ? 1.0f : 0.0f, mat[r][c], fTolerance);
+				}
+			}
+		}
+
+		static vec3f GetProjected(const mat44& mat, vec3f p)
+		{
+			vec4f clip = mat * vec4f(p.x(), p.y(), p.z(), 1.0f);
+			return vec3f(clip.x() / clip.w(), clip.y() / clip.w(), clip.z() / clip.w());
+		}
+
+		TEST_METHOD(BuildersFoldAtCompileTime)
+		{
+			constexpr mat44 mat_model = mat44::GetMatrixTranslation(1.0f, 2.0f, 3.0f) * mat44::GetMatrixScale(2.0f, 3.0f, 4.0f);
+			static_assert(mat_model[0][0] == 2.0f && mat_model[2][2] == 4.0f && mat_model[1][3] == 2.0f, "Translation & scale should be constexpr");
+
+			constexpr mat44 mat_view = mat44::GetMatrixView(vec3f(1, 0, 0), vec3f(0, 1, 0), vec3f(0, 0, 1), vec3f(0, 0, 5));
+			static_assert(mat_view[2][3] == -5.0f, "View should be constexpr");
+
+			constexpr mat44 mat_proj = mat44::GetMatrixPerspective(1.0f, 2.0f, 1.0f, 3.0f);
+			static_assert(mat_proj[0][0] == 0.5f && mat_proj[2][2] == -2.0f && mat_proj[2][3] == -3.0f && mat_proj[3][2] == -1.0f, "Perspective should be constexpr");
+
+			constexpr mat44 mat_ortho = mat44::GetMatrixOrtho(-2.0f, 2.0f, -1.0f, 1.0f, 1.0f, 3.0f, true);
+			static_assert(mat_ortho[0][0] == 0.5f && mat_ortho[2][2] == -0.5f && mat_ortho[2][3] == -0.5f, "Ortho should be constexpr");
+
+			constexpr mat44 mat_mvp = mat_proj * mat_view * mat_model;
+			Assert::AreEqual(-1.0f, mat_mvp[3][2] / 4.0f);
+		}
+
+		// Near & far planes land on the clip-space depth range, view edges on +-1
+		TEST_METHOD(ProjectionDepthRanges)
+		{
+			for (int z01 = 0; z01 < 2; z01++)
+			{
+				bool b_zero_to_one = (z01 != 0);
+				float near_ndc = (b_zero_to_one ? 0.0f : -1.0f);
+
+				mat44 mat_persp = mat44::GetMatrixPerspectiveD(90.0f, 2.0f, 0.5f, 50.0f, b_zero_to_one);
+				Assert::AreEqual(near_ndc, GetProjected(mat_persp, vec3f(0.0f, 0.0f, -0.5f)).z(), 1e-5f);
+				Assert::AreEqual(1.0f, GetProjected(mat_persp, vec3f(0.0f, 0.0f, -50.0f)).z(), 1e-5f);
+				vec3f corner = GetProjected(mat_persp, vec3f(-20.0f, 10.0f, -10.0f));
+				Assert::AreEqual(-1.0f, corner.x(), 1e-5f);
+				Assert::AreEqual(1.0f, corner.y(), 1e-5f);
+
+				mat44 mat_ortho = mat44::GetMatrixOrtho(-4.0f, 2.0f, -1.0f, 3.0f, 1.0f, 9.0f, b_zero_to_one);
+				Assert::AreEqual(near_ndc, GetProjected(mat_ortho, vec3f(0.0f, 0.0f, -1.0f)).z(), 1e-6f);
+				Assert::AreEqual(1.0f, GetProjected(mat_ortho, vec3f(0.0f, 0.0f, -9.0f)).z(), 1e-6f);
+				corner = GetProjected(mat_ortho, vec3f(-4.0f, 3.0f, -5.0f));
+				Assert::AreEqual(-1.0f, corner.x(), 1e-6f);
+				Assert::AreEqual(1.0f, corner.y(), 1e-6f);
+			}
+		}
+
+		// The eye maps to the origin, the target onto -z & every cached inverse undoes its matrix
+		TEST_METHOD(LookAtAndInverses)
+		{
+			vec3f eye(3.0f, 4.0f, -2.0f);
+			vec3f target(-1.0f, 0.5f, 6.0f);
+			Camera camera;
+			camera.SetLookAt(eye, target, vec3f(0.0f, 1.0f, 0.0f));
+			camera.SetPerspective(70.0f, 1.5f, 0.25f, 200.0f);
+
+			vec4f eye_view = camera.GetView() * vec4f(eye.x(), eye.y(), eye.z(), 1.0f);
+			vec4f target_view = camera.GetView() * vec4f(target.x(), target.y(), target.z(), 1.0f);
+			Assert::AreEqual(0.0f, eye_view.x(), 1e-5f);
+			Assert::AreEqual(0.0f, eye_view.z(), 1e-5f);
+			Assert::AreEqual(0.0f, target_view.x(), 1e-5f);
+			Assert::AreEqual(0.0f, target_view.y(), 1e-5f);
+			Assert::AreEqual(-(target - eye).Mag(), target_view.z(), 1e-5f);
+			Assert::IsTrue(camera.GetFrustum().ContainsPoint(target));
+			Assert::IsFalse(camera.GetFrustum().ContainsPoint(eye + (eye - target)));
+
+			AssertIdentity(camera.GetView() * camera.GetViewInverse(), 1e-5f);
+			AssertIdentity(camera.GetProj() * camera.GetProjInverse(), 1e-5f);
+			AssertIdentity(camera.GetViewProj() * camera.GetViewProjInverse(), 1e-4f);
+
+			camera.SetOrthographic(10.0f, 1.5f, 0.25f, 200.0f);
+			AssertIdentity(camera.GetProj() * camera.GetProjInverse(), 1e-5f);
+			AssertIdentity(camera.GetViewProj() * camera.GetViewProjInverse(), 1e-4f);
+		}
+
+		// Setting a value the camera already has keeps the cache; a real change rebuilds it
+		TEST_METHOD(CacheInvalidatesOnlyOnChange)
+		{
+			TestCamera camera;
+			Assert::IsFalse(camera.IsCacheClean());
+			camera.SetLookAt(vec3f(1.0f, 2.0f, 3.0f), vec3f(0.0f, 0.0f, 0.0f), vec3f(0.0f, 1.0f, 0.0f));
+			mat44 view_proj = camera.GetViewProj();
+			Assert::IsTrue(camera.IsCacheClean());
+
+			camera.SetPosition(vec3f(1.0f, 2.0f, 3.0f));
+			camera.SetPerspective(camera.GetFovYDegrees(), camera.GetAspect(), camera.GetNear(), camera.GetFar());
+			camera.SetAspect(camera.GetAspect());
+			camera.SetDepthZeroToOne(false);
+			Assert::IsTrue(camera.IsCacheClean());
+
+			camera.SetAspect(2.0f);
+			Assert::IsFalse(camera.IsCacheClean());
+			Assert::IsTrue(view_proj[0][0] != camera.GetViewProj()[0][0]);
+			Assert::IsTrue(camera.IsCacheClean());
+			camera.SetTarget(vec3f(0.0f, 0.0f, 1.0f));
+			Assert::IsFalse(camera.IsCacheClean());
+		}
+
+		// Bulk per-object constants (in place) match one at a time
+		TEST_METHOD(ModelViewProjsMatchSingle)
+		{
+			TestRandom rng(0xCA3Eu);
+			Camera camera;
+			camera.SetLookAt(vec3f(0.0f, 5.0f, 10.0f), vec3f(0.0f, 0.0f, 0.0f), vec3f(0.0f, 1.0f, 0.0f));
+
+			const size_t num_models = 1000;
+			std::vector<mat44> models(num_models);
+			for (size_t i = 0; i < num_models; i++)
+			{
+				models[i] = Transform(rng.Vec3(-5.0f, 5.0f), Quaternion::GetRotationD(rng.Vec3(-1.0f, 1.0f), rng.Range(-180.0f, 180.0f)), rng.Range(0.5f, 2.0f)).GetMatrix();
+			}
+			std::vector<mat44> expected(num_models);
+			for (size_t i = 0; i < num_models; i++)
+			{
+				expected[i] = camera.GetModelViewProj(models[i]);
+			}
+
+			camera.GetModelViewProjs(models.data(), models.data(), num_models);
+			Assert::IsTrue(memcmp(expected.data(), models.data(), num_models * sizeof(mat44)) == 0);
+		}
+	};
+
+	TEST_CLASS(TrigTests)
+	{
+	public:
+		// Largest |error| of sin & cos against libm in double
+		static double GetSinCosError(float fSin, float fCos, double radians)
+		{
+			double err_sin = fabs(fSin - sin(radians));
+			double err_cos = fabs(fCos - cos(radians));
+			return (err_sin > err_cos ? err_sin : err_cos);
+		}
+
+		// Every 997th float (both signs) up to the range limits stays within the documented bounds
+		TEST_METHOD(ErrorWithinDocumentedBounds)
+		{
+			double max_err = 0.0, max_err_degrees = 0.0, max_err_table = 0.0;
+			uint32_t bits_max;
+			float radians_max = TRIG_RADIANS_MAX;
+			memcpy(&bits_max, &radians_max, sizeof(bits_max));
+			for (uint32_t bits = 0; bits <= bits_max; bits += 997)
+			{
+				float x;
+				memcpy(&x, &bits, sizeof(x));
+				for (int sign = 0; sign < 2; sign++, x = -x)
+				{
+					float s, c;
+					SinCos(x, s, c);
+					max_err = std::max(max_err, GetSinCosError(s, c, x));
+
+					double radians = fmod((double)x, 360.0) * (M_PI / 180.0);
+					SinCosD(x, s, c);
+					max_err_degrees = std::max(max_err_degrees, GetSinCosError(s, c, radians));
+					SinCosTableD(x, s, c);
+					max_err_table = std::max(max_err_table, GetSinCosError(s, c, radians));
+				}
+			}
+			Assert::IsTrue(max_err <= TRIG_MAX_ERROR);
+			Assert::IsTrue(max_err_degrees <= TRIG_MAX_ERROR);
+			Assert::IsTrue(max_err_table <= TRIG_TABLE_MAX_ERROR);
+		}
+
+		// Multiples of 90 degrees are exact; the table is exact (to 1 ulp) on whole degrees
+		TEST_METHOD(DegreesReduceExactly)
+		{
+			const float expected[4][2] = { { 0.0f, 1.0f }, { 1.0f, 0.0f }, { 0.0f, -1.0f }, { -1.0f, 0.0f } };
+			for (int turn = -8; turn <= 8; turn++)
+			{
+				float s, c, s_table, c_table;
+				SinCosD(90.0f * turn, s, c);
+				SinCosTableD(90.0f * turn, s_table, c_table);
+				int quadrant = ((turn % 4) + 4) % 4;
+				Assert::AreEqual(expected[quadrant][0], fabsf(s) == 0.0f ? 0.0f : s);
+				Assert::AreEqual(expected[quadrant][1], fabsf(c) == 0.0f ? 0.0f : c);
+				Assert::AreEqual(s, s_table);
+				Assert::AreEqual(c, c_table);
+			}
+
+			for (int degrees = -720; degrees <= 720; degrees++)
+			{
+				float s, c;
+				SinCosTableD((float)degrees, s, c);
+				double radians = (degrees % 360) * (M_PI / 180.0);
+				AssertWithinUlps((float)sin(radians), s, 1, 1e-8f);
+				AssertWithinUlps((float)cos(radians), c, 1, 1e-8f);
+			}
+		}
+
+		// Out of range inputs & the batched versions agree with the single versions exactly
+		TEST_METHOD(BatchMatchesSingle)
+		{
+			TestRandom rng(0x7216u);
+			const size_t count = 1003;
+			std::vector<float> angles(count), sins(count), coss(count);
+			for (size_t i = 0; i < count; i++)
+			{
+				angles[i] = (i % 101 == 7 ? rng.Range(-1.0e7f, 1.0e7f) : rng.Range(-1000.0f, 1000.0f));
+			}
+
+			float s, c;
+			SinCos(1.0e6f, s, c);
+			Assert::AreEqual((float)sin(1.0e6), s);
+			Assert::AreEqual((float)cos(1.0e6), c);
+
+			SinCos(angles.data(), sins.data(), coss.data(), count);
+			for (size_t i = 0; i < count; i++)
+			{
+				SinCos(angles[i], s, c);
+				Assert::IsTrue(s == sins[i] && c == coss[i]);
+			}
+			SinCosD(angles.data(), sins.data(), coss.data(), count);
+			for (size_t i = 0; i < count; i++)
+			{
+				SinCosD(angles[i], s, c);
+				Assert::IsTrue(s == sins[i] && c == coss[i]);
+			}
+
+			// In place
+			std::vector<float> angles_in_place(angles);
+			SinCosD(angles_in_place.data(), sins.data(), angles_in_place.data(), count);
+			Assert::IsTrue(memcmp(angles_in_place.data(), coss.data(), count * sizeof(float)) == 0);
+		}
+
+		// Degree-based rotation builders land exactly on quarter turns
+		TEST_METHOD(RotationBuildersExactQuarterTurns)
+		{
+			mat44 mat_rot = mat44::GetMatrixRotZD(90.0f);
+			vec4f v_rot = mat_rot * vec4f(1.0f, 0.0f, 0.0f, 1.0f);
+			Assert::AreEqual(0.0f, v_rot.x());
+			Assert::AreEqual(1.0f, v_rot.y());
+			mat_rot = mat44::GetMatrixRotXD(-180.0f);
+			Assert::AreEqual(-1.0f, mat_rot[1][1]);
+			Assert::AreEqual(0.0f, fabsf(mat_rot[1][2]));
+
+			Quaternion q_half = Quaternion::GetRotationD(vec3f(0.0f, 2.0f, 0.0f), 180.0f);
+			Assert::AreEqual(0.0f, q_half.w());
+			Assert::AreEqual(1.0f, q_half.j());
+		}
+
+		TEST_METHOD(GetRotationsMatchesSingle)
+		{
+			TestRandom rng(0x9077u);
+			const size_t count = 517;
+			vec3fStream axes(count);
+			std::vector<float> angles(count);
+			for (size_t i = 0; i < count; i++)
+			{
+				axes.Set(i, rng.Vec3(-3.0f, 3.0f));
+				angles[i] = rng.Range(-720.0f, 720.0f);
+			}
+
+			vec4fStream rotations;
+			Quaternion::GetRotationsD(axes, angles.data(), rotations);
+			Assert::AreEqual(count, rotations.Size());
+			for (size_t i = 0; i < count; i++)
+			{
+				Quaternion q = Quaternion::GetRotationD(axes.Get(i), angles[i]);
+				Assert::IsTrue(q.i() == rotations.X()[i] && q.j() == rotations.Y()[i] && q.k() == rotations.Z()[i] && q.w() == rotations.W()[i]);
+			}
+		}
+	};
+
+	TEST_CLASS(CurveTests)
+	{
+	public:
+		// Distance from a point to the closest segment of a polyline
+		static float GetPolylineDistance(const std::vector<vec2f>& points, vec2f p)
+		{
+			float dist_min = 1.0e30f;
+			for (size_t i = 0; i + 1 < points.size(); i++)
+			{
+				vec2f seg = points[i + 1] - points[i];
+				float seg_len_sq = vec2f::DotProduct(seg, seg);
+				float t = (seg_len_sq > 0.0f ? vec2f::DotProduct(p - points[i], seg) / seg_len_sq : 0.0f);
+				t = (t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t));
+				float dist = (p - (points[i] + (t * seg))).Mag();
+				dist_min = (dist < dist_min ? dist : dist_min);
+			}
+			return dist_min;
+		}
+
+		TEST_METHOD(CubicGetPointMatchesDeCasteljau)
+		{
+			vec2f p1(0, 0), p2(100, 300), p3(400, -200), p4(500, 100);
+			Bezier2DCube bc(p1, p2, p3, p4);
+
+			// t = 0.5: (p1 + 3p2 + 3p3 + p4) / 8
+			vec2f expected = 0.125f * (((p1 + (3.0f * p2)) + (3.0f * p3)) + p4);
+			vec2f point = bc.GetPoint(0.5f);
+			Assert::AreEqual(expected.x, point.x, 1e-3f);
+			Assert::AreEqual(expected.y, point.y, 1e-3f);
+		}
+
+		// Batched curves match the single-curve evaluation (shared t & many t)
+		TEST_METHOD(CurveStreamMatchesGetPoint)
+		{
+			const int count = 45;
+			Bezier2DCubeStream curves(count);
+			for (int i = 0; i < count; i++)
+			{
+				const vec2f controls[4] = { vec2f(0.5f * i, 0), vec2f(10, 3.0f * i), vec2f(-2.0f * i, 7), vec2f(20, 20) };
+				curves.SetCurve(i, controls);
+			}
+
+			vec2fStream points;
+			curves.GetPoints(0.35f, points);
+			for (int i = 0; i < count; i++)
+			{
+				vec2f controls[4];
+				curves.GetCurve(i, controls);
+				Bezier2DCube curve(controls[0], controls[1], controls[2], controls[3]);
+
+				vec2f expected = curve.GetPoint(0.35f);
+				Assert::AreEqual(curves.GetPoint(i, 0.35f).x, points.Get(i).x);
+				Assert::AreEqual(curves.GetPoint(i, 0.35f).y, points.Get(i).y);
+				Assert::AreEqual(expected.x, points.Get(i).x, 1e-4f);
+				Assert::AreEqual(expected.y, points.Get(i).y, 1e-4f);
+			}
+
+			float t_vals[count];
+			for (int j = 0; j < count; j++)
+			{
+				t_vals[j] = j / (float)(count - 1);
+			}
+			curves.GetPoints(7, t_vals, count, points);
+			for (int j = 0; j < count; j++)
+			{
+				vec2f expected = curves.GetPoint(7, t_vals[j]);
+				Assert::AreEqual(expected.x, points.Get(j).x, 1e-4f);
+				Assert::AreEqual(expected.y, points.Get(j).y, 1e-4f);
+			}
+		}
+
+		// Arc-length lookup gives constant speed, even when t doesn't
+		TEST_METHOD(ArcLengthParameterization)
+		{
+			// Straight line with bunched-up control points: t is far from uniform in distance
+			Bezier3DCube line(vec3f(0, 0, 0), vec3f(0.5f, 0, 0), vec3f(1, 0, 0), vec3f(10, 0, 0));
+			Assert::AreEqual(10.0f, line.GetLength(), 1e-3f);
+			for (int i = 0; i <= 20; i++)
+			{
+				float distance = 0.5f * i;
+				Assert::AreEqual(distance, line.GetPointAtDistance(distance).x(), 2e-2f);
+			}
+
+			// Curved: length matches a dense polyline
+			Bezier3DQuad arc(vec3f(0, 0, 0), vec3f(5, 5, 2), vec3f(10, 0, -1));
+			float length_polyline = 0.0f;
+			for (int i = 0; i < 10000; i++)
+			{
+				length_polyline += (arc.GetPoint((i + 1) / 10000.0f) - arc.GetPoint(i / 10000.0f)).Mag();
+			}
+			Assert::AreEqual(length_polyline, arc.GetLength(), 1e-3f);
+			Assert::AreEqual(0.0f, arc.GetParamAtDistance(-1.0f));
+			Assert::AreEqual(1.0f, arc.GetParamAtDistance(100.0f));
+		}
+
+		// Catmull-Rom interpolates its controls; composite Bezier matches the single curves
+		TEST_METHOD(SplineSegments)
+		{
+			const int num_controls = 10;
+			vec3f controls[num_controls];
+			for (int i = 0; i < num_controls; i++)
+			{
+				controls[i] = vec3f((float)i, (float)((i * 7) % 5), 0.5f * i);
+			}
+
+			Spline3D spline_cr(SPLINE_CATMULL_ROM, controls, num_controls);
+			Assert::AreEqual((size_t)7, spline_cr.GetNumSegments());
+			for (int i = 0; i <= 7; i++)
+			{
+				vec3f point = spline_cr.GetPoint(i / 7.0f);
+				for (int c = 0; c < 3; c++)
+				{
+					Assert::AreEqual(controls[i + 1][c], point[c], 1e-4f);
+				}
+			}
+
+			// Non-uniform knots: same shape, different timing (binary search lookup)
+			const float knots[4] = { 0.0f, 1.0f, 5.0f, 6.0f };
+			Spline3D spline_bez(SPLINE_BEZIER_CUBE, controls, num_controls, knots);
+			Assert::AreEqual((size_t)3, spline_bez.GetNumSegments());
+			Bezier3DCube curve_mid(controls[3], controls[4], controls[5], controls[6]);
+			vec3f point_spline = spline_bez.GetPoint(2.0f);
+			vec3f point_curve = curve_mid.GetPoint(0.25f);
+			for (int c = 0; c < 3; c++)
+			{
+				Assert::AreEqual(point_curve[c], point_spline[c], 1e-4f);
+			}
+
+			// Bulk uniform sampling matches single lookups
+			const int count = 101;
+			vec3f points[count];
+			spline_bez.GetPointsUniform(points, count);
+			for (int i = 0; i < count; i++)
+			{
+				vec3f expected = spline_bez.GetPoint(6.0f * i / (count - 1));
+				for (int c = 0; c < 3; c++)
+				{
+					Assert::AreEqual(expected[c], points[i][c], 1e-4f);
+				}
+			}
+		}
+
+		// Flattened polylines stay within tolerance & end exactly on the end points
+		TEST_METHOD(FlattenWithinTolerance)
+		{
+			Bezier2DQuad bq(vec2f(100, 500), vec2f(600, 200), vec2f(1000, 400));
+			Bezier2DCube bc(vec2f(0, 0), vec2f(900, 20), vec2f(-300, 40), vec2f(600, 600));
+
+			BezierCurve2D* curves[2] = { &bq, &bc };
+			const float tolerance = 0.25f;
+			for (BezierCurve2D* p_curve : curves)
+			{
+				std::vector<vec2f> points;
+				p_curve->Flatten(tolerance, points);
+
+				Assert::IsTrue(points.size() >= 2 && points.size() < 200);
+				Assert::AreEqual(p_curve->GetPoint(0.0f).x, points.front().x);
+				Assert::AreEqual(p_curve->GetPoint(1.0f).y, points.back().y, 1e-3f);
+
+				for (int i = 0; i <= 1000; i++)
+				{
+					Assert::IsTrue(GetPolylineDistance(points, p_curve->GetPoint(i / 1000.0f)) <= tolerance * 1.05f);
+				}
+			}
+		}
+	};
+
+	TEST_CLASS(InterceptTests)
+	{
+	public:
+		// Batch intercept directions match GetTargetIntercept(), including unreachable targets
+		TEST_METHOD(BatchMatchesSingle)
+		{
+			const int count = 203;
+			vec3fStream pos_msl(count), pos_target(count), vel_target(count), dir_result;
+			float speed_msl[count];
+			bool can_intercept[count];
+			for (int i = 0; i < count; i++)
+			{
+				pos_msl.Set(i, vec3f(0.1f * i, -2.0f, 1.0f));
+				pos_target.Set(i, vec3f(50.0f, 0.3f * i, -10.0f + 0.2f * i));
+				vel_target.Set(i, vec3f(-1.0f + 0.05f * i, 3.0f, 0.5f));
+				speed_msl[i] = 0.05f * (i % 100);	// Slow missiles can't intercept
+			}
+
+			GetTargetIntercepts(pos_msl, speed_msl, pos_target, vel_target, dir_result, can_intercept);
+			int num_intercepts = 0;
+			for (int i = 0; i < count; i++)
+			{
+				vec3f expected = GetTargetIntercept(pos_msl.Get(i), speed_msl[i], pos_target.Get(i), vel_target.Get(i));
+				for (int c = 0; c < 3; c++)
+				{
+					Assert::AreEqual(expected[c], dir_result.Get(i)[c], 1e-4f);
+				}
+
+				vec3f vel = vel_target.Get(i);
+				if (can_intercept[i])
+				{
+					num_intercepts++;
+				}
+				else
+				{
+					vec3f heading = (1.0f / vel.Mag()) * vel;
+					Assert::AreEqual(heading.x(), dir_result.Get(i).x(), 1e-5f);
+				}
+			}
+			Assert::IsTrue(num_intercepts > 0 && num_intercepts < count);
+		}
+
+		// Quadratic intercept time: each degenerate case gets a finite time & explicit status
+		TEST_METHOD(InterceptTimeCases)
+		{
+			float time = -1.0f;
+			// Head-on: 10 apart, closing at 4/s, radius 2 => contact at t = 2
+			Assert::AreEqual((int)INTERCEPT_OK, (int)SolveInterceptTime(vec3f(0, 0, 0), vec3f(1, 0, 0), vec3f(10, 0, 0), vec3f(-3, 0, 0), 2.0f, &time));
+			Assert::AreEqual(2.0f, time, 1e-5f);
+
+			// Already in contact, coincident & not moving
+			Assert::AreEqual((int)INTERCEPT_OK, (int)SolveInterceptTime(vec3f(0, 0, 0), vec3f(0, 0, 0), vec3f(0, 0, 0), vec3f(0, 0, 0), 0.0f, &time));
+			Assert::AreEqual(0.0f, time);
+
+			// Same velocity (parallel), apart
+			Assert::AreEqual((int)INTERCEPT_NO_RELATIVE_MOTION, (int)SolveInterceptTime(vec3f(0, 0, 0), vec3f(1, 1, 0), vec3f(5, 0, 0), vec3f(1, 1, 0), 1.0f, &time));
+			Assert::AreEqual(0.0f, time);
+
+			// Moving apart
+			Assert::AreEqual((int)INTERCEPT_DIVERGING, (int)SolveInterceptTime(vec3f(0, 0, 0), vec3f(-1, 0, 0), vec3f(5, 0, 0), vec3f(1, 0, 0), 1.0f, &time));
+			Assert::AreEqual(0.0f, time);
+
+			// Passing 3 apart with radius 1: closest approach at t = 5
+			Assert::AreEqual((int)INTERCEPT_MISS, (int)SolveInterceptTime(vec3f(0, 0, 0), vec3f(0, 0, 0), vec3f(-10, 3, 0), vec3f(2, 0, 0), 1.0f, &time));
+			Assert::AreEqual(5.0f, time, 1e-5f);
+		}
+
+		// Batch solver matches the single version exactly
+		TEST_METHOD(InterceptTimeBatch)
+		{
+			const int count = 150;
+			vec3fStream pos1(count), vel1(count), pos2(count), vel2(count);
+			for (int i = 0; i < count; i++)
+			{
+				pos1.Set(i, vec3f(0.0f, 0.1f * i, 0.0f));
+				vel1.Set(i, vec3f(1.0f, (i % 3) - 1.0f, 0.0f));
+				pos2.Set(i, vec3f(20.0f - 0.2f * i, 0.0f, (i % 5) * 1.0f));
+				vel2.Set(i, (i % 7 == 0) ? vec3f(1.0f, (i % 3) - 1.0f, 0.0f) : vec3f(-1.0f, 0.5f, -0.1f * (i % 4)));
+			}
+
+			float times[count];
+			InterceptStatus statuses[count];
+			SolveInterceptTimes(pos1, vel1, pos2, vel2, 1.5f, times, statuses);
+			for (int i = 0; i < count; i++)
+			{
+				float time;
+				InterceptStatus status = SolveInterceptTime(pos1.Get(i), vel1.Get(i), pos2.Get(i), vel2.Get(i), 1.5f, &time);
+				Assert::AreEqual((int)status, (int)statuses[i]);
+				Assert::AreEqual(time, times[i]);
+				Assert::IsTrue(time >= 0.0f && time < 1.0e30f);
+			}
+		}
+	};
+
+	TEST_CLASS(VisibilityTests)
+	{
+	public:
+		// Batch visibility bits match IsWithinRange2D() for narrow, wide & all-round sentries
+		TEST_METHOD(BatchMatchesSingle)
+		{
+			const int num_sentries = 9;
+			const int num_targets = 75;	// Not a multiple of the lane width or of 32
+			const float half_angles[num_sentries] = { 0.3f, (float)M_PI_4, 1.2f, 2.0f, 3.0f, 3.5f, -0.5f, 1.0f, 3.5f };
+			vec2fStream pos_sentries(num_sentries), dir_sentries(num_sentries), pos_targets(num_targets);
+			float ranges[num_sentries];
+			for (int s = 0; s < num_sentries; s++)
+			{
+				pos_sentries.Set(s, vec2f(0.5f * s, -0.25f * s));
+				dir_sentries.Set(s, (1.0f + s) * vec2f(cosf(0.9f * s), sinf(0.9f * s)));	// Not normalized
+				ranges[s] = 2.0f + 0.5f * s;
+			}
+			for (int t = 0; t < num_targets; t++)
+			{
+				pos_targets.Set(t, vec2f(4.0f * sinf(1.7f * t), 4.0f * cosf(2.3f * t + 0.4f)));
+			}
+			// Zero-length directions (narrow & all-round): never visible
+			dir_sentries.Set(num_sentries - 2, vec2f(0.0f, 0.0f));
+			dir_sentries.Set(num_sentries - 1, vec2f(0.0f, 0.0f));
+			// Target on top of sentry 0: never visible
+			pos_targets.Set(num_targets - 1, pos_sentries.Get(0));
+
+			const int num_words = VISIBILITY_WORDS(num_targets);
+			uint32_t visible[num_sentries * num_words];
+			GetVisibility2D(pos_sentries, dir_sentries, ranges, half_angles, pos_targets, visible);
+
+			int num_visible = 0;
+			for (int s = 0; s < num_sentries; s++)
+			{
+				for (int t = 0; t < num_targets; t++)
+				{
+					bool b_visible = ((visible[s * num_words + t / 32] >> (t % 32)) & 1) != 0;
+					bool b_expected = IsWithinRange2D(pos_sentries.Get(s), dir_sentries.Get(s), ranges[s], half_angles[s], pos_targets.Get(t));
+					Assert::AreEqual(b_expected, b_visible);
+					num_visible += (b_visible ? 1 : 0);
+				}
+			}
+			Assert::IsTrue(num_visible > 0 && num_visible < num_sentries * num_targets);
+		}
+
+		// 3D cone: points match the 2D test in the xy plane; spheres reach in from outside the cone
+		TEST_METHOD(Cone3DCases)
+		{
+			vec3f pos_sentry(1.0f, 2.0f, 0.0f);
+			vec3f dir_sentry(2.0f, 0.0f, 0.0f);
+			for (int i = 0; i < 64; i++)
+			{
+				vec2f target(1.0f + 5.0f * cosf(0.7f * i) * (0.1f + 0.02f * i), 2.0f + 5.0f * sinf(0.7f * i) * (0.1f + 0.02f * i));
+				bool b_expected = IsWithinRange2D(vec2f(1.0f, 2.0f), vec2f(2.0f, 0.0f), 4.0f, 0.6f, target);
+				Assert::AreEqual(b_expected, IsWithinCone3D(pos_sentry, dir_sentry, 4.0f, 0.6f, vec3f(target.x, target.y, 0.0f)));
+			}
+			Assert::IsFalse(IsWithinCone3D(pos_sentry, dir_sentry, 4.0f, 0.6f, pos_sentry));
+			Assert::IsTrue(IsWithinCone3D(pos_sentry, dir_sentry, 4.0f, 4.0f, vec3f(-1.0f, 2.0f, 0.0f)));
+			// Zero-length direction sees nothing (unless all-round), like the sphere & 2D tests
+			vec3f dir_zero(0.0f, 0.0f, 0.0f);
+			vec3f pos_ahead(2.0f, 2.0f, 0.0f);
+			Assert::IsFalse(IsWithinCone3D(pos_sentry, dir_zero, 4.0f, 0.3f, pos_ahead));
+			Assert::IsFalse(IsWithinCone3D(pos_sentry, dir_zero, 4.0f, 2.0f, pos_ahead));
+			Assert::IsFalse(IsSphereWithinCone3D(pos_sentry, dir_zero, 4.0f, 2.0f, pos_ahead, 0.1f));
+			Assert::IsFalse(IsWithinRange2D(vec2f(1.0f, 2.0f), vec2f(0.0f, 0.0f), 4.0f, 2.0f, vec2f(2.0f, 2.0f)));
+
+			// 45 degree cone along +x from the origin
+			vec3f origin(0.0f, 0.0f, 0.0f);
+			vec3f axis(1.0f, 0.0f, 0.0f);
+			float half = (float)M_PI_4;
+			Assert::IsTrue(IsSphereWithinCone3D(origin, axis, 10.0f, half, vec3f(5.0f, 0.0f, 0.0f), 0.1f));
+			// Center outside the cone, 1/sqrt(2) from its side
+			Assert::IsFalse(IsSphereWithinCone3D(origin, axis, 10.0f, half, vec3f(2.0f, 3.0f, 0.0f), 0.7f));
+			Assert::IsTrue(IsSphereWithinCone3D(origin, axis, 10.0f, half, vec3f(2.0f, 3.0f, 0.0f), 0.72f));
+			// Behind the apex: nearest point is the apex
+			Assert::IsFalse(IsSphereWithinCone3D(origin, axis, 10.0f, half, vec3f(-2.0f, 0.0f, 0.0f), 1.9f));
+			Assert::IsTrue(IsSphereWithinCone3D(origin, axis, 10.0f, half, vec3f(-2.0f, 0.0f, 0.0f), 2.1f));
+			// Out of range
+			Assert::IsFalse(IsSphereWithinCone3D(origin, axis, 10.0f, half, vec3f(12.0f, 0.0f, 0.0f), 1.0f));
+			Assert::IsTrue(IsAABBWithinCone3D(origin, axis, 10.0f, half, vec3f(1.5f, 2.0f, -0.5f), vec3f(2.5f, 3.0f, 0.5f)));
+
+			// Narrow & wide cones (sin != cos): small spheres just inside & just outside the half angle
+			const float half_degrees[] = { 10.0f, 80.0f };
+			for (float half_deg : half_degrees)
+			{
+				float half_rad = DegreesToRadians(half_deg);
+				for (int side = -1; side <= 1; side += 2)
+				{
+					float theta = DegreesToRadians(half_deg + 2.0f * side);
+					vec3f center(5.0f * cosf(theta), 5.0f * sinf(theta), 0.0f);
+					bool b_inside = (side < 0);
+					// 5 sin(2 degrees) = 0.17 from the side
+					Assert::AreEqual(b_inside, IsSphereWithinCone3D(origin, axis, 10.0f, half_rad, center, 0.05f));
+					Assert::AreEqual(b_inside, IsAABBWithinCone3D(origin, axis, 10.0f, half_rad, center - vec3f(0.02f, 0.02f, 0.02f), center + vec3f(0.02f, 0.02f, 0.02f)));
+				}
+			}
+			// 10 degree cone, 60 degrees off-axis
+			vec3f center_off_axis(5.0f * cosf(DegreesToRadians(60.0f)), 0.0f, 5.0f * sinf(DegreesToRadians(60.0f)));
+			Assert::IsFalse(IsWithinCone3D(origin, axis, 10.0f, DegreesToRadians(10.0f), center_off_axis));
+			Assert::IsFalse(IsSphereWithinCone3D(origin, axis, 10.0f, DegreesToRadians(10.0f), center_off_axis, 0.01f));
+			Assert::IsFalse(IsAABBWithinCone3D(origin, axis, 10.0f, DegreesToRadians(10.0f), center_off_axis - vec3f(0.01f, 0.01f, 0.01f), center_off_axis + vec3f(0.01f, 0.01f, 0.01f)));
+
+			// Spheres with radius near 0 agree with the point test (away from the boundary)
+			const float half_degrees_all[] = { 5.0f, 10.0f, 45.0f, 80.0f, 120.0f };
+			vec3f dir_skewed(1.0f, 2.0f, -0.5f);
+			vec3f perp_skewed = vec3f::CrossProduct(dir_skewed, vec3f(0.0f, 0.0f, 1.0f));
+			dir_skewed.Normalize();
+			perp_skewed.Normalize();
+			for (float half_deg : half_degrees_all)
+			{
+				for (int theta_deg = 0; theta_deg <= 180; theta_deg += 3)
+				{
+					if (fabsf(theta_deg - half_deg) < 1.0f)
+					{
+						continue;
+					}
+					float theta = DegreesToRadians((float)theta_deg);
+					vec3f point = pos_sentry + (3.0f * cosf(theta)) * dir_skewed + (3.0f * sinf(theta)) * perp_skewed;
+					bool b_expected = IsWithinCone3D(pos_sentry, 3.0f * dir_skewed, 4.0f, DegreesToRadians(half_deg), point);
+					Assert::AreEqual(b_expected, IsSphereWithinCone3D(pos_sentry, 3.0f * dir_skewed, 4.0f, DegreesToRadians(half_deg), point, 1e-4f));
+				}
+			}
+		}
+
+		// Batch frustum culling matches the single tests; hierarchical plane masks agree
+		TEST_METHOD(FrustumBatchMatchesSingle)
+		{
+			// Perspective (90 degree fov, aspect 1, near 1, far 100) looking down -z, camera at z = 5
+			const float n = 1.0f, f = 100.0f;
+			mat44 proj
+			(
+				vec4f(1.0f, 0.0f, 0.0f, 0.0f),
+				vec4f(0.0f, 1.0f, 0.0f, 0.0f),
+				vec4f(0.0f, 0.0f, -(f + n) / (f - n), -2.0f * f * n / (f - n)),
+				vec4f(0.0f, 0.0f, -1.0f, 0.0f)
+			);
+			mat44 view
+			(
+				vec4f(1.0f, 0.0f, 0.0f, 0.0f),
+				vec4f(0.0f, 1.0f, 0.0f, 0.0f),
+				vec4f(0.0f, 0.0f, 1.0f, -5.0f),
+				vec4f(0.0f, 0.0f, 0.0f, 1.0f)
+			);
+			Frustum frustum(proj * view);
+
+			Assert::IsTrue(frustum.ContainsPoint(vec3f(0.0f, 0.0f, 0.0f)));
+			Assert::IsTrue(frustum.ContainsPoint(vec3f(9.0f, 0.0f, -5.0f)));		// 10 deep, 45 degrees is x = 10
+			Assert::IsFalse(frustum.ContainsPoint(vec3f(11.0f, 0.0f, -5.0f)));
+			Assert::IsFalse(frustum.ContainsPoint(vec3f(0.0f, 0.0f, 4.5f)));		// Closer than near
+			Assert::IsFalse(frustum.ContainsPoint(vec3f(0.0f, 0.0f, -96.0f)));	// Past far
+			Assert::AreEqual((int)FRUSTUM_INSIDE, (int)frustum.TestSphere(vec3f(0.0f, 0.0f, -5.0f), 1.0f));
+			Assert::AreEqual((int)FRUSTUM_INTERSECT, (int)frustum.TestSphere(vec3f(0.0f, 0.0f, 4.5f), 1.0f));
+			Assert::AreEqual((int)FRUSTUM_OUTSIDE, (int)frustum.TestSphere(vec3f(0.0f, 0.0f, 7.0f), 1.0f));
+
+			const int count = 1003;
+			vec3fStream centers(count), bounds_min(count), bounds_max(count);
+			std::vector<float> radii(count);
+			for (int i = 0; i < count; i++)
+			{
+				vec3f center(40.0f * sinf(0.9f * i), 40.0f * cosf(1.3f * i), 5.0f - 60.0f * (0.5f + 0.5f * sinf(0.17f * i)));
+				radii[i] = 0.5f + 0.01f * (i % 300);
+				vec3f extent(radii[i], 0.5f * radii[i], 2.0f * radii[i]);
+				centers.Set(i, center);
+				bounds_min.Set(i, center - extent);
+				bounds_max.Set(i, center + extent);
+			}
+
+			std::vector<uint32_t> visible_spheres(VISIBILITY_WORDS(count)), visible_boxes(VISIBILITY_WORDS(count));
+			frustum.CullSpheres(centers, radii.data(), visible_spheres.data());
+			frustum.CullAABBs(bounds_min, bounds_max, visible_boxes.data());
+
+			int num_visible = 0;
+			for (int i = 0; i < count; i++)
+			{
+				bool b_sphere = ((visible_spheres[i / 32] >> (i % 32)) & 1) != 0;
+				bool b_box = ((visible_boxes[i / 32] >> (i % 32)) & 1) != 0;
+				Assert::AreEqual(frustum.TestSphere(centers.Get(i), radii[i]) != FRUSTUM_OUTSIDE, b_sphere);
+				Assert::AreEqual(frustum.TestAABB(bounds_min.Get(i), bounds_max.Get(i)) != FRUSTUM_OUTSIDE, b_box);
+				num_visible += (b_box ? 1 : 0);
+			}
+			Assert::IsTrue(num_visible > 0 && num_visible < count);
+
+			// BVH frustum query (hierarchical plane masks) matches testing every point
+			std::vector<vec3f> points(count);
+			for (int i = 0; i < count; i++)
+			{
+				points[i] = centers.Get(i);
+			}
+			BVH3D bvh;
+			bvh.Build(points.data(), NULL, count);
+			std::vector<uint32_t> ids;
+			bvh.QueryFrustum(frustum, ids);
+			std::sort(ids.begin(), ids.end());
+			std::vector<uint32_t> expected;
+			for (int i = 0; i < count; i++)
+			{
+				if (frustum.ContainsPoint(points[i]))
+				{
+					expected.push_back(i);
+				}
+			}
+			Assert::IsTrue(expected == ids);
+		}
+	};
+
+	TEST_CLASS(SpatialTests)
+	{
+	public:
+		// Grid queries match a brute-force IsWithinRange2D() scan, after moves & removals
+		TEST_METHOD(GridMatchesBruteForce)
+		{
+			const uint32_t count = 300;
+			SpatialGrid2D grid(2.0f);
+			std::vector<vec2f> positions(count);
+			for (uint32_t i = 0; i < count; i++)
+			{
+				positions[i] = vec2f(20.0f * sinf(1.3f * i), 20.0f * cosf(0.7f * i + 1.0f));
+				grid.Set(i, positions[i]);
+			}
+			for (uint32_t i = 0; i < count; i += 3)
+			{
+				positions[i] = positions[i] + vec2f(0.5f * cosf((float)i), 3.0f * sinf((float)i));
+				grid.Set(i, positions[i]);
+			}
+			for (uint32_t i = 1; i < count; i += 10)
+			{
+				grid.Remove(i);
+			}
+			Assert::AreEqual((size_t)(count - 30), grid.Size());
+
+			vec2f pos_sentry(1.0f, -2.0f);
+			const float ranges[] = { 0.5f, 6.0f, 100.0f };	// Last one covers every occupied cell
+			for (int r = 0; r < 3; r++)
+			{
+				std::vector<uint32_t> ids;
+				grid.QueryCone(pos_sentry, vec2f(1.0f, 1.0f), ranges[r], 0.8f, ids);
+				std::sort(ids.begin(), ids.end());
+
+				std::vector<uint32_t> expected;
+				for (uint32_t i = 0; i < count; i++)
+				{
+					if (grid.Contains(i) && IsWithinRange2D(pos_sentry, vec2f(1.0f, 1.0f), ranges[r], 0.8f, positions[i]))
+					{
+						expected.push_back(i);
+					}
+				}
+				Assert::IsTrue(expected == ids);
+			}
+
+			std::vector<uint32_t> ids;
+			grid.QueryRadius(pos_sentry, 6.0f, ids);
+			for (size_t i = 0; i < ids.size(); i++)
+			{
+				Assert::IsTrue((positions[ids[i]] - pos_sentry).Mag() <= 6.0f);
+			}
+			Assert::IsTrue(!ids.empty());
+		}
+
+		// BVH sphere & nearest-intercept queries match brute force, before & after a refit
+		TEST_METHOD(BVHMatchesBruteForce)
+		{
+			const uint32_t count = 500;
+			std::vector<vec3f> positions(count), velocities(count);
+			for (uint32_t i = 0; i < count; i++)
+			{
+				positions[i] = vec3f(30.0f * sinf(1.1f * i), 30.0f * cosf(0.37f * i), 30.0f * sinf(0.23f * i + 2.0f));
+				velocities[i] = vec3f(cosf(0.5f * i), sinf(0.9f * i), 0.3f);
+			}
+			// Entity 1 sits on the mover's path, so something is always contacted
+			vec3f center(2.0f, 1.0f, -3.0f);
+			vec3f vel_mover(4.0f, 0.0f, 1.0f);
+			positions[1] = center + 5.0f * vel_mover;
+			velocities[1] = vec3f(0.0f, 0.0f, 0.0f);
+
+			BVH3D bvh;
+			bvh.Build(positions.data(), velocities.data(), count);
+
+			for (int pass = 0; pass < 2; pass++)
+			{
+				if (pass == 1)
+				{
+					for (uint32_t i = 0; i < count; i += 2)
+					{
+						positions[i] = positions[i] + vec3f(5.0f, -3.0f, 1.0f);
+						velocities[i] = -2.0f * velocities[i];
+						bvh.Update(i, positions[i], velocities[i]);
+					}
+					bvh.Refit();
+				}
+
+				std::vector<uint32_t> ids;
+				bvh.QuerySphere(center, 12.0f, ids);
+				std::sort(ids.begin(), ids.end());
+				std::vector<uint32_t> expected;
+				for (uint32_t i = 0; i < count; i++)
+				{
+					if ((positions[i] - center).Mag() <= 12.0f)
+					{
+						expected.push_back(i);
+					}
+				}
+				Assert::IsTrue(expected == ids);
+
+				bool b_expected = false;
+				float expected_time = INFINITY;
+				for (uint32_t i = 0; i < count; i++)
+				{
+					float time;
+					if (SolveInterceptTime(center, vel_mover, positions[i], velocities[i], 2.0f, &time) == INTERCEPT_OK && time < expected_time)
+					{
+						b_expected = true;
+						expected_time = time;
+					}
+				}
+
+				uint32_t id = 0;
+				float time = -1.0f;
+				Assert::AreEqual(b_expected, bvh.QueryNearestIntercept(center, vel_mover, 2.0f, &id, &time));
+				Assert::IsTrue(b_expected);
+				Assert::AreEqual(expected_time, time);
+			}
+		}
+	};
+
+	TEST_CLASS(GeometryTests)
+	{
+	public:
+		// Single-ray tests on hand-checked hits & misses
+		TEST_METHOD(RayPrimitiveCases)
+		{
+			Ray ray(vec3f(-5.0f, 0.5f, 0.5f), vec3f(1.0f, 0.0f, 0.0f));
+			float t = -1.0f;
+
+			AABB box(vec3f(0.0f, 0.0f, 0.0f), vec3f(1.0f, 1.0f, 1.0f));
+			Assert::IsTrue(IntersectRayAABB(ray, box, 100.0f, &t));
+			Assert::AreEqual(5.0f, t);
+			Assert::IsFalse(IntersectRayAABB(ray, box, 4.0f, &t));		// Segment ends short of the box
+			Assert::IsFalse(IntersectRayAABB(Ray(vec3f(-5.0f, 2.0f, 0.5f), vec3f(1.0f, 0.0f, 0.0f)), box, 100.0f, &t));
+			Assert::IsTrue(IntersectRayAABB(Ray(vec3f(0.5f, 0.5f, 0.5f), vec3f(0.0f, 1.0f, 0.0f)), box, 100.0f, &t));
+			Assert::AreEqual(0.0f, t);	// Starts inside
+
+			// Zero direction components: inside the slab for every t (even on its plane) or for none
+			AABB grazed(vec3f(1.0f, 0.0f, -1.0f), vec3f(2.0f, 1.0f, 1.0f));
+			Ray grazing(vec3f(0.0f, 0.0f, 0.0f), vec3f(1.0f, 0.0f, 0.0f));
+			Assert::IsTrue(grazed.Contains(grazing.GetPoint(1.5f)));
+			Assert::IsTrue(IntersectRayAABB(grazing, grazed, 100.0f, &t));
+			Assert::AreEqual(1.0f, t);
+			Assert::IsTrue(IntersectRayAABB(Ray(vec3f(0.0f, 1.0f, 1.0f), vec3f(1.0f, 0.0f, 0.0f)), grazed, 100.0f, &t));	// On two max planes
+			Assert::AreEqual(1.0f, t);
+			Assert::IsTrue(IntersectRayAABB(Ray(vec3f(0.0f, 0.0f, 0.0f), vec3f(1.0f, -0.0f, 0.0f)), grazed, 100.0f, &t));
+			Assert::IsFalse(IntersectRayAABB(Ray(vec3f(0.0f, -0.001f, 0.0f), vec3f(1.0f, 0.0f, 0.0f)), grazed, 100.0f, &t));
+			Assert::IsFalse(IntersectRayAABB(Ray(vec3f(0.0f, 0.5f, 0.0f), vec3f(0.0f, 0.0f, 0.0f)), grazed, 100.0f, &t));
+			Assert::IsTrue(IntersectRayAABB(Ray(vec3f(1.0f, 0.0f, 0.0f), vec3f(0.0f, 0.0f, 0.0f)), grazed, 100.0f, &t));	// Zero ray on a corner edge
+			Assert::AreEqual(0.0f, t);
+
+			Sphere sphere(vec3f(0.0f, 0.5f, 0.5f), 2.0f);
+			Assert::IsTrue(IntersectRaySphere(ray, sphere, 100.0f, &t));
+			Assert::AreEqual(3.0f, t, 1e-6f);
+			Assert::IsFalse(IntersectRaySphere(Ray(vec3f(-5.0f, 3.0f, 0.5f), vec3f(1.0f, 0.0f, 0.0f)), sphere, 100.0f, &t));
+			Assert::IsFalse(IntersectRaySphere(Ray(vec3f(5.0f, 0.5f, 0.5f), vec3f(1.0f, 0.0f, 0.0f)), sphere, 100.0f, &t));	// Behind
+
+			Triangle tri(vec3f(0.0f, 0.0f, 0.0f), vec3f(0.0f, 2.0f, 0.0f), vec3f(0.0f, 0.0f, 2.0f));
+			Assert::IsTrue(IntersectRayTriangle(ray, tri, 100.0f, &t));
+			Assert::AreEqual(5.0f, t, 1e-6f);
+			Assert::IsTrue(IntersectRayTriangle(Ray(vec3f(5.0f, 0.5f, 0.5f), vec3f(-1.0f, 0.0f, 0.0f)), tri, 100.0f, &t));	// Back face
+			Assert::IsFalse(IntersectRayTriangle(Ray(vec3f(-5.0f, 1.5f, 1.5f), vec3f(1.0f, 0.0f, 0.0f)), tri, 100.0f, &t));
+			Assert::IsFalse(IntersectRayTriangle(Ray(vec3f(-5.0f, 0.5f, 0.5f), vec3f(0.0f, 1.0f, 0.0f)), tri, 100.0f, &t));	// Parallel
+		}
+
+		// Batch ray tests match the single-ray tests bit for bit
+		TEST_METHOD(BatchMatchesSingle)
+		{
+			const int count = 517;
+			vec3fStream origins(count), dirs(count);
+			std::vector<float> t_max(count);
+			for (int i = 0; i < count; i++)
+			{
+				vec3f origin(6.0f * sinf(0.37f * i), 6.0f * cosf(0.73f * i), 6.0f * sinf(1.91f * i + 0.5f));
+				vec3f target(1.5f * cosf(1.3f * i), 1.5f * sinf(0.9f * i), 1.5f * cosf(0.41f * i));
+				origins.Set(i, origin);
+				dirs.Set(i, target - origin);
+				t_max[i] = (i % 5 == 0 ? 0.5f : 1.0f);
+			}
+			dirs.Set(7, vec3f(0.0f, 0.0f, 0.0f));
+
+			AABB box(vec3f(-1.0f, -0.5f, -1.0f), vec3f(1.0f, 0.5f, 0.8f));
+
+			// Axis-aligned rays grazing the box's faces & edges, mid-vector
+			for (int i = 0; i < 8; i++)
+			{
+				origins.Set(40 + i, vec3f(-3.0f, (i & 1) ? 0.5f : -0.5f, (i & 4) ? -3.5f : ((i & 2) ? 0.8f : 0.5f)));
+				dirs.Set(40 + i, vec3f(1.0f, 0.0f, 0.0f));
+				t_max[40 + i] = 10.0f;
+			}
+			Sphere sphere(vec3f(0.2f, -0.1f, 0.3f), 1.1f);
+			Triangle tri(vec3f(-1.0f, -1.0f, 0.0f), vec3f(1.5f, -0.5f, 0.2f), vec3f(0.0f, 1.5f, -0.3f));
+
+			std::vector<uint32_t> hits(RAY_HIT_WORDS(count));
+			std::vector<float> times(count);
+			for (int prim = 0; prim < 3; prim++)
+			{
+				switch (prim)
+				{
+					case 0: IntersectRays(origins, dirs, t_max.data(), box, hits.data(), times.data()); break;
+					case 1: IntersectRays(origins, dirs, t_max.data(), sphere, hits.data(), times.data()); break;
+					case 2: IntersectRays(origins, dirs, t_max.data(), tri, hits.data(), times.data()); break;
+				}
+
+				int num_hits = 0;
+				for (int i = 0; i < count; i++)
+				{
+					Ray ray(origins.Get(i), dirs.Get(i));
+					float t = INFINITY;
+					bool b_expected = false;
+					switch (prim)
+					{
+						case 0: b_expected = IntersectRayAABB(ray, box, t_max[i], &t); break;
+						case 1: b_expected = IntersectRaySphere(ray, sphere, t_max[i], &t); break;
+						case 2: b_expected = IntersectRayTriangle(ray, tri, t_max[i], &t); break;
+					}
+
+					bool b_hit = ((hits[i / 32] >> (i % 32)) & 1) != 0;
+					Assert::AreEqual(b_expected, b_hit);
+					Assert::AreEqual(t, times[i]);
+					if (prim == 0 && i >= 40 && i < 48)
+					{
+						Assert::AreEqual((i & 4) == 0, b_hit);	// Faces & edges hit; z = -3.5 is outside
+					}
+					num_hits += (b_hit ? 1 : 0);
+				}
+				Assert::IsTrue(num_hits > 0 && num_hits < count);
+			}
+		}
+	};
+
+	TEST_CLASS(InverseTests)
+	{
+	public:
+		static void AssertIdentity(const mat44& mat, float fTolerance)
+		{
+			for (int r = 0; r < 4; r++)
+			{
+				for (int c = 0; c < 4; c++)
+				{
+					Assert::AreEqual(MAT44_IDENTITY[r][c], mat[r][c], fTolerance);
+				}
+			}
+		}
+
+		// Closed-form inverse (scalar & SSE) gives M * inv(M) = I & the right determinant
+		TEST_METHOD(InverseGeneral)
+		{
+			mat44 mat
+			(
+				vec4f(3, 0, 2, -1),
+				vec4f(1, 2, 0, -2),
+				vec4f(4, 0, 6, -3),
+				vec4f(5, 0, 2, 0)
+			);
+
+			SimdLevel level = GetSimdLevel();
+			for (int i = 0; i < 2; i++)
+			{
+				SetSimdLevel(i == 0 ? SIMD_SCALAR : level);
+
+				mat44 mat_inv;
+				float det = 0.0f;
+				Assert::IsTrue(mat.TryGetInverse(mat_inv, MAT_SINGULAR_EPSILON, &det));
+				Assert::AreEqual(20.0f, det, 1e-4f);
+				AssertIdentity(mat * mat_inv, 1e-5f);
+			}
+			SetSimdLevel(level);
+		}
+
+		TEST_METHOD(InverseSingular)
+		{
+			mat44 mat
+			(
+				vec4f(1, 2, 3, 4),
+				vec4f(2, 4, 6, 8),
+				vec4f(0, 1, 0, 1),
+				vec4f(5, 0, 2, 0)
+			);
+			mat44 mat_inv;
+			Assert::IsFalse(mat.TryGetInverse(mat_inv));
+			Assert::IsFalse(mat.TryGetInverseAffine(mat_inv));
+		}
+
+		TEST_METHOD(InverseRigidAndAffine)
+		{
+			mat44 mat_rigid = mat44::GetMatrixRotXD(30.0f) * mat44::GetMatrixRotZD(-75.0f);
+			mat_rigid[0][3] = 4.0f;
+			mat_rigid[1][3] = -2.0f;
+			mat_rigid[2][3] = 7.0f;
+			AssertIdentity(mat_rigid.GetInverseRigid() * mat_rigid, 1e-5f);
+
+			mat44 mat_affine = mat_rigid * mat44::GetMatrixScale(0.5f);
+			mat44 mat_inv;
+			Assert::IsTrue(mat_affine.TryGetInverseAffine(mat_inv));
+			AssertIdentity(mat_inv * mat_affine, 1e-5f);
+		}
+	};
+
+	TEST_CLASS(ConstexprTests)
+	{
+	public:
+		// Core vector/matrix math folds at compile time
+		TEST_METHOD(MathFoldsAtCompileTime)
+		{
+			constexpr vec3f v_cross = vec3f::CrossProduct(vec3f(1, 0, 0), vec3f(0, 1, 0));
+			static_assert(v_cross.z() == 1.0f, "CrossProduct should be constexpr");
+
+			constexpr mat44 mat_scaled = mat44::GetMatrixScale(2.0f) * MAT44_IDENTITY;
+			static_assert(mat_scaled[1][1] == 2.0f && mat_scaled[3][3] == 1.0f, "mat44 product should be constexpr");
+
+			constexpr mat44 mat_rot90 = mat44::GetMatrixRotZ(1.0f, 0.0f);
+			constexpr vec4f v_rot = mat_rot90 * vec4f(1, 0, 0, 1);
+			static_assert(v_rot.y() == 1.0f, "mat44 * vec4f should be constexpr");
+
+			Assert::AreEqual(1.0f, v_rot.y());
+		}
+
+		TEST_METHOD(Mat33Multiply)
+		{
+			constexpr mat33 mat
+			(
+				vec3f(6, 1, 1),
+				vec3f(4, -2, 5),
+				vec3f(2, 8, 7)
+			);
+			constexpr mat33 mat_result = mat * MAT33_IDENTITY;
+			static_assert(mat_result[2][1] == 8.0f, "mat33 product should be constexpr");
+
+			mat33 mat_square = mat * mat;
+			Assert::AreEqual(42.0f, mat_square[0][0]);
+			Assert::AreEqual(29.0f, mat_square[1][2]);
+		}
+	};
+
+	TEST_CLASS(TemplateTests)
+	{
+	public:
+		// Double & int instantiations of the generic vec/mat templates
+		TEST_METHOD(DoubleAndIntVariants)
+		{
+			constexpr vec2i v_int = vec2i(3, 4) + vec2i(1, 2);
+			static_assert(v_int.x == 4 && v_int.y == 6, "vec2i should be constexpr");
+			Assert::AreEqual(25, vec3i::DotProduct(vec3i(3, 4, 0), vec3i(3, 4, 0)));
+
+			mat44d mat = mat44d::GetMatrixRotXD(30.0) * mat44d::GetMatrixScale(3.0);
+			mat[0][3] = 5.0;
+
+			mat44d mat_inv;
+			Assert::IsTrue(mat.TryGetInverse(mat_inv));
+			mat44d mat_identity = mat * mat_inv;
+			for (int r = 0; r < 4; r++)
+			{
+				for (int c = 0; c < 4; c++)
+				{
+					Assert::AreEqual((r == c ? 1.0 : 0.0), mat_identity[r][c], 1.0e-12);
+				}
+			}
+
+			mat33d mat_small = mat33d::GetMatrixScale(2.0);
+			Assert::AreEqual(8.0, mat_small.GetDeterminant());
+		}
+
+		// SIMD float4/double4 paths match the compile-time (generic) results exactly
+		TEST_METHOD(SimdMatchesConstexpr)
+		{
+			constexpr mat44 mat_a = mat44::GetMatrixRotX(0.6f, 0.8f) * mat44::GetMatrixScale(1.7f);
+			constexpr mat44 mat_b = mat44::GetMatrixRotZ(0.28f, 0.96f) * mat_a;
+			constexpr vec4f v_const = mat_b * vec4f(1.3f, -2.1f, 0.7f, 1.0f);
+			constexpr vec4f v_sum = (0.3f * v_const) - vec4f(1.1f, 0.9f, 0.7f, 0.5f);
+
+			mat44 mat_a_rt = mat44::GetMatrixRotX(0.6f, 0.8f) * mat44::GetMatrixScale(1.7f);
+			mat44 mat_b_rt = mat44::GetMatrixRotZ(0.28f, 0.96f) * mat_a_rt;
+			vec4f v_rt = mat_b_rt * vec4f(1.3f, -2.1f, 0.7f, 1.0f);
+			vec4f v_sum_rt = (0.3f * v_rt) - vec4f(1.1f, 0.9f, 0.7f, 0.5f);
+
+			for (int i = 0; i < 4; i++)
+			{
+				Assert::AreEqual(v_const[i], v_rt[i]);
+				Assert::AreEqual(v_sum[i], v_sum_rt[i]);
+			}
+
+			constexpr vec4d vd_const = mat44d::GetMatrixRotY(0.6, 0.8) * vec4d(1.5, 2.5, -3.5, 1.0);
+			vec4d vd_rt = mat44d::GetMatrixRotY(0.6, 0.8) * vec4d(1.5, 2.5, -3.5, 1.0);
+			for (int i = 0; i < 4; i++)
+			{
+				Assert::AreEqual(vd_const[i], vd_rt[i]);
+			}
+		}
+	};
+
+	TEST_CLASS(PropertyTests)
+	{
+	public:
+		// Random well-conditioned (diagonally dominant) matrices: M * inv(M) = inv(M) * M = I, scalar & SIMD
+		TEST_METHOD(InverseTimesMatrixIsIdentity)
+		{
+			TestRandom rng(0x3DE9u);
+			SimdLevel level = GetSimdLevel();
+			for (int iter = 0; iter < 200; iter++)
+			{
+				mat44 mat;
+				for (int r = 0; r < 4; r++)
+				{
+					for (int c = 0; c < 4; c++)
+					{
+						mat[r][c] = rng.Range(-1.0f, 1.0f);
+					}
+					mat[r][r] += ((rng.Next() & 1) ? 5.0f : -5.0f);
+				}
+
+				for (int i = 0; i < 2; i++)
+				{
+					SetSimdLevel(i == 0 ? SIMD_SCALAR : level);
+					mat44 mat_inv;
+					Assert::IsTrue(mat.TryGetInverse(mat_inv));
+					InverseTests::AssertIdentity(mat * mat_inv, 1e-5f);
+					InverseTests::AssertIdentity(mat_inv * mat, 1e-5f);
+				}
+				SetSimdLevel(level);
+
+				mat44d mat_d, mat_d_inv;
+				for (int r = 0; r < 4; r++)
+				{
+					for (int c = 0; c < 4; c++)
+					{
+						mat_d[r][c] = mat[r][c];
+					}
+				}
+				Assert::IsTrue(mat_d.TryGetInverse(mat_d_inv));
+				mat44d mat_d_identity = mat_d * mat_d_inv;
+				for (int r = 0; r < 4; r++)
+				{
+					for (int c = 0; c < 4; c++)
+					{
+						Assert::AreEqual((r == c ? 1.0 : 0.0), mat_d_identity[r][c], 1.0e-12);
+					}
+				}
+			}
+		}
+
+		// Random rigid & scaled affine transforms: the specialized inverses undo them
+		TEST_METHOD(AffineInverseUndoesTransform)
+		{
+			TestRandom rng(0xAFF1u);
+			for (int iter = 0; iter < 200; iter++)
+			{
+				mat44 mat_rigid = mat44::GetMatrixRotXD(rng.Range(-180.0f, 180.0f)) * mat44::GetMatrixRotYD(rng.Range(-180.0f, 180.0f))
+								* mat44::GetMatrixRotZD(rng.Range(-180.0f, 180.0f));
+				vec3f translation = rng.Vec3(-50.0f, 50.0f);
+				for (int r = 0; r < 3; r++)
+				{
+					mat_rigid[r][3] = translation[r];
+				}
+				InverseTests::AssertIdentity(mat_rigid.GetInverseRigid() * mat_rigid, 1e-4f);
+
+				mat44 mat_affine = mat_rigid * mat44::GetMatrixScale(rng.Range(0.25f, 4.0f));
+				mat44 mat_inv;
+				Assert::IsTrue(mat_affine.TryGetInverseAffine(mat_inv));
+				InverseTests::AssertIdentity(mat_inv * mat_affine, 1e-4f);
+			}
+		}
+
+		// Rotation preserves lengths & angles, & the conjugate rotates back
+		TEST_METHOD(QuaternionRotationPreservesLength)
+		{
+			TestRandom rng(0x0A7u);
+			for (int iter = 0; iter < 500; iter++)
+			{
+				vec3f axis = rng.Vec3(-1.0f, 1.0f);
+				if (axis.Mag() < 1e-3f)
+				{
+					continue;
+				}
+				Quaternion q_rot = Quaternion::GetRotationD(axis, rng.Range(-360.0f, 360.0f));
+				Assert::AreEqual(1.0f, q_rot.GetNorm(), 1e-6f);
+
+				vec3f v1 = rng.Vec3(-100.0f, 100.0f);
+				vec3f v2 = rng.Vec3(-100.0f, 100.0f);
+				vec3f v1_rot = q_rot.RotateVector(v1);
+				vec3f v2_rot = q_rot.RotateVector(v2);
+				float mag1 = v1.Mag();
+				Assert::AreEqual(mag1, v1_rot.Mag(), 1e-5f * mag1);
+				Assert::AreEqual(vec3f::DotProduct(v1, v2), vec3f::DotProduct(v1_rot, v2_rot), 1e-5f * mag1 * v2.Mag());
+
+				vec3f v1_back = q_rot.GetConjugate().RotateVector(v1_rot);
+				for (int c = 0; c < 3; c++)
+				{
+					Assert::AreEqual(v1[c], v1_back[c], 2e-5f * mag1);
+				}
+			}
+		}
+
+		// Every Bezier type starts exactly on its first control point & ends exactly on its last,
+		// whether evaluated or flattened
+		TEST_METHOD(BezierEndpoints)
+		{
+			TestRandom rng(0xBE2u);
+			for (int iter = 0; iter < 100; iter++)
+			{
+				vec2f c2[4] = { rng.Vec2(-500.0f, 500.0f), rng.Vec2(-500.0f, 500.0f), rng.Vec2(-500.0f, 500.0f), rng.Vec2(-500.0f, 500.0f) };
+				vec3f c3[4] = { rng.Vec3(-500.0f, 500.0f), rng.Vec3(-500.0f, 500.0f), rng.Vec3(-500.0f, 500.0f), rng.Vec3(-500.0f, 500.0f) };
+				float tolerance = rng.Range(0.01f, 2.0f);
+
+				Bezier2DQuad bq(c2[0], c2[1], c2[2]);
+				Bezier2DCube bc(c2[0], c2[1], c2[2], c2[3]);
+				BezierCurve2D* curves_2d[2] = { &bq, &bc };
+				const vec2f ends_2d[2] = { c2[2], c2[3] };
+				for (int k = 0; k < 2; k++)
+				{
+					std::vector<vec2f> points;
+					curves_2d[k]->Flatten(tolerance, points);
+					vec2f start = curves_2d[k]->GetPoint(0.0f), end = curves_2d[k]->GetPoint(1.0f);
+					Assert::IsTrue(start.x == c2[0].x && start.y == c2[0].y);
+					Assert::IsTrue(end.x == ends_2d[k].x && end.y == ends_2d[k].y);
+					Assert::IsTrue(points.front().x == c2[0].x && points.front().y == c2[0].y);
+					Assert::IsTrue(points.back().x == ends_2d[k].x && points.back().y == ends_2d[k].y);
+				}
+
+				Bezier3DQuad bq3(c3[0], c3[1], c3[2]);
+				Bezier3DCube bc3(c3[0], c3[1], c3[2], c3[3]);
+				const BezierCurve3D* curves_3d[2] = { &bq3, &bc3 };
+				const vec3f ends_3d[2] = { c3[2], c3[3] };
+				for (int k = 0; k < 2; k++)
+				{
+					std::vector<vec3f> points;
+					curves_3d[k]->Flatten(tolerance, points);
+					vec3f start = curves_3d[k]->GetPoint(0.0f), end = curves_3d[k]->GetPoint(1.0f);
+					for (int c = 0; c < 3; c++)
+					{
+						Assert::AreEqual(c3[0][c], start[c]);
+						Assert::AreEqual(ends_3d[k][c], end[c]);
+						Assert::AreEqual(c3[0][c], points.front()[c]);
+						Assert::AreEqual(ends_3d[k][c], points.back()[c]);
+					}
+				}
+
+				Bezier2DCubeStream curves(1);
+				curves.SetCurve(0, c2);
+				Assert::IsTrue(curves.GetPoint(0, 0.0f).x == c2[0].x && curves.GetPoint(0, 0.0f).y == c2[0].y);
+				Assert::IsTrue(curves.GetPoint(0, 1.0f).x == c2[3].x && curves.GetPoint(0, 1.0f).y == c2[3].y);
+			}
+		}
+	};
+
+	TEST_CLASS(DifferentialTests)
+	{
+	public:
+		// Random inputs with a few exact zeros & huge/tiny magnitudes mixed in; odd counts exercise the tails
+		static void FillStream(TestRandom& rng, vec3fStream& s, size_t count, float fRange)
+		{
+			s.Resize(count);
+			for (size_t i = 0; i < count; i++)
+			{
+				vec3f v = rng.Vec3(-fRange, fRange);
+				switch (rng.Next() % 16)
+				{
+					case 0: v = vec3f(0.0f, v.y(), 0.0f); break;
+					case 1: v = 1.0e4f * v; break;
+					case 2: v = 1.0e-4f * v; break;
+				}
+				s.Set(i, v);
+			}
+		}
+
+		TEST_METHOD(VecStreams)
+		{
+			AssertEveryLevelMatchesScalar([](KernelResults& rResults)
+			{
+				TestRandom rng(101);
+				const size_t count = 203;
+				vec3fStream s1, s2, s_result;
+				FillStream(rng, s1, count, 10.0f);
+				FillStream(rng, s2, count, 10.0f);
+				std::vector<float> values(count);
+
+				vec3fStream::Add(s1, s2, s_result);			rResults.Add(s_result);
+				vec3fStream::Sub(s1, s2, s_result);			rResults.Add(s_result);
+				vec3fStream::Scale(-1.7f, s1, s_result);	rResults.Add(s_result);
+				vec3fStream::CrossProduct(s1, s2, s_result);	rResults.Add(s_result);
+				vec3fStream::DotProduct(s1, s2, values.data());	rResults.Add(values.data(), count);
+				s1.Mag(values.data());						rResults.Add(values.data(), count);
+				s1.Normalize();								rResults.Add(s1);
+
+				vec4fStream q1(count), q2(count), q_result;
+				for (size_t i = 0; i < count; i++)
+				{
+					q1.Set(i, vec4f(s2.X()[i], s1.Y()[i], s2.Z()[i], rng.Range(-1.0f, 1.0f)));
+					q2.Set(i, vec4f(rng.Range(-1.0f, 1.0f), s2.Y()[i], s1.Z()[i], s1.X()[i]));
+				}
+				vec4fStream::Sub(q1, q2, q_result);			rResults.Add(q_result);
+				vec4fStream::DotProduct(q1, q2, values.data());	rResults.Add(values.data(), count);
+				q1.Normalize();								rResults.Add(q1);
+			});
+		}
+
+		TEST_METHOD(MatrixTransforms)
+		{
+			AssertEveryLevelMatchesScalar([](KernelResults& rResults)
+			{
+				TestRandom rng(202);
+				const size_t count = 517;
+				mat44 mat = mat44::GetMatrixRotXD(rng.Range(-180.0f, 180.0f)) * mat44::GetMatrixScale(rng.Range(0.5f, 3.0f));
+				for (int c = 0; c < 4; c++)
+				{
+					mat[3][c] = rng.Range(-0.5f, 0.5f);	// Projective row
+					mat[c][3] += rng.Range(-20.0f, 20.0f);
+				}
+
+				vec3fStream points, s_result;
+				FillStream(rng, points, count, 100.0f);
+				mat.TransformPoints(points, s_result);		rResults.Add(s_result);
+				mat.TransformDirections(points, s_result);	rResults.Add(s_result);
+
+				std::vector<vec3f> vecs(count), result(count);
+				std::vector<vec4f> vecs4(count), result4(count);
+				for (size_t i = 0; i < count; i++)
+				{
+					vecs[i] = points.Get(i);
+					vecs4[i] = vec4f(vecs[i].x(), vecs[i].y(), vecs[i].z(), rng.Range(-2.0f, 2.0f));
+				}
+				mat.TransformPoints(vecs.data(), result.data(), count);
+				rResults.Add(reinterpret_cast<const float*>(result.data()), 3 * count);
+				mat.TransformDirections(vecs.data(), result.data(), count);
+				rResults.Add(reinterpret_cast<const float*>(result.data()), 3 * count);
+				mat.TransformVectors(vecs4.data(), result4.data(), count);
+				rResults.Add(reinterpret_cast<const float*>(result4.data()), 4 * count);
+			});
+		}
+
+		TEST_METHOD(QuaternionKernels)
+		{
+			AssertEveryLevelMatchesScalar([](KernelResults& rResults)
+			{
+				TestRandom rng(303);
+				const size_t count = 301;
+				Quaternion q_rot = Quaternion::GetRotationD(rng.Vec3(-1.0f, 1.0f), rng.Range(-360.0f, 360.0f));
+
+				vec3fStream vecs, s_result;
+				FillStream(rng, vecs, count, 50.0f);
+				q_rot.RotateVectors(vecs, s_result);		rResults.Add(s_result);
+
+				std::vector<vec3f> vecs_aos(count), result(count);
+				for (size_t i = 0; i < count; i++)
+				{
+					vecs_aos[i] = vecs.Get(i);
+				}
+				q_rot.RotateVectors(vecs_aos.data(), result.data(), count);
+				rResults.Add(reinterpret_cast<const float*>(result.data()), 3 * count);
+
+				vec4fStream quats0(count), quats1(count), q_result;
+				for (size_t i = 0; i < count; i++)
+				{
+					Quaternion q0 = Quaternion::GetRotationD(rng.Vec3(-1.0f, 1.0f), rng.Range(-360.0f, 360.0f));
+					Quaternion q1 = Quaternion::GetRotationD(rng.Vec3(-1.0f, 1.0f), rng.Range(-360.0f, 360.0f));
+					quats0.Set(i, vec4f(q0.i(), q0.j(), q0.k(), q0.w()));
+					quats1.Set(i, vec4f(q1.i(), q1.j(), q1.k(), q1.w()));
+				}
+				Quaternion::Nlerp(quats0, quats1, rng.Range(0.0f, 1.0f), q_result);
+				rResults.Add(q_result);
+			});
+		}
+
+		TEST_METHOD(CurveStreams)
+		{
+			TestRandom rng(404);
+			const size_t count = 77;
+			Bezier2DQuadStream quads(count);
+			Bezier2DCubeStream cubes(count);
+			for (size_t i = 0; i < count; i++)
+			{
+				const vec2f controls[4] = { rng.Vec2(-300.0f, 300.0f), rng.Vec2(-300.0f, 300.0f), rng.Vec2(-300.0f, 300.0f), rng.Vec2(-300.0f, 300.0f) };
+				const vec2f controls_quad[3] = { controls[0], controls[1], controls[2] };
+				quads.SetCurve(i, controls_quad);
+				cubes.SetCurve(i, controls);
+			}
+			std::vector<float> t_vals(count);
+			for (size_t j = 0; j < count; j++)
+			{
+				t_vals[j] = rng.Range(0.0f, 1.0f);
+			}
+
+			AssertEveryLevelMatchesScalar([&](KernelResults& rResults)
+			{
+				vec2fStream points;
+				quads.GetPoints(0.37f, points);							rResults.Add(points);
+				cubes.GetPoints(0.81f, points);							rResults.Add(points);
+				quads.GetPoints(5, t_vals.data(), count, points);		rResults.Add(points);
+				cubes.GetPoints(11, t_vals.data(), count, points);		rResults.Add(points);
+			});
+
+			// Power-form (Horner) evaluation vs the Bernstein form: within a few ULPs of the curve's scale
+			vec2fStream points;
+			cubes.GetPoints(11, t_vals.data(), count, points);
+			for (size_t j = 0; j < count; j++)
+			{
+				vec2f expected = cubes.GetPoint(11, t_vals[j]);
+				AssertWithinUlps(expected.x, points.Get(j).x, 16, 1.0e-4f);
+				AssertWithinUlps(expected.y, points.Get(j).y, 16, 1.0e-4f);
+			}
+		}
+
+		TEST_METHOD(InterceptKernels)
+		{
+			AssertEveryLevelMatchesScalar([](KernelResults& rResults)
+			{
+				TestRandom rng(505);
+				const size_t count = 333;
+				vec3fStream pos1, vel1, pos2, vel2, dirs;
+				FillStream(rng, pos1, count, 100.0f);
+				FillStream(rng, vel1, count, 10.0f);
+				FillStream(rng, pos2, count, 100.0f);
+				FillStream(rng, vel2, count, 10.0f);
+				vel2.Set(3, vel1.Get(3));	// No relative motion
+
+				std::vector<float> times(count), speeds(count);
+				std::vector<InterceptStatus> statuses(count);
+				SolveInterceptTimes(pos1, vel1, pos2, vel2, 2.5f, times.data(), statuses.data());
+				rResults.Add(times.data(), count);
+				for (size_t i = 0; i < count; i++)
+				{
+					rResults.words.push_back((uint32_t)statuses[i]);
+					speeds[i] = rng.Range(1.0f, 20.0f);
+				}
+
+				bool can_intercept[count];
+				GetTargetIntercepts(pos1, speeds.data(), pos2, vel2, dirs, can_intercept);
+				rResults.Add(dirs);
+				for (size_t i = 0; i < count; i++)
+				{
+					rResults.words.push_back(can_intercept[i] ? 1 : 0);
+				}
+			});
+		}
+
+		TEST_METHOD(CullingAndRayKernels)
+		{
+			AssertEveryLevelMatchesScalar([](KernelResults& rResults)
+			{
+				TestRandom rng(606);
+				const size_t num_sentries = 9, num_targets = 141;
+				vec2fStream pos_sentries(num_sentries), dir_sentries(num_sentries), pos_targets(num_targets);
+				float ranges[num_sentries], half_angles[num_sentries];
+				for (size_t s = 0; s < num_sentries; s++)
+				{
+					pos_sentries.Set(s, rng.Vec2(-5.0f, 5.0f));
+					dir_sentries.Set(s, rng.Vec2(-2.0f, 2.0f));
+					ranges[s] = rng.Range(1.0f, 8.0f);
+					half_angles[s] = rng.Range(-0.5f, 3.5f);
+				}
+				for (size_t t = 0; t < num_targets; t++)
+				{
+					pos_targets.Set(t, rng.Vec2(-10.0f, 10.0f));
+				}
+				std::vector<uint32_t> visible(num_sentries * VISIBILITY_WORDS(num_targets));
+				GetVisibility2D(pos_sentries, dir_sentries, ranges, half_angles, pos_targets, visible.data());
+				rResults.Add(visible.data(), visible.size());
+
+				const size_t count = 419;
+				mat44 view_proj = mat44::GetMatrixRotYD(rng.Range(-180.0f, 180.0f));
+				view_proj[3] = vec4f(0.1f, -0.2f, -1.0f, 0.0f);	// Perspective divide by -z (roughly)
+				view_proj[2][3] = -2.0f;
+				Frustum frustum(view_proj);
+				vec3fStream centers, extents, bounds_min, bounds_max;
+				FillStream(rng, centers, count, 30.0f);
+				FillStream(rng, extents, count, 3.0f);
+				std::vector<float> radii(count);
+				bounds_min.Resize(count);
+				bounds_max.Resize(count);
+				for (size_t i = 0; i < count; i++)
+				{
+					vec3f extent = extents.Get(i);
+					extent = vec3f(fabsf(extent.x()), fabsf(extent.y()), fabsf(extent.z()));
+					radii[i] = extent.Mag();
+					vec3f center = centers.Get(i);
+					bounds_min.Set(i, center - extent);
+					bounds_max.Set(i, center + extent);
+				}
+				std::vector<uint32_t> visible_objects(VISIBILITY_WORDS(count));
+				frustum.CullSpheres(centers, radii.data(), visible_objects.data());
+				rResults.Add(visible_objects.data(), visible_objects.size());
+				frustum.CullAABBs(bounds_min, bounds_max, visible_objects.data());
+				rResults.Add(visible_objects.data(), visible_objects.size());
+
+				vec3fStream origins, dirs;
+				FillStream(rng, origins, count, 8.0f);
+				FillStream(rng, dirs, count, 1.0f);
+				std::vector<float> t_max(count), times(count);
+				for (size_t i = 0; i < count; i++)
+				{
+					t_max[i] = rng.Range(1.0f, 20.0f);
+				}
+				std::vector<uint32_t> hits(RAY_HIT_WORDS(count));
+				IntersectRays(origins, dirs, t_max.data(), AABB(vec3f(-2.0f, -1.0f, -3.0f), vec3f(2.0f, 1.5f, 0.5f)), hits.data(), times.data());
+				rResults.Add(hits.data(), hits.size());
+				rResults.Add(times.data(), count);
+				IntersectRays(origins, dirs, t_max.data(), Sphere(vec3f(0.5f, -0.5f, 1.0f), 2.5f), hits.data(), times.data());
+				rResults.Add(hits.data(), hits.size());
+				rResults.Add(times.data(), count);
+				IntersectRays(origins, dirs, t_max.data(), Triangle(vec3f(-3.0f, -3.0f, 0.0f), vec3f(4.0f, -1.0f, 1.0f), vec3f(0.0f, 4.0f, -1.0f)), hits.data(), times.data());
+				rResults.Add(hits.data(), hits.size());
+				rResults.Add(times.data(), count);
+			});
+		}
+		TEST_METHOD(TrigKernels)
+		{
+			AssertEveryLevelMatchesScalar([](KernelResults& rResults)
+			{
+				TestRandom rng(909);
+				const size_t count = 411;
+				std::vector<float> angles(count), sins(count), coss(count);
+				for (size_t i = 0; i < count; i++)
+				{
+					angles[i] = (i % 50 == 3 ? rng.Range(-1.0e8f, 1.0e8f) : rng.Range(-2000.0f, 2000.0f));
+				}
+
+				SinCos(angles.data(), sins.data(), coss.data(), count);		rResults.Add(sins.data(), count);	rResults.Add(coss.data(), count);
+				SinCosD(angles.data(), sins.data(), coss.data(), count);	rResults.Add(sins.data(), count);	rResults.Add(coss.data(), count);
+			});
+		}
+
+	};
+}
@@ -0,0 +1,215 @@
+#include "camera.h"
+
+// Includes: Project
+#include "parallel.h"
+
+// Below this many matrices per thread, GetModelViewProjs() stays on the calling thread
+#define CAMERA_BULK_GRAIN	(1 << 12)
+
+static bool IsSameVec3(vec3f v1, vec3f v2)
+{
+	return (v1.x() == v2.x() && v1.y() == v2.y() && v1.z() == v2.z());
+}
+
+//////////////////////////////////////////////////////////
+// CLASS: Camera
+//////////////////////////////////////////////////////////
+
+Camera::Camera() :
+	m_position(0.0f, 0.0f, 0.0f),
+	m_target(0.0f, 0.0f, -1.0f),
+	m_up(0.0f, 1.0f, 0.0f),
+	m_projection(CAMERA_PERSPECTIVE),
+	m_fovYDegrees(60.0f),
+	m_orthoHeight(2.0f),
+	m_aspect(1.0f),
+	m_near(0.1f),
+	m_far(1000.0f),
+	m_bDepthZeroToOne(false),
+	m_dirtyFlags(DIRTY_VIEW | DIRTY_PROJ | DIRTY_VIEWPROJ)
+{
+}
+
+void Camera::SetLookAt(vec3f position, vec3f target, vec3f up)
+{
+	if (!IsSameVec3(position, m_position) || !IsSameVec3(target, m_target) || !IsSameVec3(up, m_up))
+	{
+		m_position = position;
+		m_target = target;
+		m_up = up;
+		Invalidate(DIRTY_VIEW);
+	}
+}
+
+void Camera::SetPosition(vec3f position)
+{
+	SetLookAt(position, m_target, m_up);
+}
+
+void Camera::SetTarget(vec3f target)
+{
+	SetLookAt(m_position, target, m_up);
+}
+
+void Camera::SetPerspective(float fFovYDegrees, float fAspect, float fNear, float fFar)
+{
+	if (m_projection != CAMERA_PERSPECTIVE || fFovYDegrees != m_fovYDegrees || fAspect != m_aspect || fNear != m_near || fFar != m_far)
+	{
+		m_projection = CAMERA_PERSPECTIVE;
+		m_fovYDegrees = fFovYDegrees;
+		m_aspect = fAspect;
+		m_near = fNear;
+		m_far = fFar;
+		Invalidate(DIRTY_PROJ);
+	}
+}
+
+void Camera::SetOrthographic(float fHeight, float fAspect, float fNear, float fFar)
+{
+	if (m_projection != CAMERA_ORTHOGRAPHIC || fHeight != m_orthoHeight || fAspect != m_aspect || fNear != m_near || fFar != m_far)
+	{
+		m_projection = CAMERA_ORTHOGRAPHIC;
+		m_orthoHeight = fHeight;
+		m_aspect = fAspect;
+		m_near = fNear;
+		m_far = fFar;
+		Invalidate(DIRTY_PROJ);
+	}
+}
+
+void Camera::SetAspect(float fAspect)
+{
+	if (fAspect != m_aspect)
+	{
+		m_aspect = fAspect;
+		Invalidate(DIRTY_PROJ);
+	}
+}
+
+void Camera::SetDepthZeroToOne(bool bDepthZeroToOne)
+{
+	if (bDepthZeroToOne != m_bDepthZeroToOne)
+	{
+		m_bDepthZeroToOne = bDepthZeroToOne;
+		Invalidate(DIRTY_PROJ);
+	}
+}
+
+void Camera::UpdateView() const
+{
+	m_view = mat44::GetMatrixLookAt(m_position, m_target, m_up);
+	m_viewInv = m_view.GetInverseRigid();
+	m_dirtyFlags &= ~DIRTY_VIEW;
+}
+
+void Camera::UpdateProj() const
+{
+	if (m_projection == CAMERA_PERSPECTIVE)
+	{
+		m_proj = mat44::GetMatrixPerspectiveD(m_fovYDegrees, m_aspect, m_near, m_far, m_bDepthZeroToOne);
+
+		// [a 0 0 0; 0 b 0 0; 0 0 c d; 0 0 -1 0]^-1 = [1/a 0 0 0; 0 1/b 0 0; 0 0 0 -1; 0 0 1/d c/d]
+		float c = m_proj[2][2], d = m_proj[2][3];
+		m_projInv = mat44
+		(
+			vec4f(1.0f / m_proj[0][0], 0.0f, 0.0f, 0.0f),
+			vec4f(0.0f, 1.0f / m_proj[1][1], 0.0f, 0.0f),
+			vec4f(0.0f, 0.0f, 0.0f, -1.0f),
+			vec4f(0.0f, 0.0f, 1.0f / d, c / d)
+		);
+	}
+	else
+	{
+		float half_height = 0.5f * m_orthoHeight;
+		float half_width = half_height * m_aspect;
+		m_proj = mat44::GetMatrixOrtho(-half_width, half_width, -half_height, half_height, m_near, m_far, m_bDepthZeroToOne);
+
+		// Scale & offset per axis: x' = s x + t  =>  x = (1/s) x' - t/s
+		m_projInv = MAT44_IDENTITY;
+		for (int r = 0; r < 3; r++)
+		{
+			m_projInv[r][r] = 1.0f / m_proj[r][r];
+			m_projInv[r][3] = -m_proj[r][3] / m_proj[r][r];
+		}
+	}
+	m_dirtyFlags &= ~DIRTY_PROJ;
+}
+
+void Camera::UpdateViewProj() const
+{
+	const mat44& view = GetView();
+	const mat44& proj = GetProj();
+	m_viewProj = proj * view;
+	m_viewProjInv = m_viewInv * m_projInv;
+	m_frustum.SetFromMatrix(m_viewProj, m_bDepthZeroToOne);
+	m_dirtyFlags &= ~DIRTY_VIEWPROJ;
+}
+
+const mat44& Camera::GetView() const
+{
+	if (m_dirtyFlags & DIRTY_VIEW)
+	{
+		UpdateView();
+	}
+	return m_view;
+}
+
+const mat44& Camera::GetViewInverse() const
+{
+	GetView();
+	return m_viewInv;
+}
+
+const mat44& Camera::GetProj() const
+{
+	if (m_dirtyFlags & DIRTY_PROJ)
+	{
+		UpdateProj();
+	}
+	return m_proj;
+}
+
+const mat44& Camera::GetProjInverse() const
+{
+	GetProj();
+	return m_projInv;
+}
+
+const mat44& Camera::GetViewProj() const
+{
+	if (m_dirtyFlags & DIRTY_VIEWPROJ)
+	{
+		UpdateViewProj();
+	}
+	return m_viewProj;
+}
+
+const mat44& Camera::GetViewProjInverse() const
+{
+	GetViewProj();
+	return m_viewProjInv;
+}
+
+const Frustum& Camera::GetFrustum() const
+{
+	GetViewProj();
+	return m_frustum;
+}
+
+mat44 Camera::GetModelViewProj(const mat44& matModel) const
+{
+	return GetViewProj() * matModel;
+}
+
+void Camera::GetModelViewProjs(const mat44* pModels, mat44* pResult, size_t count) const
+{
+	// Build the cache here, not on the worker threads
+	const mat44& view_proj = GetViewProj();
+	ParallelFor(count, CAMERA_BULK_GRAIN, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			pResult[i] = view_proj * pModels[i];
+		}
+	});
+}
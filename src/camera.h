@@ -0,0 +1,121 @@
+#pragma once
+#ifndef __CAMERA_H__
+#define __CAMERA_H__
+
+/**
+ *	FILE: camera.h
+ *	Look-at camera with a perspective or orthographic projection. The view,
+ *	projection & view-projection matrices (& their inverses & the frustum) are
+ *	cached & rebuilt only after a setter actually changes a parameter, so per-object
+ *	constants (GetModelViewProj()) cost one matrix product.
+ */
+
+// Includes: Standard
+#include <stddef.h>
+
+// Includes: Project
+#include "vec.h"
+#include "mat.h"
+#include "math3d.h"
+
+enum CameraProjection
+{
+	CAMERA_PERSPECTIVE = 0,
+	CAMERA_ORTHOGRAPHIC,
+};
+
+/**
+ *	CLASS: Camera
+ *	Conventions as mat44::GetMatrixLookAt()/GetMatrixPerspective(): column vectors,
+ *	right-handed, looking down -z in view space.
+ *	:NOTE: The getters rebuild the cache lazily, so they aren't thread-safe right after
+ *	a change; call GetViewProj() once before sharing the camera between threads.
+ */
+class Camera
+{
+protected:
+	///////////////////////////////////
+	// Properties
+	vec3f m_position;
+	vec3f m_target;
+	vec3f m_up;
+
+	CameraProjection m_projection;
+	float m_fovYDegrees;	// Perspective
+	float m_orthoHeight;	// Orthographic: view height in world units (width follows the aspect ratio)
+	float m_aspect;			// Width / height
+	float m_near;
+	float m_far;
+	bool m_bDepthZeroToOne;
+
+	// Cache
+	enum
+	{
+		DIRTY_VIEW		= 1 << 0,	// m_view & m_viewInv
+		DIRTY_PROJ		= 1 << 1,	// m_proj & m_projInv
+		DIRTY_VIEWPROJ	= 1 << 2,	// m_viewProj, m_viewProjInv & m_frustum
+	};
+	mutable unsigned m_dirtyFlags;
+	mutable mat44 m_view;
+	mutable mat44 m_viewInv;
+	mutable mat44 m_proj;
+	mutable mat44 m_projInv;
+	mutable mat44 m_viewProj;
+	mutable mat44 m_viewProjInv;
+	mutable Frustum m_frustum;
+
+public:
+	///////////////////////////////////
+	// Setup & Initialization
+	// Default: at the origin looking down -z, 60 degree perspective, aspect 1, depth [0.1, 1000]
+	Camera();
+
+	///////////////////////////////////
+	// Getter/Setters
+	vec3f GetPosition() const	{ return m_position; }
+	vec3f GetTarget() const		{ return m_target; }
+	vec3f GetUp() const			{ return m_up; }
+	CameraProjection GetProjection() const	{ return m_projection; }
+	float GetFovYDegrees() const	{ return m_fovYDegrees; }
+	float GetOrthoHeight() const	{ return m_orthoHeight; }
+	float GetAspect() const		{ return m_aspect; }
+	float GetNear() const		{ return m_near; }
+	float GetFar() const		{ return m_far; }
+
+	// Setters only invalidate the cache when a value changes
+	void SetLookAt(vec3f position, vec3f target, vec3f up);
+	void SetPosition(vec3f position);
+	void SetTarget(vec3f target);
+	void SetPerspective(float fFovYDegrees, float fAspect, float fNear, float fFar);
+	void SetOrthographic(float fHeight, float fAspect, float fNear, float fFar);
+	void SetAspect(float fAspect);
+	// Clip-space depth [0, w] (Direct3D) instead of [-w, w] (OpenGL)
+	void SetDepthZeroToOne(bool bDepthZeroToOne);
+
+	///////////////////////////////////
+	// Cached matrices
+	const mat44& GetView() const;
+	const mat44& GetViewInverse() const;
+	const mat44& GetProj() const;
+	const mat44& GetProjInverse() const;
+	const mat44& GetViewProj() const;
+	const mat44& GetViewProjInverse() const;
+	const Frustum& GetFrustum() const;
+
+	// Per-object constants: GetViewProj() * matModel
+	mat44 GetModelViewProj(const mat44& matModel) const;
+	// Bulk GetModelViewProj() (e.g. over TransformHierarchy::GetWorlds()); pResult may equal pModels
+	void GetModelViewProjs(const mat44* pModels, mat44* pResult, size_t count) const;
+
+protected:
+	void Invalidate(unsigned flags)
+	{
+		m_dirtyFlags |= flags | DIRTY_VIEWPROJ;
+	}
+
+	void UpdateView() const;
+	void UpdateProj() const;
+	void UpdateViewProj() const;
+};
+
+#endif // #ifndef __CAMERA_H__
@@ -1,20 +1,146 @@
 #include "curve.h"
 #include "math3d.h"
 
-const mat33 Bezier2DQuad::MAT_QUAD = mat33
-(
-	vec3f(1.0f, -2.0f, 1.0f),
-	vec3f(-2.0f, 2.0f, 0.0f),
-	vec3f(1.0f, 0.0f, 0.0f)
-);
-
-const mat44 Bezier2DCube::MAT_CUBE = mat44
-(
-	vec4f(-1.0f, 3.0f, -3.0f, 1.0f),
-	vec4f(3.0f, -1.0f, 3.0f, 0.0f),
-	vec4f(-3.0f, 3.0f, 0.0f, 0.0f),
-	vec4f(1.0f, 0.0f, 0.0f, 0.0f)
-	);
+// Includes: Standard
+#include <algorithm>
+
+// Basis matrices are defined in curve.h (constexpr); these are the out-of-class definitions
+constexpr mat33 Bezier2DQuad::MAT_QUAD;
+constexpr mat44 Bezier2DCube::MAT_CUBE;
+
+//////////////////////////////////////////////////////////
+// Flattening (shared by all Bezier types, templated on the point type)
+//////////////////////////////////////////////////////////
+
+/**
+ *	Wang's formula: number of uniform segments that keeps a degree-N Bezier within
+ *	fTolerance of its chords: sqrt(N(N-1)/8 * max|P[i] - 2P[i+1] + P[i+2]| / tol)
+ */
+template <class V, unsigned numControls>
+static int GetFlattenSegments(const V (&controls)[numControls], float fTolerance)
+{
+	const float degree = (float)(numControls - 1);
+
+	float max_diff = 0.0f;
+	for (unsigned i = 0; i + 2 < numControls; i++)
+	{
+		V v_diff = (controls[i] - (2.0f * controls[i + 1])) + controls[i + 2];
+		float mag_diff = v_diff.Mag();
+		if (mag_diff > max_diff)
+		{
+			max_diff = mag_diff;
+		}
+	}
+
+	float num_segments = ceilf(sqrtf((degree * (degree - 1.0f) * max_diff) / (8.0f * fTolerance)));
+	if (!(num_segments >= 1.0f))	// Also catches NaN
+	{
+		return 1;
+	}
+	return (num_segments < BEZIER_FLATTEN_MAX_SEGMENTS ? (int)num_segments : BEZIER_FLATTEN_MAX_SEGMENTS);
+}
+
+// de Casteljau split at t = 0.5
+template <class V, unsigned numControls>
+static void SplitBezier(const V (&controls)[numControls], V (&rLeft)[numControls], V (&rRight)[numControls])
+{
+	V points[numControls];
+	for (unsigned i = 0; i < numControls; i++)
+	{
+		points[i] = controls[i];
+	}
+
+	for (unsigned level = 0; level < numControls; level++)
+	{
+		rLeft[level] = points[0];
+		rRight[numControls - 1 - level] = points[numControls - 1 - level];
+		for (unsigned i = 0; i + level + 1 < numControls; i++)
+		{
+			points[i] = 0.5f * (points[i] + points[i + 1]);
+		}
+	}
+}
+
+// Forward differencing: numSegments uniform steps, appending every point after the first
+template <class V>
+static void FlattenUniform(const V (&controls)[3], int numSegments, std::vector<V>& rPoints)
+{
+	// B(t) = a t^2 + b t + p0
+	V a = (controls[0] - (2.0f * controls[1])) + controls[2];
+	V b = 2.0f * (controls[1] - controls[0]);
+
+	float h = 1.0f / numSegments;
+	V point = controls[0];
+	V diff1 = ((h * h) * a) + (h * b);
+	V diff2 = (2.0f * h * h) * a;
+
+	for (int i = 1; i < numSegments; i++)
+	{
+		point = point + diff1;
+		diff1 = diff1 + diff2;
+		rPoints.push_back(point);
+	}
+	rPoints.push_back(controls[2]);
+}
+
+template <class V>
+static void FlattenUniform(const V (&controls)[4], int numSegments, std::vector<V>& rPoints)
+{
+	// B(t) = a t^3 + b t^2 + c t + p0
+	V a = ((controls[3] - controls[0]) + (3.0f * (controls[1] - controls[2])));
+	V b = 3.0f * ((controls[0] - (2.0f * controls[1])) + controls[2]);
+	V c = 3.0f * (controls[1] - controls[0]);
+
+	float h = 1.0f / numSegments;
+	float h2 = h * h;
+	float h3 = h2 * h;
+	V point = controls[0];
+	V diff1 = ((h3 * a) + (h2 * b)) + (h * c);
+	V diff2 = ((6.0f * h3) * a) + ((2.0f * h2) * b);
+	V diff3 = (6.0f * h3) * a;
+
+	for (int i = 1; i < numSegments; i++)
+	{
+		point = point + diff1;
+		diff1 = diff1 + diff2;
+		diff2 = diff2 + diff3;
+		rPoints.push_back(point);
+	}
+	rPoints.push_back(controls[3]);
+}
+
+// Split while the two halves need fewer segments in total than the whole (curvature is uneven)
+template <class V, unsigned numControls>
+static void FlattenAdaptive(const V (&controls)[numControls], float fTolerance, int depth, std::vector<V>& rPoints)
+{
+	int num_segments = GetFlattenSegments(controls, fTolerance);
+	if (num_segments > 1 && depth < BEZIER_FLATTEN_MAX_DEPTH)
+	{
+		V left[numControls], right[numControls];
+		SplitBezier(controls, left, right);
+		if (GetFlattenSegments(left, fTolerance) + GetFlattenSegments(right, fTolerance) < num_segments)
+		{
+			FlattenAdaptive(left, fTolerance, depth + 1, rPoints);
+			FlattenAdaptive(right, fTolerance, depth + 1, rPoints);
+			return;
+		}
+	}
+
+	FlattenUniform(controls, num_segments, rPoints);
+}
+
+template <class V, unsigned numControls>
+static void FlattenBezier(const V (&controls)[numControls], float fTolerance, std::vector<V>& rPoints)
+{
+	// :NOTE: Tolerance is clamped so a 0 (or negative) tolerance can't divide by zero
+	if (!(fTolerance > 1.0e-6f))
+	{
+		fTolerance = 1.0e-6f;
+	}
+
+	rPoints.push_back(controls[0]);
+	FlattenAdaptive(controls, fTolerance, 0, rPoints);
+}
 
 Bezier2DQuad::Bezier2DQuad(vec2f p1, vec2f p2, vec2f p3)
 {
@@ -47,6 +173,11 @@ vec2f Bezier2DQuad::GetPoint(float t)
 	return vec_point;
 }
 
+void Bezier2DQuad::Flatten(float fTolerance, std::vector<vec2f>& rPoints) const
+{
+	FlattenBezier(m_controls, fTolerance, rPoints);
+}
+
 
 Bezier2DCube::Bezier2DCube(vec2f p1, vec2f p2, vec2f p3, vec2f p4)
 {
@@ -54,7 +185,7 @@ Bezier2DCube::Bezier2DCube(vec2f p1, vec2f p2, vec2f p3, vec2f p4)
 	m_controls[0] = p1;
 	m_controls[1] = p2;
 	m_controls[2] = p3;
-	m_controls[4] = p4;
+	m_controls[3] = p4;
 
 	// Store control values as X/Y vectors
 	m_controlX = vec4f(p1.x, p2.x, p3.x, p4.x);
@@ -68,4 +199,128 @@ vec2f Bezier2DCube::GetPoint(float t)
 
 	vec2f vec_point(vec4f::DotProduct(m_controlX, vec_t_cube), vec4f::DotProduct(m_controlY, vec_t_cube));
 	return vec_point;
-}
\ No newline at end of file
+}
+
+void Bezier2DCube::Flatten(float fTolerance, std::vector<vec2f>& rPoints) const
+{
+	FlattenBezier(m_controls, fTolerance, rPoints);
+}
+
+//////////////////////////////////////////////////////////
+// CLASS: BezierCurve3D
+//////////////////////////////////////////////////////////
+
+// 5-point Gauss-Legendre nodes & weights on [-1, 1]
+static const float GAUSS_NODES[5] = { 0.0f, -0.5384693101f, 0.5384693101f, -0.9061798459f, 0.9061798459f };
+static const float GAUSS_WEIGHTS[5] = { 0.5688888889f, 0.4786286705f, 0.4786286705f, 0.2369268851f, 0.2369268851f };
+
+void BezierCurve3D::BuildArcLengthTable() const
+{
+	m_arcLengths.resize(BEZIER_ARC_TABLE_SIZE + 1);
+	m_arcLengths[0] = 0.0f;
+
+	// Integrate |dP/dt| over each interval (exact up to degree 9 polynomials)
+	const float dt = 1.0f / BEZIER_ARC_TABLE_SIZE;
+	float length = 0.0f;
+	for (int i = 0; i < BEZIER_ARC_TABLE_SIZE; i++)
+	{
+		float t_mid = (i + 0.5f) * dt;
+		float length_interval = 0.0f;
+		for (int g = 0; g < 5; g++)
+		{
+			length_interval += GAUSS_WEIGHTS[g] * GetDerivative(t_mid + (0.5f * dt * GAUSS_NODES[g])).Mag();
+		}
+		length += 0.5f * dt * length_interval;
+		m_arcLengths[i + 1] = length;
+	}
+}
+
+float BezierCurve3D::GetLength() const
+{
+	if (m_arcLengths.empty())
+	{
+		BuildArcLengthTable();
+	}
+	return m_arcLengths.back();
+}
+
+float BezierCurve3D::GetParamAtDistance(float fDistance) const
+{
+	float length = GetLength();
+	if (!(fDistance > 0.0f))
+	{
+		return 0.0f;
+	}
+	if (fDistance >= length)
+	{
+		return 1.0f;
+	}
+
+	// First table entry past fDistance
+	int idx_high = (int)(std::upper_bound(m_arcLengths.begin(), m_arcLengths.end(), fDistance) - m_arcLengths.begin());
+	int idx_low = idx_high - 1;
+
+	float length_low = m_arcLengths[idx_low];
+	float length_interval = m_arcLengths[idx_high] - length_low;
+	float frac = (length_interval > 0.0f ? (fDistance - length_low) / length_interval : 0.0f);
+
+	return (idx_low + frac) / BEZIER_ARC_TABLE_SIZE;
+}
+
+//////////////////////////////////////////////////////////
+// CLASS: Bezier3DQuad
+//////////////////////////////////////////////////////////
+
+Bezier3DQuad::Bezier3DQuad(vec3f p1, vec3f p2, vec3f p3)
+{
+	m_controls[0] = p1;
+	m_controls[1] = p2;
+	m_controls[2] = p3;
+}
+
+vec3f Bezier3DQuad::GetPoint(float t) const
+{
+	float t_inv = 1.0f - t;
+	return ((t_inv * t_inv) * m_controls[0]) + ((2.0f * t * t_inv) * m_controls[1]) + ((t * t) * m_controls[2]);
+}
+
+vec3f Bezier3DQuad::GetDerivative(float t) const
+{
+	return (2.0f * (1.0f - t)) * (m_controls[1] - m_controls[0]) + (2.0f * t) * (m_controls[2] - m_controls[1]);
+}
+
+void Bezier3DQuad::Flatten(float fTolerance, std::vector<vec3f>& rPoints) const
+{
+	FlattenBezier(m_controls, fTolerance, rPoints);
+}
+
+//////////////////////////////////////////////////////////
+// CLASS: Bezier3DCube
+//////////////////////////////////////////////////////////
+
+Bezier3DCube::Bezier3DCube(vec3f p1, vec3f p2, vec3f p3, vec3f p4)
+{
+	m_controls[0] = p1;
+	m_controls[1] = p2;
+	m_controls[2] = p3;
+	m_controls[3] = p4;
+}
+
+vec3f Bezier3DCube::GetPoint(float t) const
+{
+	float t_inv = 1.0f - t;
+	return ((t_inv * t_inv * t_inv) * m_controls[0]) + ((3.0f * t * t_inv * t_inv) * m_controls[1])
+		 + ((3.0f * t * t * t_inv) * m_controls[2]) + ((t * t * t) * m_controls[3]);
+}
+
+vec3f Bezier3DCube::GetDerivative(float t) const
+{
+	float t_inv = 1.0f - t;
+	return ((3.0f * t_inv * t_inv) * (m_controls[1] - m_controls[0])) + ((6.0f * t * t_inv) * (m_controls[2] - m_controls[1]))
+		 + ((3.0f * t * t) * (m_controls[3] - m_controls[2]));
+}
+
+void Bezier3DCube::Flatten(float fTolerance, std::vector<vec3f>& rPoints) const
+{
+	FlattenBezier(m_controls, fTolerance, rPoints);
+}
@@ -1,5 +1,17 @@
+#pragma once
+#ifndef __CURVE_H__
+#define __CURVE_H__
+
+// Includes: Standard
+#include <vector>
+
+// Includes: Project
 #include "mat.h"
 
+// Flattening: max recursive (adaptive) splits of one curve, & max segments per curve
+#define BEZIER_FLATTEN_MAX_DEPTH		8
+#define BEZIER_FLATTEN_MAX_SEGMENTS	4096
+
 // CLASS: BezierCurve2D (ABSTRACT)
 // All Bezier curves will operate in the range of [0.0f,1.0f]
 // Any value in this range will return a 2D point.
@@ -7,6 +19,14 @@ class BezierCurve2D
 {
 public: 
 	virtual vec2f GetPoint(float t) =0;
+
+	/**
+	 *	Approximate the curve with a polyline no further than fTolerance from it
+	 *	(e.g. in pixels). Appends the start point, then each segment end point,
+	 *	to rPoints. Pieces are split adaptively where that saves segments, and each
+	 *	piece is stepped uniformly by forward differencing (no per-point GetPoint()).
+	 */
+	virtual void Flatten(float fTolerance, std::vector<vec2f>& rPoints) const =0;
 };
 
 
@@ -19,12 +39,19 @@ protected:
 	vec3f m_controlX;		// As x-values
 	vec3f m_controlY;		// As y-values
 
-	// Quadratic Multiplication Matrix
-	static const mat33 MAT_QUAD; 
 public:
+	// Quadratic Multiplication Matrix (rows: control points, columns: t^2, t, 1)
+	static constexpr mat33 MAT_QUAD = mat33
+	(
+		vec3f(1.0f, -2.0f, 1.0f),
+		vec3f(-2.0f, 2.0f, 0.0f),
+		vec3f(1.0f, 0.0f, 0.0f)
+	);
+
 	Bezier2DQuad(vec2f p1, vec2f p2, vec2f p3);
 
 	vec2f GetPoint(float t);
+	void Flatten(float fTolerance, std::vector<vec2f>& rPoints) const;
 };
 
 // CLASS: Bezier2DCube
@@ -36,21 +63,92 @@ protected:
 	vec4f m_controlX;		// As x-values
 	vec4f m_controlY;		// As y-values
 
-							// Quadratic Multiplication Matrix
-	static const mat44 MAT_CUBE;
 public:
+	// Cubic Multiplication Matrix (rows: control points, columns: t^3, t^2, t, 1)
+	static constexpr mat44 MAT_CUBE = mat44
+	(
+		vec4f(-1.0f, 3.0f, -3.0f, 1.0f),
+		vec4f(3.0f, -6.0f, 3.0f, 0.0f),
+		vec4f(-3.0f, 3.0f, 0.0f, 0.0f),
+		vec4f(1.0f, 0.0f, 0.0f, 0.0f)
+	);
+
 	Bezier2DCube(vec2f p1, vec2f p2, vec2f p3, vec2f p4);
 
 	vec2f GetPoint(float t);
+	void Flatten(float fTolerance, std::vector<vec2f>& rPoints) const;
 };
 
 ////////////////////////////////////////////////////////////////////
 
+// Arc-length table: number of uniform t intervals sampled
+#define BEZIER_ARC_TABLE_SIZE	128
+
 // CLASS: BezierCurve3D (ABSTRACT)
 // All Bezier curves will operate in the range of [0.0f,1.0f]
 // Any value in this range will return a 3D point.
+//
+// Also provides arc-length parameterization (constant speed motion) through a
+// table of cumulative lengths that is built on the first distance query.
+// :NOTE: The lazy build is not thread-safe; call GetLength() once up front if
+// the curve will be shared between threads.
 class BezierCurve3D
 {
+protected:
+	// m_arcLengths[i]: length of the curve from t = 0 to t = i / BEZIER_ARC_TABLE_SIZE
+	mutable std::vector<float> m_arcLengths;
+
 public:
-	virtual vec3f GetPoint(float t) = 0;
-};
\ No newline at end of file
+	virtual ~BezierCurve3D() {}
+
+	virtual vec3f GetPoint(float t) const = 0;
+	// First derivative dP/dt (tangent, not normalized)
+	virtual vec3f GetDerivative(float t) const = 0;
+	// See BezierCurve2D::Flatten()
+	virtual void Flatten(float fTolerance, std::vector<vec3f>& rPoints) const = 0;
+
+	// Arc length
+	float GetLength() const;
+	// Parameter t at which the curve has covered fDistance (clamped to [0, GetLength()]).
+	// O(log n) binary search in the table, then linear interpolation within the interval.
+	float GetParamAtDistance(float fDistance) const;
+	vec3f GetPointAtDistance(float fDistance) const
+	{
+		return GetPoint(GetParamAtDistance(fDistance));
+	}
+
+protected:
+	void BuildArcLengthTable() const;
+};
+
+// CLASS: Bezier3DQuad
+// 3D Bezier curve w/ 3 control points
+class Bezier3DQuad : public BezierCurve3D
+{
+protected:
+	vec3f m_controls[3];
+
+public:
+	Bezier3DQuad(vec3f p1, vec3f p2, vec3f p3);
+
+	vec3f GetPoint(float t) const;
+	vec3f GetDerivative(float t) const;
+	void Flatten(float fTolerance, std::vector<vec3f>& rPoints) const;
+};
+
+// CLASS: Bezier3DCube
+// 3D Bezier curve w/ 4 control points
+class Bezier3DCube : public BezierCurve3D
+{
+protected:
+	vec3f m_controls[4];
+
+public:
+	Bezier3DCube(vec3f p1, vec3f p2, vec3f p3, vec3f p4);
+
+	vec3f GetPoint(float t) const;
+	vec3f GetDerivative(float t) const;
+	void Flatten(float fTolerance, std::vector<vec3f>& rPoints) const;
+};
+
+#endif // #ifndef __CURVE_H__
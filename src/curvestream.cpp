@@ -0,0 +1,160 @@
+#include "curvestream.h"
+#include "simd.h"
+#include "parallel.h"
+
+// Below this many points per thread, batch evaluation stays on the calling thread
+#define CURVE_STREAM_GRAIN		(1 << 16)
+
+//////////////////////////////////////////////////////////
+// Basis helpers
+//////////////////////////////////////////////////////////
+
+// Bernstein weights of each control point at t
+static void GetBernsteinWeights(float t, float (&rWeights)[3])
+{
+	float t_inv = 1.0f - t;
+	rWeights[0] = t_inv * t_inv;
+	rWeights[1] = 2.0f * t * t_inv;
+	rWeights[2] = t * t;
+}
+
+static void GetBernsteinWeights(float t, float (&rWeights)[4])
+{
+	float t_inv = 1.0f - t;
+	rWeights[0] = t_inv * t_inv * t_inv;
+	rWeights[1] = 3.0f * t * t_inv * t_inv;
+	rWeights[2] = 3.0f * t * t * t_inv;
+	rWeights[3] = t * t * t;
+}
+
+// Power-basis coefficients of one axis, highest degree first (for Horner evaluation)
+static void GetPowerCoefficients(const float (&controls)[3], float (&rCoeffs)[3])
+{
+	rCoeffs[0] = (controls[0] - 2.0f * controls[1]) + controls[2];
+	rCoeffs[1] = 2.0f * (controls[1] - controls[0]);
+	rCoeffs[2] = controls[0];
+}
+
+static void GetPowerCoefficients(const float (&controls)[4], float (&rCoeffs)[4])
+{
+	rCoeffs[0] = (controls[3] - controls[0]) + 3.0f * (controls[1] - controls[2]);
+	rCoeffs[1] = 3.0f * ((controls[0] - 2.0f * controls[1]) + controls[2]);
+	rCoeffs[2] = 3.0f * (controls[1] - controls[0]);
+	rCoeffs[3] = controls[0];
+}
+
+// Batch kernels, one copy per instruction set (see simd_kernels.inl)
+#define SIMD_KERNEL_FILE "curvestream_kernels.inl"
+#include "simd_kernels.inl"
+
+//////////////////////////////////////////////////////////
+// CLASS: Bezier2DStream
+//////////////////////////////////////////////////////////
+
+template <unsigned numControls>
+Bezier2DStream<numControls>::Bezier2DStream(size_t size /*= 0*/) :
+	m_controlsX(size),
+	m_controlsY(size)
+{
+}
+
+template <unsigned numControls>
+void Bezier2DStream<numControls>::Resize(size_t size)
+{
+	m_controlsX.Resize(size);
+	m_controlsY.Resize(size);
+}
+
+template <unsigned numControls>
+void Bezier2DStream<numControls>::SetCurve(size_t idx, const vec2f (&controls)[numControls])
+{
+	for (unsigned k = 0; k < numControls; k++)
+	{
+		m_controlsX.Comp(k)[idx] = controls[k].x;
+		m_controlsY.Comp(k)[idx] = controls[k].y;
+	}
+}
+
+template <unsigned numControls>
+void Bezier2DStream<numControls>::GetCurve(size_t idx, vec2f (&rControls)[numControls]) const
+{
+	for (unsigned k = 0; k < numControls; k++)
+	{
+		rControls[k] = vec2f(m_controlsX.Comp(k)[idx], m_controlsY.Comp(k)[idx]);
+	}
+}
+
+template <unsigned numControls>
+vec2f Bezier2DStream<numControls>::GetPoint(size_t idx, float t) const
+{
+	float weights[numControls];
+	GetBernsteinWeights(t, weights);
+
+	const float* p_x[numControls];
+	const float* p_y[numControls];
+	for (unsigned k = 0; k < numControls; k++)
+	{
+		p_x[k] = m_controlsX.Comp(k) + idx;
+		p_y[k] = m_controlsY.Comp(k) + idx;
+	}
+
+	// Single-lane run of the batch kernel so both always agree
+	float point_x, point_y;
+	simd_base::KernelBezierAtT<SimdScalar>(weights, p_x, &point_x, 0, 1);
+	simd_base::KernelBezierAtT<SimdScalar>(weights, p_y, &point_y, 0, 1);
+	return vec2f(point_x, point_y);
+}
+
+template <unsigned numControls>
+void Bezier2DStream<numControls>::GetPoints(float t, vec2fStream& rResult) const
+{
+	float weights[numControls];
+	GetBernsteinWeights(t, weights);
+
+	size_t count = Size();
+	rResult.Resize(count);
+
+	const float* p_x[numControls];
+	const float* p_y[numControls];
+	for (unsigned k = 0; k < numControls; k++)
+	{
+		p_x[k] = m_controlsX.Comp(k);
+		p_y[k] = m_controlsY.Comp(k);
+	}
+	float* p_out_x = rResult.X();
+	float* p_out_y = rResult.Y();
+
+	ParallelFor(count, CURVE_STREAM_GRAIN, [&](size_t begin, size_t end)
+	{
+		SIMD_DISPATCH(KernelBezierAtT, (weights, p_x, p_out_x, begin, end));
+		SIMD_DISPATCH(KernelBezierAtT, (weights, p_y, p_out_y, begin, end));
+	});
+}
+
+template <unsigned numControls>
+void Bezier2DStream<numControls>::GetPoints(size_t idx, const float* pT, size_t count, vec2fStream& rResult) const
+{
+	float controls_x[numControls], controls_y[numControls];
+	for (unsigned k = 0; k < numControls; k++)
+	{
+		controls_x[k] = m_controlsX.Comp(k)[idx];
+		controls_y[k] = m_controlsY.Comp(k)[idx];
+	}
+
+	float coeffs_x[numControls], coeffs_y[numControls];
+	GetPowerCoefficients(controls_x, coeffs_x);
+	GetPowerCoefficients(controls_y, coeffs_y);
+
+	rResult.Resize(count);
+	float* p_out_x = rResult.X();
+	float* p_out_y = rResult.Y();
+
+	ParallelFor(count, CURVE_STREAM_GRAIN, [&](size_t begin, size_t end)
+	{
+		SIMD_DISPATCH(KernelBezierHorner, (coeffs_x, pT, p_out_x, begin, end));
+		SIMD_DISPATCH(KernelBezierHorner, (coeffs_y, pT, p_out_y, begin, end));
+	});
+}
+
+template class Bezier2DStream<3>;
+template class Bezier2DStream<4>;
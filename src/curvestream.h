@@ -0,0 +1,68 @@
+#pragma once
+#ifndef __CURVESTREAM_H__
+#define __CURVESTREAM_H__
+
+/**
+ *	FILE: curvestream.h
+ *	Structure-of-arrays (SoA) batches of 2D Bezier curves, evaluated with the
+ *	SIMD stream kernels instead of one virtual GetPoint() call per sample.
+ *
+ *	Every batch operation has a scalar path that produces bit-identical
+ *	results to the SSE/AVX2 paths (see simd.h for selecting the path).
+ */
+
+// Includes: Standard
+#include <stddef.h>
+
+// Includes: Project
+#include "vec.h"
+#include "vecstream.h"
+
+/**
+ *	CLASS: Bezier2DStream
+ *	Batch of 2D Bezier curves with numControls control points each
+ *	(3: quadratic, 4: cubic). Control point k of every curve is stored in
+ *	its own x & y arrays.
+ */
+template <unsigned numControls>
+class Bezier2DStream
+{
+protected:
+	///////////////////////////////////
+	// Properties
+	vecfStream<numControls> m_controlsX;	// Comp(k)[i]: x-value of control point k of curve i
+	vecfStream<numControls> m_controlsY;	// Comp(k)[i]: y-value of control point k of curve i
+
+public:
+	///////////////////////////////////
+	// Setup & Initialization
+	explicit Bezier2DStream(size_t size = 0);
+
+	///////////////////////////////////
+	// Getter/Setters
+	size_t Size() const
+	{
+		return m_controlsX.Size();
+	}
+
+	// Resize the batch; existing curves are preserved, new curves are all-zero
+	void Resize(size_t size);
+
+	void SetCurve(size_t idx, const vec2f (&controls)[numControls]);
+	void GetCurve(size_t idx, vec2f (&rControls)[numControls]) const;
+
+	///////////////////////////////////
+	// Evaluation
+	// Curve idx at t (same result as GetPoints(t, rResult))
+	vec2f GetPoint(size_t idx, float t) const;
+	// Every curve at the same t: point i of rResult is curve i (rResult is resized to Size())
+	void GetPoints(float t, vec2fStream& rResult) const;
+	// Curve idx at count values of t: point j of rResult is at pT[j] (rResult is resized to count).
+	// Evaluated in power form (Horner), so results may differ from GetPoint() in the last bits.
+	void GetPoints(size_t idx, const float* pT, size_t count, vec2fStream& rResult) const;
+};
+
+typedef Bezier2DStream<3> Bezier2DQuadStream;
+typedef Bezier2DStream<4> Bezier2DCubeStream;
+
+#endif // #ifndef __CURVESTREAM_H__
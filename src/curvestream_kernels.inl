@@ -0,0 +1,64 @@
+/**
+ *	FILE: curvestream_kernels.inl
+ *	curvestream.cpp's batch kernels; included by simd_kernels.inl, once per
+ *	instruction set.
+ */
+
+//////////////////////////////////////////////////////////
+// Kernels
+//////////////////////////////////////////////////////////
+
+// Many curves, one t: pOut[i] = sum of weights[k] * pControls[k][i] (one axis)
+template <class S, unsigned numControls>
+static void KernelBezierAtT(const float (&weights)[numControls], const float* const* pControls, float* pOut, size_t begin, size_t end)
+{
+	typename S::type weight_lanes[numControls];
+	for (unsigned k = 0; k < numControls; k++)
+	{
+		weight_lanes[k] = S::Set1(weights[k]);
+	}
+
+	size_t i = begin;
+	for (; i + S::WIDTH <= end; i += S::WIDTH)
+	{
+		typename S::type result = S::Mul(weight_lanes[0], S::Load(pControls[0] + i));
+		for (unsigned k = 1; k < numControls; k++)
+		{
+			result = S::Add(result, S::Mul(weight_lanes[k], S::Load(pControls[k] + i)));
+		}
+		S::Store(pOut + i, result);
+	}
+
+	if (i < end)
+	{
+		KernelBezierAtT<SimdScalar>(weights, pControls, pOut, i, end);
+	}
+}
+
+// One curve, many t: pOut[j] = polynomial(pT[j]) by Horner's method (one axis)
+template <class S, unsigned numControls>
+static void KernelBezierHorner(const float (&coeffs)[numControls], const float* pT, float* pOut, size_t begin, size_t end)
+{
+	typename S::type coeff_lanes[numControls];
+	for (unsigned k = 0; k < numControls; k++)
+	{
+		coeff_lanes[k] = S::Set1(coeffs[k]);
+	}
+
+	size_t i = begin;
+	for (; i + S::WIDTH <= end; i += S::WIDTH)
+	{
+		typename S::type t = S::Load(pT + i);
+		typename S::type result = coeff_lanes[0];
+		for (unsigned k = 1; k < numControls; k++)
+		{
+			result = S::Add(S::Mul(result, t), coeff_lanes[k]);
+		}
+		S::Store(pOut + i, result);
+	}
+
+	if (i < end)
+	{
+		KernelBezierHorner<SimdScalar>(coeffs, pT, pOut, i, end);
+	}
+}
@@ -0,0 +1,147 @@
+#include "geometry.h"
+#include "vecstream.h"
+#include "simd.h"
+#include "parallel.h"
+
+// Below this many rays per thread, batch tests stay on the calling thread
+#define GEOMETRY_BATCH_GRAIN	(1 << 14)
+
+//////////////////////////////////////////////////////////
+// CLASS: AABB
+//////////////////////////////////////////////////////////
+
+void AABB::Expand(vec3f p)
+{
+	for (int c = 0; c < 3; c++)
+	{
+		boundsMin[c] = (p[c] < boundsMin[c] ? p[c] : boundsMin[c]);
+		boundsMax[c] = (p[c] > boundsMax[c] ? p[c] : boundsMax[c]);
+	}
+}
+
+//////////////////////////////////////////////////////////
+// Kernels
+//////////////////////////////////////////////////////////
+
+// SoA view of a set of rays (a single ray points into its own vec3f components)
+struct RayLanes
+{
+	const float* pOrigin[3];
+	const float* pDir[3];
+	const float* pTMax;
+};
+
+// Batch kernels, one copy per instruction set (see simd_kernels.inl)
+#define SIMD_KERNEL_FILE "geometry_kernels.inl"
+#include "simd_kernels.inl"
+
+//////////////////////////////////////////////////////////
+// Single ray
+//////////////////////////////////////////////////////////
+
+static RayLanes GetRayLanes(const Ray& ray, const float* pTMax)
+{
+	RayLanes rays;
+	for (int c = 0; c < 3; c++)
+	{
+		rays.pOrigin[c] = ray.origin.Data() + c;
+		rays.pDir[c] = ray.dir.Data() + c;
+	}
+	rays.pTMax = pTMax;
+	return rays;
+}
+
+// Single-lane runs of the batch kernels so both always agree
+bool IntersectRayAABB(const Ray& ray, const AABB& box, float fTMax, float* pT)
+{
+	uint32_t hit = 0;
+	float t;
+	simd_base::KernelRayAABB<SimdScalar>(GetRayLanes(ray, &fTMax), box, &hit, &t, 0, 1);
+	if (hit != 0 && pT != NULL)
+	{
+		*pT = t;
+	}
+	return (hit != 0);
+}
+
+bool IntersectRaySphere(const Ray& ray, const Sphere& sphere, float fTMax, float* pT)
+{
+	uint32_t hit = 0;
+	float t;
+	simd_base::KernelRaySphere<SimdScalar>(GetRayLanes(ray, &fTMax), sphere, &hit, &t, 0, 1);
+	if (hit != 0 && pT != NULL)
+	{
+		*pT = t;
+	}
+	return (hit != 0);
+}
+
+bool IntersectRayTriangle(const Ray& ray, const Triangle& tri, float fTMax, float* pT)
+{
+	uint32_t hit = 0;
+	float t;
+	simd_base::KernelRayTriangle<SimdScalar>(GetRayLanes(ray, &fTMax), tri, &hit, &t, 0, 1);
+	if (hit != 0 && pT != NULL)
+	{
+		*pT = t;
+	}
+	return (hit != 0);
+}
+
+//////////////////////////////////////////////////////////
+// Batch
+//////////////////////////////////////////////////////////
+
+static RayLanes GetRayLanes(const vec3fStream& origins, const vec3fStream& dirs, const float* pTMax)
+{
+	RayLanes rays;
+	rays.pOrigin[0] = origins.X();
+	rays.pOrigin[1] = origins.Y();
+	rays.pOrigin[2] = origins.Z();
+	rays.pDir[0] = dirs.X();
+	rays.pDir[1] = dirs.Y();
+	rays.pDir[2] = dirs.Z();
+	rays.pTMax = pTMax;
+	return rays;
+}
+
+// Calls fnRange(begin, end) over chunks of rays, clearing their hit words first.
+// :NOTE: Split over whole output words so no two threads write the same word
+static void ForEachRayChunk(size_t count, uint32_t* pHit, const std::function<void(size_t, size_t)>& fnRange)
+{
+	ParallelFor(RAY_HIT_WORDS(count), GEOMETRY_BATCH_GRAIN / 32, [&](size_t wordBegin, size_t wordEnd)
+	{
+		for (size_t w = wordBegin; w < wordEnd; w++)
+		{
+			pHit[w] = 0;
+		}
+		fnRange(wordBegin * 32, (wordEnd * 32 < count ? wordEnd * 32 : count));
+	});
+}
+
+void IntersectRays(const vec3fStream& origins, const vec3fStream& dirs, const float* pTMax, const AABB& box, uint32_t* pHit, float* pT)
+{
+	RayLanes rays = GetRayLanes(origins, dirs, pTMax);
+	ForEachRayChunk(origins.Size(), pHit, [&](size_t begin, size_t end)
+	{
+		SIMD_DISPATCH(KernelRayAABB, (rays, box, pHit, pT, begin, end));
+	});
+}
+
+void IntersectRays(const vec3fStream& origins, const vec3fStream& dirs, const float* pTMax, const Sphere& sphere, uint32_t* pHit, float* pT)
+{
+	RayLanes rays = GetRayLanes(origins, dirs, pTMax);
+	ForEachRayChunk(origins.Size(), pHit, [&](size_t begin, size_t end)
+	{
+		SIMD_DISPATCH(KernelRaySphere, (rays, sphere, pHit, pT, begin, end));
+	});
+}
+
+void IntersectRays(const vec3fStream& origins, const vec3fStream& dirs, const float* pTMax, const Triangle& tri, uint32_t* pHit, float* pT)
+{
+	RayLanes rays = GetRayLanes(origins, dirs, pTMax);
+	ForEachRayChunk(origins.Size(), pHit, [&](size_t begin, size_t end)
+	{
+		SIMD_DISPATCH(KernelRayTriangle, (rays, tri, pHit, pT, begin, end));
+	});
+}
@@ -0,0 +1,149 @@
+#pragma once
+#ifndef __GEOMETRY_H__
+#define __GEOMETRY_H__
+
+/**
+ *	FILE: geometry.h
+ *	Basic primitives (Ray, AABB, Sphere, Triangle) & ray intersection tests.
+ *
+ *	The batch tests trace many rays (SoA, SIMD across rays) against one
+ *	primitive, e.g. the line-of-sight rays of every sentry/target pair against
+ *	one occluder. Single-ray tests run the same kernels on one lane, so both
+ *	always agree bit for bit.
+ *
+ *	Rays are segments: only hits with 0 <= t <= tMax count, at point
+ *	origin + t * dir (dir needn't be normalized; e.g. dir = target - origin
+ *	with tMax = 1 traces exactly up to the target).
+ */
+
+// Includes: Standard
+#include <stddef.h>
+#include <stdint.h>
+
+// Includes: Project
+#include "vec.h"
+
+class vec3fStream;
+
+// Words of hit bits for count rays (one bit per ray; same layout as VISIBILITY_WORDS in math3d.h)
+#define RAY_HIT_WORDS(count)	(((count) + 31) / 32)
+
+// :NOTE: Primitives keep plain public members (like vec2f) since they are just grouped values
+
+// STRUCT: Ray
+struct Ray
+{
+	vec3f origin;
+	vec3f dir;
+
+	Ray() {}
+	Ray(vec3f rayOrigin, vec3f rayDir) :
+		origin(rayOrigin),
+		dir(rayDir)
+	{
+	}
+
+	vec3f GetPoint(float t) const
+	{
+		return origin + (t * dir);
+	}
+};
+
+// STRUCT: AABB (axis-aligned bounding box)
+struct AABB
+{
+	vec3f boundsMin;
+	vec3f boundsMax;
+
+	AABB() {}
+	AABB(vec3f vMin, vec3f vMax) :
+		boundsMin(vMin),
+		boundsMax(vMax)
+	{
+	}
+
+	vec3f GetCenter() const
+	{
+		return 0.5f * (boundsMin + boundsMax);
+	}
+
+	vec3f GetExtent() const
+	{
+		return boundsMax - boundsMin;
+	}
+
+	bool Contains(vec3f p) const
+	{
+		return (p.x() >= boundsMin.x() && p.x() <= boundsMax.x() &&
+				p.y() >= boundsMin.y() && p.y() <= boundsMax.y() &&
+				p.z() >= boundsMin.z() && p.z() <= boundsMax.z());
+	}
+
+	bool Overlaps(const AABB& other) const
+	{
+		return (boundsMin.x() <= other.boundsMax.x() && boundsMax.x() >= other.boundsMin.x() &&
+				boundsMin.y() <= other.boundsMax.y() && boundsMax.y() >= other.boundsMin.y() &&
+				boundsMin.z() <= other.boundsMax.z() && boundsMax.z() >= other.boundsMin.z());
+	}
+
+	// Grow to include p
+	void Expand(vec3f p);
+};
+
+// STRUCT: Sphere
+struct Sphere
+{
+	vec3f center;
+	float radius;
+
+	Sphere() : radius(0.0f) {}
+	Sphere(vec3f sphereCenter, float fRadius) :
+		center(sphereCenter),
+		radius(fRadius)
+	{
+	}
+};
+
+// STRUCT: Triangle
+struct Triangle
+{
+	vec3f v0;
+	vec3f v1;
+	vec3f v2;
+
+	Triangle() {}
+	Triangle(vec3f p0, vec3f p1, vec3f p2) :
+		v0(p0),
+		v1(p1),
+		v2(p2)
+	{
+	}
+
+	// Not normalized; counter-clockwise winding faces it
+	vec3f GetNormal() const
+	{
+		return vec3f::CrossProduct(v1 - v0, v2 - v0);
+	}
+};
+
+///////////////////////////////////
+// Single ray
+/**
+ *	@param	ray		Ray
+ *	@param	fTMax	Furthest t that counts as a hit
+ *	@param	pT		Receives the first t of the hit (0 if the origin is inside). May be NULL.
+ *	@return	True if the ray hits within [0, fTMax]
+ */
+bool IntersectRayAABB(const Ray& ray, const AABB& box, float fTMax, float* pT);		// Slab test
+bool IntersectRaySphere(const Ray& ray, const Sphere& sphere, float fTMax, float* pT);
+bool IntersectRayTriangle(const Ray& ray, const Triangle& tri, float fTMax, float* pT);	// Moller-Trumbore, double-sided
+
+///////////////////////////////////
+// Batch: ray i = (origins[i], dirs[i]) up to pTMax[i]
+// pHit receives RAY_HIT_WORDS(origins.Size()) words: bit (i % 32) of word (i / 32) is set if
+// ray i hits. pT (optional, may be NULL) receives each ray's hit t (INFINITY on a miss).
+void IntersectRays(const vec3fStream& origins, const vec3fStream& dirs, const float* pTMax, const AABB& box, uint32_t* pHit, float* pT);
+void IntersectRays(const vec3fStream& origins, const vec3fStream& dirs, const float* pTMax, const Sphere& sphere, uint32_t* pHit, float* pT);
+void IntersectRays(const vec3fStream& origins, const vec3fStream& dirs, const float* pTMax, const Triangle& tri, uint32_t* pHit, float* pT);
+
+#endif // #ifndef __GEOMETRY_H__
@@ -0,0 +1,160 @@
+/**
+ *	FILE: geometry_kernels.inl
+ *	geometry.cpp's batch kernels; included by simd_kernels.inl, once per
+ *	instruction set.
+ */
+
+// Hit bits for the group at i, & hit t (INFINITY on a miss) if requested
+template <class S>
+static inline void StoreHits(typename S::mask hit, typename S::type t, uint32_t* pHit, float* pT, size_t i)
+{
+	pHit[i / 32] |= ((uint32_t)S::MoveMask(hit) << (i % 32));
+	if (pT != NULL)
+	{
+		S::Store(pT + i, S::Select(hit, t, S::Set1(INFINITY)));
+	}
+}
+
+// Slab test: the ray is inside the box between its latest slab entry & earliest slab exit
+template <class S>
+static void KernelRayAABB(const RayLanes& rays, const AABB& box, uint32_t* pHit, float* pT, size_t begin, size_t end)
+{
+	typedef typename S::type lane;
+	const lane zero = S::Set1(0.0f);
+	const lane one = S::Set1(1.0f);
+	const lane pos_inf = S::Set1(INFINITY);
+	const lane neg_inf = S::Set1(-INFINITY);
+
+	size_t i = begin;
+	for (; i + S::WIDTH <= end; i += S::WIDTH)
+	{
+		lane t_enter = zero;
+		lane t_exit = S::Load(rays.pTMax + i);
+		for (int c = 0; c < 3; c++)
+		{
+			lane origin = S::Load(rays.pOrigin[c] + i);
+			lane dir = S::Load(rays.pDir[c] + i);
+			lane slab_min = S::Set1(box.boundsMin[c]);
+			lane slab_max = S::Set1(box.boundsMax[c]);
+			lane dir_inv = S::Div(one, dir);
+			lane t1 = S::Mul(S::Sub(slab_min, origin), dir_inv);
+			lane t2 = S::Mul(S::Sub(slab_max, origin), dir_inv);
+
+			// :NOTE: A zero direction never crosses the slab: it is inside for every t or for none. Its slab
+			// times are set outright, since an origin on the slab plane would give 0 * inf = NaN & lose the hit
+			typename S::mask dir_zero = S::CmpLE(S::Abs(dir), zero);
+			typename S::mask in_slab = S::And(S::CmpLE(slab_min, origin), S::CmpLE(origin, slab_max));
+			lane t_near = S::Select(dir_zero, S::Select(in_slab, neg_inf, pos_inf), S::Min(t1, t2));
+			lane t_far = S::Select(dir_zero, S::Select(in_slab, pos_inf, neg_inf), S::Max(t1, t2));
+			t_enter = S::Max(t_enter, t_near);
+			t_exit = S::Min(t_exit, t_far);
+		}
+
+		StoreHits<S>(S::CmpLE(t_enter, t_exit), t_enter, pHit, pT, i);
+	}
+
+	if (i < end)
+	{
+		KernelRayAABB<SimdScalar>(rays, box, pHit, pT, i, end);
+	}
+}
+
+// Solve |o + t d - c|^2 = r^2 for its first root; an origin inside the sphere hits at t = 0
+template <class S>
+static void KernelRaySphere(const RayLanes& rays, const Sphere& sphere, uint32_t* pHit, float* pT, size_t begin, size_t end)
+{
+	typedef typename S::type lane;
+	const lane zero = S::Set1(0.0f);
+	const lane radius_sq = S::Set1(sphere.radius * sphere.radius);
+
+	size_t i = begin;
+	for (; i + S::WIDTH <= end; i += S::WIDTH)
+	{
+		lane oc[3], dir[3];
+		for (int c = 0; c < 3; c++)
+		{
+			oc[c] = S::Sub(S::Load(rays.pOrigin[c] + i), S::Set1(sphere.center[c]));
+			dir[c] = S::Load(rays.pDir[c] + i);
+		}
+
+		// a t^2 + 2 b t + c = 0
+		lane a = S::Add(S::Add(S::Mul(dir[0], dir[0]), S::Mul(dir[1], dir[1])), S::Mul(dir[2], dir[2]));
+		lane b = S::Add(S::Add(S::Mul(oc[0], dir[0]), S::Mul(oc[1], dir[1])), S::Mul(oc[2], dir[2]));
+		lane c = S::Sub(S::Add(S::Add(S::Mul(oc[0], oc[0]), S::Mul(oc[1], oc[1])), S::Mul(oc[2], oc[2])), radius_sq);
+		lane discriminant = S::Sub(S::Mul(b, b), S::Mul(a, c));
+
+		// :NOTE: Misses (negative discriminant, zero direction) give NaN here & fail every comparison
+		lane t_first = S::Div(S::Sub(S::Sub(zero, b), S::Sqrt(discriminant)), a);
+		typename S::mask inside = S::CmpLE(c, zero);
+		typename S::mask hit_outside = S::And(S::CmpLE(zero, t_first), S::CmpLE(t_first, S::Load(rays.pTMax + i)));
+		lane t = S::Select(inside, zero, t_first);
+
+		StoreHits<S>(S::Or(inside, hit_outside), t, pHit, pT, i);
+	}
+
+	if (i < end)
+	{
+		KernelRaySphere<SimdScalar>(rays, sphere, pHit, pT, i, end);
+	}
+}
+
+// Moller-Trumbore: solve o + t d = v0 + u e1 + v e2 by Cramer's rule
+template <class S>
+static void KernelRayTriangle(const RayLanes& rays, const Triangle& tri, uint32_t* pHit, float* pT, size_t begin, size_t end)
+{
+	typedef typename S::type lane;
+	const lane zero = S::Set1(0.0f);
+	const lane one = S::Set1(1.0f);
+
+	vec3f edge1 = tri.v1 - tri.v0;
+	vec3f edge2 = tri.v2 - tri.v0;
+	lane e1[3], e2[3];
+	for (int c = 0; c < 3; c++)
+	{
+		e1[c] = S::Set1(edge1[c]);
+		e2[c] = S::Set1(edge2[c]);
+	}
+
+	size_t i = begin;
+	for (; i + S::WIDTH <= end; i += S::WIDTH)
+	{
+		lane dir[3], s[3];
+		for (int c = 0; c < 3; c++)
+		{
+			dir[c] = S::Load(rays.pDir[c] + i);
+			s[c] = S::Sub(S::Load(rays.pOrigin[c] + i), S::Set1(tri.v0[c]));
+		}
+
+		// p = dir x e2, q = s x e1
+		lane p[3] =
+		{
+			S::Sub(S::Mul(dir[1], e2[2]), S::Mul(dir[2], e2[1])),
+			S::Sub(S::Mul(dir[2], e2[0]), S::Mul(dir[0], e2[2])),
+			S::Sub(S::Mul(dir[0], e2[1]), S::Mul(dir[1], e2[0]))
+		};
+		lane q[3] =
+		{
+			S::Sub(S::Mul(s[1], e1[2]), S::Mul(s[2], e1[1])),
+			S::Sub(S::Mul(s[2], e1[0]), S::Mul(s[0], e1[2])),
+			S::Sub(S::Mul(s[0], e1[1]), S::Mul(s[1], e1[0]))
+		};
+
+		lane det = S::Add(S::Add(S::Mul(e1[0], p[0]), S::Mul(e1[1], p[1])), S::Mul(e1[2], p[2]));
+		lane det_inv = S::Div(one, det);
+		lane u = S::Mul(S::Add(S::Add(S::Mul(s[0], p[0]), S::Mul(s[1], p[1])), S::Mul(s[2], p[2])), det_inv);
+		lane v = S::Mul(S::Add(S::Add(S::Mul(dir[0], q[0]), S::Mul(dir[1], q[1])), S::Mul(dir[2], q[2])), det_inv);
+		lane t = S::Mul(S::Add(S::Add(S::Mul(e2[0], q[0]), S::Mul(e2[1], q[1])), S::Mul(e2[2], q[2])), det_inv);
+
+		// :NOTE: Rays parallel to the triangle (det = 0) give inf/NaN barycentrics & fail below
+		typename S::mask hit = S::And(S::CmpLT(zero, S::Abs(det)), S::And(S::CmpLE(zero, u), S::CmpLE(zero, v)));
+		hit = S::And(hit, S::CmpLE(S::Add(u, v), one));
+		hit = S::And(hit, S::And(S::CmpLE(zero, t), S::CmpLE(t, S::Load(rays.pTMax + i))));
+
+		StoreHits<S>(hit, t, pHit, pT, i);
+	}
+
+	if (i < end)
+	{
+		KernelRayTriangle<SimdScalar>(rays, tri, pHit, pT, i, end);
+	}
+}
@@ -0,0 +1,167 @@
+#include "hierarchy.h"
+
+// Includes: Standard
+#include <algorithm>
+
+// Includes: Project
+#include "transform.h"
+#include "parallel.h"
+
+//////////////////////////////////////////////////////////
+// CLASS: TransformHierarchy
+//////////////////////////////////////////////////////////
+
+TransformHierarchy::TransformHierarchy() :
+	m_updateStamp(0)
+{
+}
+
+void TransformHierarchy::Reserve(size_t numNodes)
+{
+	m_parents.reserve(numNodes);
+	m_subtreeLast.reserve(numNodes);
+	m_locals.reserve(numNodes);
+	m_worlds.reserve(numNodes);
+	m_bDirty.reserve(numNodes);
+	m_updateStamps.reserve(numNodes);
+}
+
+void TransformHierarchy::Clear()
+{
+	m_parents.clear();
+	m_subtreeLast.clear();
+	m_locals.clear();
+	m_worlds.clear();
+	m_bDirty.clear();
+	m_updateStamps.clear();
+	m_dirtyNodes.clear();
+}
+
+uint32_t TransformHierarchy::AddNode(int32_t parent, const mat44& matLocal /*= MAT44_IDENTITY*/)
+{
+	uint32_t idx = (uint32_t)m_parents.size();
+	m_parents.push_back(parent < 0 ? HIERARCHY_NO_PARENT : parent);
+	m_subtreeLast.push_back(idx);
+	m_locals.push_back(matLocal);
+	m_worlds.push_back(matLocal);
+	m_bDirty.push_back(0);
+	m_updateStamps.push_back(0);
+
+	// The new node is the last one in every ancestor's subtree
+	for (int32_t ancestor = m_parents[idx]; ancestor != HIERARCHY_NO_PARENT; ancestor = m_parents[ancestor])
+	{
+		m_subtreeLast[ancestor] = idx;
+	}
+
+	SetLocal(idx, matLocal);
+	return idx;
+}
+
+void TransformHierarchy::SetLocal(uint32_t idx, const mat44& matLocal)
+{
+	m_locals[idx] = matLocal;
+	if (!m_bDirty[idx])
+	{
+		m_bDirty[idx] = 1;
+		m_dirtyNodes.push_back(idx);
+	}
+}
+
+void TransformHierarchy::SetLocal(uint32_t idx, const Transform& tfLocal)
+{
+	SetLocal(idx, tfLocal.GetMatrix());
+}
+
+void TransformHierarchy::UpdateRange(size_t begin, size_t end)
+{
+	const int32_t* p_parents = m_parents.data();
+	const mat44* p_locals = m_locals.data();
+	mat44* p_worlds = m_worlds.data();
+	uint8_t* p_dirty = m_bDirty.data();
+	uint32_t* p_stamps = m_updateStamps.data();
+	const uint32_t stamp = m_updateStamp;
+
+	for (size_t i = begin; i < end; i++)
+	{
+		// Recompute if the local changed or the parent was recomputed earlier in this sweep
+		// :NOTE: A parent recomputed by this update is always in the same sweep range (see UpdateWorld())
+		int32_t parent = p_parents[i];
+		bool b_parent_changed = (parent != HIERARCHY_NO_PARENT && p_stamps[parent] == stamp);
+		if (!p_dirty[i] && !b_parent_changed)
+		{
+			continue;
+		}
+
+		p_dirty[i] = 0;
+		p_stamps[i] = stamp;
+		if (parent == HIERARCHY_NO_PARENT)
+		{
+			p_worlds[i] = p_locals[i];
+		}
+		else
+		{
+			p_worlds[i] = p_worlds[parent] * p_locals[i];
+		}
+	}
+}
+
+/**
+ *	Sweeps [d, subtreeLast[d]] for each dirty node d, merging ranges that overlap. Every
+ *	node recomputed in a range descends from a dirty node in it, so no range reads a
+ *	matrix another range writes & the ranges run in parallel.
+ */
+void TransformHierarchy::UpdateWorld()
+{
+	if (m_dirtyNodes.empty())
+	{
+		return;
+	}
+
+	// :NOTE: After 2^32 updates a stale stamp can match again; that only recomputes a node needlessly
+	m_updateStamp++;
+	std::sort(m_dirtyNodes.begin(), m_dirtyNodes.end());
+
+	m_sweepStarts.clear();
+	m_sweepEnds.clear();
+	size_t num_nodes = 0;
+	for (size_t i = 0; i < m_dirtyNodes.size(); i++)
+	{
+		uint32_t node = m_dirtyNodes[i];
+		uint32_t end = m_subtreeLast[node] + 1;
+		if (!m_sweepEnds.empty() && node < m_sweepEnds.back())
+		{
+			if (end > m_sweepEnds.back())
+			{
+				num_nodes += end - m_sweepEnds.back();
+				m_sweepEnds.back() = end;
+			}
+		}
+		else
+		{
+			m_sweepStarts.push_back(node);
+			m_sweepEnds.push_back(end);
+			num_nodes += end - node;
+		}
+	}
+	m_dirtyNodes.clear();
+
+	size_t num_sweeps = m_sweepStarts.size();
+	if (num_nodes < HIERARCHY_PARALLEL_GRAIN || num_sweeps <= 1)
+	{
+		for (size_t k = 0; k < num_sweeps; k++)
+		{
+			UpdateRange(m_sweepStarts[k], m_sweepEnds[k]);
+		}
+		return;
+	}
+
+	// Roughly HIERARCHY_PARALLEL_GRAIN nodes per chunk (ranges vary in size; stealing evens it out)
+	size_t grain = std::max((size_t)1, num_sweeps * HIERARCHY_PARALLEL_GRAIN / num_nodes);
+	ParallelFor(num_sweeps, grain, [&](size_t sweepBegin, size_t sweepEnd)
+	{
+		for (size_t k = sweepBegin; k < sweepEnd; k++)
+		{
+			UpdateRange(m_sweepStarts[k], m_sweepEnds[k]);
+		}
+	});
+}
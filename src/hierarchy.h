@@ -0,0 +1,122 @@
+#pragma once
+#ifndef __HIERARCHY_H__
+#define __HIERARCHY_H__
+
+/**
+ *	FILE: hierarchy.h
+ *	Scene-graph transform hierarchy: local matrices, parent links & cached
+ *	world matrices (world = parent's world * local) in flat arrays.
+ *
+ *	Nodes are stored topologically sorted (every parent before its children), so
+ *	world matrices are recomputed in forward sweeps with no recursion & no pointer
+ *	chasing. Only the subtrees of nodes whose local matrix changed since the last
+ *	UpdateWorld() are swept: a frame where nothing moved costs nothing, & one
+ *	where a few nodes moved costs about their subtrees.
+ *
+ *	Adding children depth-first (a node's whole subtree before its next sibling)
+ *	keeps each subtree contiguous, which keeps the swept ranges tight.
+ */
+
+// Includes: Standard
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// Includes: Project
+#include "mat.h"
+
+class Transform;
+
+// Parent of a root node
+#define HIERARCHY_NO_PARENT			(-1)
+// Below this many nodes to recompute, UpdateWorld() stays on the calling thread
+#define HIERARCHY_PARALLEL_GRAIN	(1 << 12)
+
+/**
+ *	CLASS: TransformHierarchy
+ *	Dirty subtrees that don't overlap are independent & are swept in parallel.
+ *	:NOTE: Not thread-safe; don't modify the hierarchy during UpdateWorld().
+ */
+class TransformHierarchy
+{
+protected:
+	///////////////////////////////////
+	// Properties
+	std::vector<int32_t> m_parents;			// By node: parent index (< node) or HIERARCHY_NO_PARENT
+	std::vector<uint32_t> m_subtreeLast;	// By node: largest index in its subtree (itself if a leaf)
+	std::vector<mat44> m_locals;			// By node: relative to the parent
+	std::vector<mat44> m_worlds;			// By node: as of the last UpdateWorld()
+	std::vector<uint8_t> m_bDirty;			// By node: local changed since the last UpdateWorld()
+	std::vector<uint32_t> m_updateStamps;	// By node: last update that recomputed it (children follow)
+	uint32_t m_updateStamp;
+
+	std::vector<uint32_t> m_dirtyNodes;		// Nodes with m_bDirty set, in no particular order
+	std::vector<uint32_t> m_sweepStarts;	// UpdateWorld(): [start, end) node ranges to sweep
+	std::vector<uint32_t> m_sweepEnds;
+
+public:
+	///////////////////////////////////
+	// Setup & Initialization
+	TransformHierarchy();
+
+	void Reserve(size_t numNodes);
+	void Clear();
+
+	/**
+	 *	Append a node (dirty until the next UpdateWorld())
+	 *	@param	parent		Existing node, or HIERARCHY_NO_PARENT for a root
+	 *	@param	matLocal	Transform relative to the parent
+	 *	@return	index		The new node's index (Size() before the call)
+	 */
+	uint32_t AddNode(int32_t parent, const mat44& matLocal = MAT44_IDENTITY);
+
+	///////////////////////////////////
+	// Getter/Setters
+	size_t Size() const
+	{
+		return m_parents.size();
+	}
+
+	int32_t GetParent(uint32_t idx) const
+	{
+		return m_parents[idx];
+	}
+
+	const mat44& GetLocal(uint32_t idx) const
+	{
+		return m_locals[idx];
+	}
+
+	// Marks the node (& so its subtree) for recomputing
+	void SetLocal(uint32_t idx, const mat44& matLocal);
+	void SetLocal(uint32_t idx, const Transform& tfLocal);
+
+	// World matrix as of the last UpdateWorld()
+	const mat44& GetWorld(uint32_t idx) const
+	{
+		return m_worlds[idx];
+	}
+
+	// Every world matrix (Size() of them), by node
+	const mat44* GetWorlds() const
+	{
+		return m_worlds.data();
+	}
+
+	// Whether UpdateWorld() has anything to recompute
+	bool IsDirty() const
+	{
+		return !m_dirtyNodes.empty();
+	}
+
+	///////////////////////////////////
+	// Update
+	// Recompute the world matrices of dirty nodes & their descendants
+	void UpdateWorld();
+
+protected:
+	// Forward sweep over nodes [begin, end)
+	void UpdateRange(size_t begin, size_t end);
+};
+
+#endif // #ifndef __HIERARCHY_H__
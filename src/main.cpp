@@ -133,5 +133,5 @@ int main()
 
 
 	///////////////////////////////////////
-	while (true) {}
+	return 0;
 }
\ No newline at end of file
@@ -1,371 +1,312 @@
 #include "mat.h"
-
-// Includes: DEBUG
-#if defined _DEBUG
-#include <stdio.h>
-#endif
+#include "vecstream.h"
+#include "simd.h"
+#include "parallel.h"
 
 //////////////////////////////////////////////////////////
-// CLASS: mat33
-// DESCR: 3x3 matrix
+// CLASS: mat44
+// DESCR: 4x4 matrix (float specializations)
 //////////////////////////////////////////////////////////
 
-mat33::mat33(vec3f r0 /*= vec3f()*/, vec3f r1 /*= vec3f()*/, vec3f r2 /*= vec3f()*/) :
-	m_rows{ r0,r1,r2 }
-{
-}
-
-vec3f mat33::operator[](int idx) const
-{
-	return m_rows[idx];
-}
-
-vec3f& mat33::operator[](int idx)
-{
-	return m_rows[idx];
-}
-
-vec3f mat33::GetColumn(int idx) const
-{
-	vec3f vec_col;
-	for (int i = 0; i < 3; i++)
-	{
-		vec_col[i] = m_rows[i][idx];
-	}
-	return vec_col;
+#if defined SIMD_HAS_SSE
+// Shuffle helpers for the 2x2 block inverse (each __m128 holds a row-major 2x2 matrix)
+#define MAT_SHUFFLE(v1, v2, x, y, z, w)	_mm_shuffle_ps(v1, v2, _MM_SHUFFLE(w, z, y, x))
+#define MAT_SWIZZLE(v, x, y, z, w)		MAT_SHUFFLE(v, v, x, y, z, w)
+
+// 2x2 A * B
+static inline __m128 Mat2Mul(__m128 m1, __m128 m2)
+{
+	return _mm_add_ps(_mm_mul_ps(m1, MAT_SWIZZLE(m2, 0, 3, 0, 3)),
+					  _mm_mul_ps(MAT_SWIZZLE(m1, 1, 0, 3, 2), MAT_SWIZZLE(m2, 2, 1, 2, 1)));
+}
+
+// 2x2 adj(A) * B
+static inline __m128 Mat2AdjMul(__m128 m1, __m128 m2)
+{
+	return _mm_sub_ps(_mm_mul_ps(MAT_SWIZZLE(m1, 3, 3, 0, 0), m2),
+					  _mm_mul_ps(MAT_SWIZZLE(m1, 1, 1, 2, 2), MAT_SWIZZLE(m2, 2, 3, 0, 1)));
+}
+
+// 2x2 A * adj(B)
+static inline __m128 Mat2MulAdj(__m128 m1, __m128 m2)
+{
+	return _mm_sub_ps(_mm_mul_ps(m1, MAT_SWIZZLE(m2, 3, 0, 3, 0)),
+					  _mm_mul_ps(MAT_SWIZZLE(m1, 1, 0, 3, 2), MAT_SWIZZLE(m2, 2, 1, 2, 1)));
+}
+
+/**
+ *	SSE inverse using the 2x2 block form of the matrix:
+ *		M = | A B |		inv(M) = 1/|M| * | X Y |
+ *			| C D |						 | Z W |
+ *	where the 2x2 determinants |A| |B| |C| |D| & products adj(D)C, adj(A)B
+ *	are computed once and shared by every block.
+ */
+static float GetInverse_SSE(const float (&m)[4][4], float (&rInv)[4][4])
+{
+	__m128 row0 = _mm_loadu_ps(m[0]);
+	__m128 row1 = _mm_loadu_ps(m[1]);
+	__m128 row2 = _mm_loadu_ps(m[2]);
+	__m128 row3 = _mm_loadu_ps(m[3]);
+
+	// 2x2 sub-matrices
+	__m128 A = _mm_movelh_ps(row0, row1);
+	__m128 B = _mm_movehl_ps(row1, row0);
+	__m128 C = _mm_movelh_ps(row2, row3);
+	__m128 D = _mm_movehl_ps(row3, row2);
+
+	// Determinants as (|A| |B| |C| |D|)
+	__m128 det_sub = _mm_sub_ps(
+		_mm_mul_ps(MAT_SHUFFLE(row0, row2, 0, 2, 0, 2), MAT_SHUFFLE(row1, row3, 1, 3, 1, 3)),
+		_mm_mul_ps(MAT_SHUFFLE(row0, row2, 1, 3, 1, 3), MAT_SHUFFLE(row1, row3, 0, 2, 0, 2)));
+	__m128 det_A = MAT_SWIZZLE(det_sub, 0, 0, 0, 0);
+	__m128 det_B = MAT_SWIZZLE(det_sub, 1, 1, 1, 1);
+	__m128 det_C = MAT_SWIZZLE(det_sub, 2, 2, 2, 2);
+	__m128 det_D = MAT_SWIZZLE(det_sub, 3, 3, 3, 3);
+
+	__m128 adjD_C = Mat2AdjMul(D, C);
+	__m128 adjA_B = Mat2AdjMul(A, B);
+
+	// adj(X) = |D|A - B adj(D)C,  adj(W) = |A|D - C adj(A)B
+	__m128 X_ = _mm_sub_ps(_mm_mul_ps(det_D, A), Mat2Mul(B, adjD_C));
+	__m128 W_ = _mm_sub_ps(_mm_mul_ps(det_A, D), Mat2Mul(C, adjA_B));
+	// adj(Y) = |B|C - D adj(adj(A)B),  adj(Z) = |C|B - A adj(adj(D)C)
+	__m128 Y_ = _mm_sub_ps(_mm_mul_ps(det_B, C), Mat2MulAdj(D, adjA_B));
+	__m128 Z_ = _mm_sub_ps(_mm_mul_ps(det_C, B), Mat2MulAdj(A, adjD_C));
+
+	// |M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C)
+	__m128 det_M = _mm_add_ps(_mm_mul_ps(det_A, det_D), _mm_mul_ps(det_B, det_C));
+	__m128 tr = _mm_mul_ps(adjA_B, MAT_SWIZZLE(adjD_C, 0, 2, 1, 3));
+	tr = _mm_add_ps(tr, _mm_movehl_ps(tr, tr));
+	tr = _mm_add_ss(tr, MAT_SWIZZLE(tr, 1, 1, 1, 1));
+	det_M = _mm_sub_ps(det_M, MAT_SWIZZLE(tr, 0, 0, 0, 0));
+
+	// (1/|M|, -1/|M|, -1/|M|, 1/|M|) applies the final adjugate signs
+	__m128 inv_det_M = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det_M);
+	X_ = _mm_mul_ps(X_, inv_det_M);
+	Y_ = _mm_mul_ps(Y_, inv_det_M);
+	Z_ = _mm_mul_ps(Z_, inv_det_M);
+	W_ = _mm_mul_ps(W_, inv_det_M);
+
+	// Adjugate shuffle combined with the store shuffle
+	_mm_storeu_ps(rInv[0], MAT_SHUFFLE(X_, Y_, 3, 1, 3, 1));
+	_mm_storeu_ps(rInv[1], MAT_SHUFFLE(X_, Y_, 2, 0, 2, 0));
+	_mm_storeu_ps(rInv[2], MAT_SHUFFLE(Z_, W_, 3, 1, 3, 1));
+	_mm_storeu_ps(rInv[3], MAT_SHUFFLE(Z_, W_, 2, 0, 2, 0));
+
+	return _mm_cvtss_f32(det_M);
 }
+#endif
 
-mat33 mat33::GetTranspose() const
+template <>
+bool mat44::TryGetInverse(mat44& rMatResult, float fEpsilon /*= MAT_SINGULAR_EPSILON*/, float* pDeterminant /*= NULL*/) const
 {
-	mat33 mat_transpose;
-
-	for (int r = 0; r < 3; r++)
+	mat44 mat_inv;
+	float mat_determinant;
+#if defined SIMD_HAS_SSE
+	if (GetSimdLevel() >= SIMD_SSE)
 	{
-		for (int c = 0; c < 3; c++)
+		float m[4][4], inv[4][4];
+		for (int r = 0; r < 4; r++)
 		{
-			mat_transpose[r][c] = m_rows[c][r];
+			for (int c = 0; c < 4; c++)
+			{
+				m[r][c] = m_rows[r][c];
+			}
 		}
-	}
-
-	return mat_transpose;
-}
-
-// Calculate determinant using the triple product
-float mat33::GetDeterminant() const
-{
-	vec3f cross_vec = vec3f::CrossProduct(m_rows[0], m_rows[1]);
-	return vec3f::DotProduct(cross_vec, m_rows[2]);
-}
-
-// Operator+: mat33 + mat33
-mat33 operator+(const mat33 m1, const mat33 m2)
-{
-	return mat33(m1[0] + m2[0], m1[1] + m2[1], m1[2] + m2[2]);
-}
-
-// Operator-: mat33 - mat33
-mat33 operator-(const mat33 m1, const mat33 m2)
-{
-	return mat33(m1[0] - m2[0], m1[1] - m2[1], m1[2] - m2[2]);
-}
-
-// Operator*: fScalar * mat33
-mat33 operator*(const float fScalar, const mat33 mat)
-{
-	return mat33(fScalar * mat[0], fScalar * mat[1], fScalar * mat[2]);
-}
-
-// Operator*: 3x3 matrix  * column vec3 = column vec3
-vec3f operator*(const mat33 m1, const vec3f v1)
-{
-	return vec3f
-		(
-			vec3f::DotProduct(v1, m1[0]),
-			vec3f::DotProduct(v1, m1[1]),
-			vec3f::DotProduct(v1, m1[2])
-			);
-}
-
-mat33 operator*(const mat33 m1, const mat33 m2)
-{
-	mat33 mat_result;
-
-	// Column-first so we only have to construct the column vectors 4 times
-	for (int c = 0; c < 4; c++)
-	{
-		vec3f col_curr = m2.GetColumn(c);
 
+		mat_determinant = GetInverse_SSE(m, inv);
 		for (int r = 0; r < 4; r++)
 		{
-			mat_result[r][c] = vec3f::DotProduct(m1[r], col_curr);
+			mat_inv[r] = vec4f(inv[r][0], inv[r][1], inv[r][2], inv[r][3]);
 		}
 	}
-
-	return mat_result;
-}
-
-void mat33::Print() const
-{
-	printf("==================================\n");
-	for (int r = 0; r < 3; r++)
+	else
+#endif
 	{
-		printf("|%5f %5f %5f|\n", m_rows[r][0], m_rows[r][1], m_rows[r][2]);
+		mat_determinant = matInverse(*this, mat_inv);
 	}
-	printf("==================================\n");
-}
 
-//////////////////////////////////////////////////////////
-// CLASS: mat44
-// DESCR: 4x4 matrix
-//////////////////////////////////////////////////////////
+	if (pDeterminant != NULL)
+	{
+		*pDeterminant = mat_determinant;
+	}
 
-#if defined MAT_ROWS
-mat44::mat44(vec4f r0 /*= vec4f()*/, vec4f r1 /*= vec4f()*/, vec4f r2 /*= vec4f()*/, vec4f r3 /*= vec4f()*/) :
-	m_rows{ r0,r1,r2,r3 }
-{
-}
+	bool b_inverse_exists = (fabsf(mat_determinant) > fEpsilon);
+	if (b_inverse_exists)
+	{
+		rMatResult = mat_inv;
+	}
 
-vec4f mat44::operator[](int idx) const
-{
-	return m_rows[idx];
+	return b_inverse_exists;
 }
 
-vec4f& mat44::operator[](int idx)
-{
-	return m_rows[idx];
-}
+// BULK TRANSFORMS
 
-vec4f mat44::GetColumn(int idx) const
-{
-	vec4f vec_col;
-	for (int i = 0; i < 4; i++)
-	{
-		vec_col[i] = m_rows[i][idx];
-	}
-	return vec_col;
-}
+// Below this many vectors per thread, bulk transforms stay on the calling thread
+#define MAT_TRANSFORM_GRAIN		(1 << 16)
 
+static_assert(sizeof(vec3f) == 3 * sizeof(float), "Bulk transforms assume tightly packed vec3f");
+static_assert(sizeof(vec4f) == 4 * sizeof(float), "Bulk transforms assume tightly packed vec4f");
 
-mat44 mat44::GetTranspose() const
+/**
+ *	AoS kernel (scalar): each row computes ((m0*x + m1*y) + m2*z) + m3*w, which is the
+ *	same sequence of operations as operator*(mat44, vec4f). For 3-component input
+ *	w is implied: 1 for points (bPoint), 0 for directions (term skipped).
+ */
+template <unsigned numComps, bool bPoint>
+static void TransformAoS_Scalar(const float (&m)[4][4], const float* pIn, float* pOut, size_t begin, size_t end)
 {
-	mat44 mat_transpose;
-
-	for (int r = 0; r < 4; r++)
+	for (size_t i = begin; i < end; i++)
 	{
-		for (int c = 0; c < 4; c++)
+		const float* p_in = pIn + (i * numComps);
+		float vec_in[4] = { p_in[0], p_in[1], p_in[2], (numComps == 4 ? p_in[3] : 1.0f) };
+
+		float* p_out = pOut + (i * numComps);
+		for (unsigned r = 0; r < numComps; r++)
 		{
-			mat_transpose[r][c] = m_rows[c][r];
+			float val = ((m[r][0] * vec_in[0]) + (m[r][1] * vec_in[1])) + (m[r][2] * vec_in[2]);
+			if (numComps == 4)
+			{
+				val += (m[r][3] * vec_in[3]);
+			}
+			else if (bPoint)
+			{
+				val += m[r][3];
+			}
+			p_out[r] = val;
 		}
 	}
-
-	return mat_transpose;
 }
 
-// Retrieve minor matrix for specified indices (drop the row & column specified)
-mat33 mat44::GetMinor(int row, int col) const
+#if defined SIMD_HAS_SSE
+/**
+ *	AoS kernel (SSE): matrix columns stay in registers and each vector is
+ *	result = c0*x + c1*y + c2*z (+ c3*w), one vector per iteration.
+ */
+template <unsigned numComps, bool bPoint>
+static void TransformAoS_SSE(const float (&m)[4][4], const float* pIn, float* pOut, size_t begin, size_t end)
 {
-	mat33 minor_mat;
+	__m128 col0 = _mm_setr_ps(m[0][0], m[1][0], m[2][0], m[3][0]);
+	__m128 col1 = _mm_setr_ps(m[0][1], m[1][1], m[2][1], m[3][1]);
+	__m128 col2 = _mm_setr_ps(m[0][2], m[1][2], m[2][2], m[3][2]);
+	__m128 col3 = _mm_setr_ps(m[0][3], m[1][3], m[2][3], m[3][3]);
 
-	int minor_r = 0;
-	for (int r = 0; r < 4; r++)
+	for (size_t i = begin; i < end; i++)
 	{
-		// Skip to next iteration if we're in a cut row
-		if (r == row)
+		const float* p_in = pIn + (i * numComps);
+		float* p_out = pOut + (i * numComps);
+
+		if (numComps == 4)
 		{
-			continue;
+			__m128 vec_in = _mm_loadu_ps(p_in);
+			__m128 result = _mm_add_ps(_mm_mul_ps(col0, _mm_shuffle_ps(vec_in, vec_in, _MM_SHUFFLE(0, 0, 0, 0))),
+									   _mm_mul_ps(col1, _mm_shuffle_ps(vec_in, vec_in, _MM_SHUFFLE(1, 1, 1, 1))));
+			result = _mm_add_ps(result, _mm_mul_ps(col2, _mm_shuffle_ps(vec_in, vec_in, _MM_SHUFFLE(2, 2, 2, 2))));
+			result = _mm_add_ps(result, _mm_mul_ps(col3, _mm_shuffle_ps(vec_in, vec_in, _MM_SHUFFLE(3, 3, 3, 3))));
+			_mm_storeu_ps(p_out, result);
 		}
-
-		int minor_c = 0;
-		for (int c = 0; c < 4; c++)
+		else
 		{
-			// Skip to next iteration if we're in a cut col
-			if (c == col)
+			// :NOTE: Scalar loads so we never read past the end of a tightly packed vec3f array
+			__m128 result = _mm_add_ps(_mm_mul_ps(col0, _mm_set1_ps(p_in[0])), _mm_mul_ps(col1, _mm_set1_ps(p_in[1])));
+			result = _mm_add_ps(result, _mm_mul_ps(col2, _mm_set1_ps(p_in[2])));
+			if (bPoint)
 			{
-				continue;
+				result = _mm_add_ps(result, col3);
 			}
-			minor_mat[minor_r][minor_c] = m_rows[r][c];
-			minor_c++;
+			_mm_storel_pi((__m64*)p_out, result);
+			_mm_store_ss(p_out + 2, _mm_movehl_ps(result, result));
 		}
-		minor_r++;
 	}
-
-	return minor_mat;
 }
+#endif
 
-mat44 mat44::GetCofactorsMatrix() const
+template <unsigned numComps, bool bPoint>
+static void TransformAoS(const mat44& mat, const float* pIn, float* pOut, size_t count)
 {
-	mat44 mat_cofactors;
-
-	for (int c = 0; c < 4; c++)
+	float m[4][4];
+	for (int r = 0; r < 4; r++)
 	{
-		for (int r = 0; r < 4; r++)
+		for (int c = 0; c < 4; c++)
 		{
-			mat33 mat_minor = GetMinor(r, c);
-			mat_cofactors[r][c] = pow(-1, r + c) * mat_minor.GetDeterminant();
+			m[r][c] = mat[r][c];
 		}
 	}
 
-	return mat_cofactors;
-}
-
-float mat44::GetDeterminant() const
-{
-	float result = 0.0f;
-
-	// Default: Use row 0 :TODO: Maybe make adjustable somewhat?
-	int r = 0;
-
-	float sign;
-	for (int c = 0; c < 4; c++)
+	ParallelFor(count, MAT_TRANSFORM_GRAIN, [&](size_t begin, size_t end)
 	{
-		// Determine sign
-		sign = pow(-1, r + c); //(((r + c) % 2) == 0 ? 1.0f : -1.0f);
-
-		mat33 mat_minor = GetMinor(r, c);
-
-		result += (sign * m_rows[r][c] * mat_minor.GetDeterminant());
-	}
-	return result;
-}
-
-bool mat44::TryGetInverse(mat44& rMatResult) const
-{
-	float mat_determinant = GetDeterminant();
-	bool b_inverse_exists = (mat_determinant != 0.0f); // :TODO: Add float safety
-
-	if (b_inverse_exists)
-	{
-		rMatResult = ((1.0f / mat_determinant) * (GetCofactorsMatrix().GetTranspose()));
-	}
-
-	return b_inverse_exists;
-}
-
-// Operator+: mat44 + mat44
-mat44 operator+(const mat44 m1, const mat44 m2)
-{
-	return mat44(m1[0] + m2[0], m1[1] + m2[1], m1[2] + m2[2], m1[3] + m2[3]);
-}
-
-// Operator-: mat44 - mat44
-mat44 operator-(const mat44 m1, const mat44 m2)
-{
-	return mat44(m1[0] - m2[0], m1[1] - m2[1], m1[2] - m2[2], m1[3] - m2[3]);
-}
-
-// Operator*: fScalar * mat44
-mat44 operator*(const float fScalar, const mat44 mat)
-{
-	return mat44(fScalar * mat[0], fScalar * mat[1], fScalar * mat[2], fScalar * mat[3]);
+#if defined SIMD_HAS_SSE
+		if (GetSimdLevel() >= SIMD_SSE)
+		{
+			TransformAoS_SSE<numComps, bPoint>(m, pIn, pOut, begin, end);
+			return;
+		}
+#endif
+		TransformAoS_Scalar<numComps, bPoint>(m, pIn, pOut, begin, end);
+	});
 }
 
-// Operator*: 4x4 matrix  * column vec4 = column vec4
-vec4f operator*(const mat44 m1, const vec4f v1)
-{
-	return vec4f
-	(
-		vec4f::DotProduct(v1, m1[0]),
-		vec4f::DotProduct(v1, m1[1]),
-		vec4f::DotProduct(v1, m1[2]),
-		vec4f::DotProduct(v1, m1[3])
-	);
-}
+// Batch kernels, one copy per instruction set (see simd_kernels.inl)
+#define SIMD_KERNEL_FILE "mat_kernels.inl"
+#include "simd_kernels.inl"
 
-mat44 operator*(const mat44 m1, const mat44 m2)
+template <bool bPoint>
+static void TransformSoA(const mat44& mat, const vec3fStream& vecs, vec3fStream& rResult)
 {
-	mat44 mat_result;
-
-	// Column-first so we only have to construct the column vectors 4 times
-	for (int c = 0; c < 4; c++)
+	float m[4][4];
+	for (int r = 0; r < 4; r++)
 	{
-		vec4f col_curr = m2.GetColumn(c);
-
-		for (int r = 0; r < 4; r++)
+		for (int c = 0; c < 4; c++)
 		{
-			mat_result[r][c] = vec4f::DotProduct(m1[r], col_curr);
+			m[r][c] = mat[r][c];
 		}
 	}
 
-	return mat_result;
-}
-
+	size_t count = vecs.Size();
+	rResult.Resize(count);
 
-// 3D MANIPULATION
+	const float* p_in[3] = { vecs.X(), vecs.Y(), vecs.Z() };
+	float* p_out[3] = { rResult.X(), rResult.Y(), rResult.Z() };
 
-mat44 mat44::GetMatrixScale(float fScale)
-{
-	mat44 mat_scale = MAT44_IDENTITY;
-
-	// Set the X/Y/Z diagonal values to desired scale value
-	for (int i = 0; i < 3; i++)
+	ParallelFor(count, MAT_TRANSFORM_GRAIN, [&](size_t begin, size_t end)
 	{
-		mat_scale[i][i] = fScale;
-	}
-
-	return mat_scale;
+		if (bPoint)
+		{
+			SIMD_DISPATCH(KernelTransformPointsSoA, (m, p_in, p_out, begin, end));
+		}
+		else
+		{
+			SIMD_DISPATCH(KernelTransformDirsSoA, (m, p_in, p_out, begin, end));
+		}
+	});
 }
 
-mat44 mat44::GetMatrixRotXD(float fRotXDegrees)
+template <>
+void mat44::TransformPoints(const vec3f* pPoints, vec3f* pResult, size_t count) const
 {
-	mat44 mat_rot = MAT44_IDENTITY;
-
-	float rot_rad	= DegreesToRadians(fRotXDegrees);
-	float f_cos		= cos(rot_rad);
-	float f_sin		= sin(rot_rad);
-
-	mat_rot[1][1] = f_cos;
-	mat_rot[2][2] = f_cos;
-	mat_rot[1][2] = -f_sin;
-	mat_rot[2][1] = f_sin;
-	
-	return mat_rot;
+	TransformAoS<3, true>(*this, reinterpret_cast<const float*>(pPoints), reinterpret_cast<float*>(pResult), count);
 }
 
-mat44 mat44::GetMatrixRotYD(float fRotYDegrees)
+template <>
+void mat44::TransformDirections(const vec3f* pDirs, vec3f* pResult, size_t count) const
 {
-	mat44 mat_rot = MAT44_IDENTITY;
-
-	float rot_rad = DegreesToRadians(fRotYDegrees);
-	float f_cos = cos(rot_rad);
-	float f_sin = sin(rot_rad);
-
-	mat_rot[0][0] = f_cos;
-	mat_rot[2][2] = f_cos;
-	mat_rot[0][2] = f_sin;
-	mat_rot[2][0] = -f_sin;
-
-	return mat_rot;
+	TransformAoS<3, false>(*this, reinterpret_cast<const float*>(pDirs), reinterpret_cast<float*>(pResult), count);
 }
 
-mat44 mat44::GetMatrixRotZD(float fRotZDegrees)
+template <>
+void mat44::TransformVectors(const vec4f* pVecs, vec4f* pResult, size_t count) const
 {
-	mat44 mat_rot = MAT44_IDENTITY;
-
-	float rot_rad = DegreesToRadians(fRotZDegrees);
-	float f_cos = cos(rot_rad);
-	float f_sin = sin(rot_rad);
-
-	mat_rot[0][0] = f_cos;
-	mat_rot[1][1] = f_cos;
-	mat_rot[0][1] = -f_sin;
-	mat_rot[1][0] = f_sin;
-
-	return mat_rot;
+	TransformAoS<4, true>(*this, reinterpret_cast<const float*>(pVecs), reinterpret_cast<float*>(pResult), count);
 }
 
-void mat44::Print() const
+template <>
+void mat44::TransformPoints(const vec3fStream& points, vec3fStream& rResult) const
 {
-	printf("==================================\n");
-	for (int r = 0; r < 4; r++)
-	{
-		printf("|%5f %5f %5f %5f|\n", m_rows[r][0], m_rows[r][1], m_rows[r][2], m_rows[r][3]);
-	}
-	printf("==================================\n");
+	TransformSoA<true>(*this, points, rResult);
 }
 
-#else	// MAT_COLS
-mat44::mat44(vec4f c0 /*= vec4f()*/, vec4f c1 /*= vec4f()*/ , vec4f c2 /*= vec4f()*/ , vec4f c3 /*= vec4f()*/ ) :
-	m_cols{ c0,c1,c2,c3 }
+template <>
+void mat44::TransformDirections(const vec3fStream& dirs, vec3fStream& rResult) const
 {
+	TransformSoA<false>(*this, dirs, rResult);
 }
-#endif
\ No newline at end of file
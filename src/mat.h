@@ -7,128 +7,905 @@
 *	FILE: mat.h
 *	3x3 & 4x4 fp matrix implementations.
 *	Written to study/reinforce 3D math knowledge.
+*
+*	Generic mat<T, numRows, numCols> template; mat33/mat44 (float) and
+*	mat33d/mat44d (double) are typedefs. Accessors, operators & builders
+*	are inline/constexpr; the mat44 SSE inverse & bulk transforms live in
+*	mat.cpp.
 */
 
 #include <math.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <type_traits>
+#include <utility>
 #include "vec.h"
+#include "trig.h"
+
+class vec3fStream;
 
 #define MAT_ROWS	// Matrix is row-major in the sense 
 					// that it consists of an array of row vectors
 
+// Default singularity threshold for inverses: a matrix whose determinant
+// magnitude is at or below this is treated as non-invertible.
+// :NOTE: Absolute value, so very small (but valid) scales may need a smaller epsilon
+#define MAT_SINGULAR_EPSILON	1.0e-9f
+
 /////////////////////////////////////////
-// CLASS: mat33
-// 3x3 row-based matrix.
+// CLASS: mat<T, numRows, numCols>
+// Row-based matrix: an array of numRows row vectors.
+// mat33/mat44 (and the double variants) are typedefs of it.
+
+template <class T, unsigned numRows, unsigned numCols> class mat;
+
+// True if every type in Rows converts to the row type (used to constrain the row constructor)
+template <class Row, class... Rows>
+struct matRowsConvertible;
+
+template <class Row>
+struct matRowsConvertible<Row> : std::true_type
+{
+};
+
+template <class Row, class Arg, class... Rows>
+struct matRowsConvertible<Row, Arg, Rows...> :
+	std::integral_constant<bool, std::is_convertible<Arg, Row>::value && matRowsConvertible<Row, Rows...>::value>
+{
+};
 
-class mat33
+template <class T, unsigned numRows, unsigned numCols>
+class mat
 {
+public:
+	typedef vec<T, numCols> row_t;
+	typedef vec<T, numRows> col_t;
+
 protected:
 	/////////////////////////////////////////
 	// Properties
-	vec3f m_rows[3];
+	row_t m_rows[numRows];
 
 public:
 	/////////////////////////////////////////
 	// Setup & Initialization
-	mat33(vec3f r0 = vec3f(), vec3f r1 = vec3f(), vec3f r2 = vec3f());
+	constexpr mat() :
+		m_rows{}
+	{
+	}
+
+	// Row constructor: mat33(r0, r1, r2); omitted trailing rows are 0
+	template <class... Rows, class = typename std::enable_if<(sizeof...(Rows) >= 1) && (sizeof...(Rows) <= numRows) && matRowsConvertible<row_t, Rows...>::value>::type>
+	constexpr mat(const Rows&... rows) :
+		m_rows{ rows... }
+	{
+	}
+
+	static constexpr mat GetIdentity()
+	{
+		static_assert(numRows == numCols, "Identity requires a square matrix");
+		mat mat_identity;
+		for (unsigned i = 0; i < numRows; i++)
+		{
+			mat_identity[i][i] = T(1);
+		}
+		return mat_identity;
+	}
 
 	// Accessor: Row
-	vec3f operator[](int idx) const;
-	vec3f& operator[](int idx);
+	constexpr const row_t& operator[](int idx) const
+	{
+		return m_rows[idx];
+	}
+
+	constexpr row_t& operator[](int idx)
+	{
+		return m_rows[idx];
+	}
+
 	// Accessor: Col
-	vec3f GetColumn(int idx) const;
+	constexpr col_t GetColumn(int idx) const
+	{
+		return GetColumnStep(idx, std::make_index_sequence<numRows>());
+	}
 
 	/////////////////////////////////////////
 	// Matrix Calculations
-	mat33 GetTranspose() const;
-	float GetDeterminant() const;
+	constexpr mat<T, numCols, numRows> GetTranspose() const
+	{
+		return GetTransposeStep(std::make_index_sequence<numCols>());
+	}
+
+	// Retrieve minor matrix for specified indices (drop the row & column specified)
+	constexpr mat<T, numRows - 1, numCols - 1> GetMinor(int row, int col) const;
+	constexpr mat GetCofactorsMatrix() const;
+	constexpr T GetDeterminant() const;
+
+	// General inverse (4x4: closed form via shared 2x2 sub-determinants, SSE for
+	// mat44; other sizes: adjugate). Fails if |determinant| <= fEpsilon; the
+	// determinant is written to pDeterminant (if provided) either way.
+	bool TryGetInverse(mat& rMatResult, T fEpsilon = T(MAT_SINGULAR_EPSILON), T* pDeterminant = NULL) const;
+	// Inverse of an affine 4x4 (bottom row 0,0,0,1): inverts the upper 3x3 & the translation
+	bool TryGetInverseAffine(mat& rMatResult, T fEpsilon = T(MAT_SINGULAR_EPSILON), T* pDeterminant = NULL) const;
+	// Inverse of a rigid 4x4 transform (orthonormal rotation + translation): transposes
+	// the rotation & rotates/negates the translation. No singularity check needed.
+	mat GetInverseRigid() const;
+
+	/////////////////////////////////////////
+	// 3D Manipulation (3x3 & 4x4)
+	static mat GetMatrixRotXD(T fRotXDegrees);
+	static mat GetMatrixRotYD(T fRotYDegrees);
+	static mat GetMatrixRotZD(T fRotZDegrees);
+	static constexpr mat GetMatrixScale(T fScale);
+
+	// Rotation builders from a precomputed sine & cosine, so rotations by
+	// constant angles (& tables of them) can be built at compile time
+	static constexpr mat GetMatrixRotX(T fSin, T fCos);
+	static constexpr mat GetMatrixRotY(T fSin, T fCos);
+	static constexpr mat GetMatrixRotZ(T fSin, T fCos);
+	// Per-axis scale
+	static constexpr mat GetMatrixScale(T fScaleX, T fScaleY, T fScaleZ);
+
+	/////////////////////////////////////////
+	// Camera & Projection (4x4 only)
+	// Column vectors (clip = proj * view * p), right-handed: the camera looks down -z.
+	// bDepthZeroToOne: clip-space depth is [0, w] (Direct3D) instead of [-w, w] (OpenGL),
+	// same as Frustum's constructor.
+	static constexpr mat GetMatrixTranslation(T fX, T fY, T fZ);
+	// View matrix from an orthonormal camera basis (back = -look direction) & position
+	static constexpr mat GetMatrixView(vec<T, 3> right, vec<T, 3> up, vec<T, 3> back, vec<T, 3> eye);
+	// View matrix from eye looking at target (up needn't be unit length or orthogonal to the view)
+	static mat GetMatrixLookAt(vec<T, 3> eye, vec<T, 3> target, vec<T, 3> up);
+	// fYScale: 1 / tan(fovY / 2), so constant projections can be built at compile time
+	static constexpr mat GetMatrixPerspective(T fYScale, T fAspect, T fNear, T fFar, bool bDepthZeroToOne = false);
+	static mat GetMatrixPerspectiveD(T fFovYDegrees, T fAspect, T fNear, T fFar, bool bDepthZeroToOne = false);
+	static constexpr mat GetMatrixOrtho(T fLeft, T fRight, T fBottom, T fTop, T fNear, T fFar, bool bDepthZeroToOne = false);
+
+	/////////////////////////////////////////
+	// Bulk Transforms (mat44 only, see mat.cpp)
+	// Transform count vectors by this matrix in one call (SIMD & multithreaded for
+	// large counts). pResult may equal the input array to transform in place.
+	// Points are treated as (x,y,z,1) and directions as (x,y,z,0); the resulting
+	// w is discarded, so use TransformVectors() for projective matrices.
+	void TransformPoints(const vec3f* pPoints, vec3f* pResult, size_t count) const;
+	void TransformDirections(const vec3f* pDirs, vec3f* pResult, size_t count) const;
+	void TransformVectors(const vec4f* pVecs, vec4f* pResult, size_t count) const;
+	// SoA versions (rResult is resized to match & may be the input stream)
+	void TransformPoints(const vec3fStream& points, vec3fStream& rResult) const;
+	void TransformDirections(const vec3fStream& dirs, vec3fStream& rResult) const;
 
+	/////////////////////////////////////////
 	// DEBUG
-	void Print() const;
+	void Print() const
+	{
+		printf("==================================\n");
+		for (unsigned r = 0; r < numRows; r++)
+		{
+			printf("|");
+			for (unsigned c = 0; c < numCols; c++)
+			{
+				printf((c + 1 < numCols) ? "%5f " : "%5f|\n", (double)m_rows[r][c]);
+			}
+		}
+		printf("==================================\n");
+	}
+
+private:
+	template <size_t... I>
+	constexpr col_t GetColumnStep(int idx, std::index_sequence<I...>) const
+	{
+		return col_t(m_rows[I][idx]...);
+	}
+
+	template <size_t... I>
+	constexpr mat<T, numCols, numRows> GetTransposeStep(std::index_sequence<I...>) const
+	{
+		return mat<T, numCols, numRows>(GetColumn(I)...);
+	}
 };
 
-// mat33: Operator Overloads
-mat33 operator+(const mat33 m1, const mat33 m2);
-mat33 operator-(const mat33 m1, const mat33 m2);
-mat33 operator*(const float fScalar, const mat33 mat);
+// Matrix types
+typedef mat<float, 3, 3>	mat33;
+typedef mat<float, 4, 4>	mat44;
+typedef mat<double, 3, 3>	mat33d;
+typedef mat<double, 4, 4>	mat44d;
+typedef mat<float, 3, 4>	mat34;		// e.g. per-axis cubic coefficients
+
+// mat44 specializations (mat.cpp)
+template <> bool mat44::TryGetInverse(mat44& rMatResult, float fEpsilon, float* pDeterminant) const;
+template <> void mat44::TransformPoints(const vec3f* pPoints, vec3f* pResult, size_t count) const;
+template <> void mat44::TransformDirections(const vec3f* pDirs, vec3f* pResult, size_t count) const;
+template <> void mat44::TransformVectors(const vec4f* pVecs, vec4f* pResult, size_t count) const;
+template <> void mat44::TransformPoints(const vec3fStream& points, vec3fStream& rResult) const;
+template <> void mat44::TransformDirections(const vec3fStream& dirs, vec3fStream& rResult) const;
+
+//////////////////////////////////////////////////////////
+// mat: Operator Overloads
+//////////////////////////////////////////////////////////
+
+// Operator+: mat + mat
+template <class T, unsigned numRows, unsigned numCols>
+constexpr mat<T, numRows, numCols> operator+(const mat<T, numRows, numCols>& m1, const mat<T, numRows, numCols>& m2)
+{
+	mat<T, numRows, numCols> mat_result;
+	for (unsigned r = 0; r < numRows; r++)
+	{
+		mat_result[r] = m1[r] + m2[r];
+	}
+	return mat_result;
+}
+
+// Operator-: mat - mat
+template <class T, unsigned numRows, unsigned numCols>
+constexpr mat<T, numRows, numCols> operator-(const mat<T, numRows, numCols>& m1, const mat<T, numRows, numCols>& m2)
+{
+	mat<T, numRows, numCols> mat_result;
+	for (unsigned r = 0; r < numRows; r++)
+	{
+		mat_result[r] = m1[r] - m2[r];
+	}
+	return mat_result;
+}
+
+// Operator*: fScalar * mat
+template <class T, unsigned numRows, unsigned numCols>
+constexpr mat<T, numRows, numCols> operator*(const typename vecScalar<T>::type fScalar, const mat<T, numRows, numCols>& m)
+{
+	mat<T, numRows, numCols> mat_result;
+	for (unsigned r = 0; r < numRows; r++)
+	{
+		mat_result[r] = fScalar * m[r];
+	}
+	return mat_result;
+}
+
+template <class T, unsigned numRows, unsigned numCols, size_t... I>
+constexpr vec<T, numRows> matMulVec(const mat<T, numRows, numCols>& m1, const vec<T, numCols> v1, std::index_sequence<I...>)
+{
+	return vec<T, numRows>(vec<T, numCols>::DotProduct(v1, m1[I])...);
+}
+
+// RxC matrix  * column vecC = column vecR
+template <class T, unsigned numRows, unsigned numCols>
+constexpr vec<T, numRows> operator*(const mat<T, numRows, numCols>& m1, const vec<T, numCols> v1)
+{
+	return matMulVec(m1, v1, std::make_index_sequence<numRows>());
+}
+
+// RxK matrix  * KxC matrix = RxC matrix
+template <class T, unsigned numRows, unsigned numInner, unsigned numCols>
+constexpr mat<T, numRows, numCols> operator*(const mat<T, numRows, numInner>& m1, const mat<T, numInner, numCols>& m2)
+{
+	mat<T, numRows, numCols> mat_result;
+
+	// Column-first so we only have to construct each column vector once
+	for (unsigned c = 0; c < numCols; c++)
+	{
+		vec<T, numInner> col_curr = m2.GetColumn(c);
 
-// 3x3 matrix  * column vec3 = column vec3
-vec3f operator*(const mat33 m1, const vec3f v1);
-// 3x3 matrix  * 3x3 matrix = 3x3 matrix
-mat33 operator*(const mat33 m1, const mat33 m2);
+		for (unsigned r = 0; r < numRows; r++)
+		{
+			mat_result[r][c] = vec<T, numInner>::DotProduct(m1[r], col_curr);
+		}
+	}
 
-// Global Identity Matrix
-const mat33 MAT33_IDENTITY
+	return mat_result;
+}
+
+//////////////////////////////////////////////////////////
+// mat: SIMD Specializations (float 4x4 & double 4x4)
+// Same operation order as the generic versions, so results are identical.
+//////////////////////////////////////////////////////////
+
+#if defined VEC_SIMD
+// 4x4 matrix  * column vec4 = column vec4 (rows transposed into columns, then c0*x + c1*y + c2*z + c3*w)
+constexpr vec4f operator*(const mat44& m1, const vec4f v1)
+{
+	if (!VEC_IS_CONSTANT_EVALUATED())
+	{
+		__m128 col0 = _mm_loadu_ps(m1[0].Data());
+		__m128 col1 = _mm_loadu_ps(m1[1].Data());
+		__m128 col2 = _mm_loadu_ps(m1[2].Data());
+		__m128 col3 = _mm_loadu_ps(m1[3].Data());
+		_MM_TRANSPOSE4_PS(col0, col1, col2, col3);
+
+		__m128 v = _mm_loadu_ps(v1.Data());
+		__m128 result = _mm_add_ps(_mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)), col0),
+								   _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)), col1));
+		result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)), col2));
+		result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)), col3));
+
+		vec4f v_result;
+		_mm_storeu_ps(v_result.Data(), result);
+		return v_result;
+	}
+	return matMulVec(m1, v1, std::make_index_sequence<4>());
+}
+
+// 4x4 matrix  * 4x4 matrix: each result row is a1[0]*B0 + a1[1]*B1 + a1[2]*B2 + a1[3]*B3
+constexpr mat44 operator*(const mat44& m1, const mat44& m2)
+{
+	if (!VEC_IS_CONSTANT_EVALUATED())
+	{
+		__m128 rows2[4] =
+		{
+			_mm_loadu_ps(m2[0].Data()), _mm_loadu_ps(m2[1].Data()),
+			_mm_loadu_ps(m2[2].Data()), _mm_loadu_ps(m2[3].Data())
+		};
+
+		mat44 mat_result;
+		for (int r = 0; r < 4; r++)
+		{
+			const float* p_row1 = m1[r].Data();
+			__m128 result = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(p_row1[0]), rows2[0]), _mm_mul_ps(_mm_set1_ps(p_row1[1]), rows2[1]));
+			result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(p_row1[2]), rows2[2]));
+			result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(p_row1[3]), rows2[3]));
+			_mm_storeu_ps(mat_result[r].Data(), result);
+		}
+		return mat_result;
+	}
+
+	mat44 mat_result;
+	for (int c = 0; c < 4; c++)
+	{
+		vec4f col_curr = m2.GetColumn(c);
+		for (int r = 0; r < 4; r++)
+		{
+			mat_result[r][c] = vecOps<float, 4>::Dot<4>(m1[r], col_curr);
+		}
+	}
+	return mat_result;
+}
+
+// 4x4 double matrix  * column vec4d, two SSE2 __m128d halves per column
+constexpr vec4d operator*(const mat44d& m1, const vec4d v1)
+{
+	if (!VEC_IS_CONSTANT_EVALUATED())
+	{
+		__m128d result_lo = _mm_setzero_pd();	// Rows 0 & 1
+		__m128d result_hi = _mm_setzero_pd();	// Rows 2 & 3
+		for (int c = 0; c < 4; c++)
+		{
+			__m128d v = _mm_set1_pd(v1[c]);
+			__m128d col_lo = _mm_setr_pd(m1[0][c], m1[1][c]);
+			__m128d col_hi = _mm_setr_pd(m1[2][c], m1[3][c]);
+			if (c == 0)
+			{
+				result_lo = _mm_mul_pd(v, col_lo);
+				result_hi = _mm_mul_pd(v, col_hi);
+			}
+			else
+			{
+				result_lo = _mm_add_pd(result_lo, _mm_mul_pd(v, col_lo));
+				result_hi = _mm_add_pd(result_hi, _mm_mul_pd(v, col_hi));
+			}
+		}
+
+		vec4d v_result;
+		_mm_storeu_pd(v_result.Data(), result_lo);
+		_mm_storeu_pd(v_result.Data() + 2, result_hi);
+		return v_result;
+	}
+	return matMulVec(m1, v1, std::make_index_sequence<4>());
+}
+
+// 4x4 double matrix  * 4x4 double matrix, two SSE2 __m128d halves per row
+constexpr mat44d operator*(const mat44d& m1, const mat44d& m2)
+{
+	if (!VEC_IS_CONSTANT_EVALUATED())
+	{
+		mat44d mat_result;
+		for (int r = 0; r < 4; r++)
+		{
+			__m128d result_lo = _mm_setzero_pd();
+			__m128d result_hi = _mm_setzero_pd();
+			for (int k = 0; k < 4; k++)
+			{
+				__m128d a = _mm_set1_pd(m1[r][k]);
+				__m128d prod_lo = _mm_mul_pd(a, _mm_loadu_pd(m2[k].Data()));
+				__m128d prod_hi = _mm_mul_pd(a, _mm_loadu_pd(m2[k].Data() + 2));
+				result_lo = (k == 0 ? prod_lo : _mm_add_pd(result_lo, prod_lo));
+				result_hi = (k == 0 ? prod_hi : _mm_add_pd(result_hi, prod_hi));
+			}
+			_mm_storeu_pd(mat_result[r].Data(), result_lo);
+			_mm_storeu_pd(mat_result[r].Data() + 2, result_hi);
+		}
+		return mat_result;
+	}
+
+	mat44d mat_result;
+	for (int c = 0; c < 4; c++)
+	{
+		vec4d col_curr = m2.GetColumn(c);
+		for (int r = 0; r < 4; r++)
+		{
+			mat_result[r][c] = vecOps<double, 4>::Dot<4>(m1[r], col_curr);
+		}
+	}
+	return mat_result;
+}
+#endif // #if defined VEC_SIMD
+
+// Global Identity Matrices
+constexpr mat33 MAT33_IDENTITY
 (
 	vec3f(1.0f, 0.0f, 0.0f),
 	vec3f(0.0f, 1.0f, 0.0f),
 	vec3f(0.0f, 0.0f, 1.0f)
+);
+
+constexpr mat44 MAT44_IDENTITY
+	(
+		vec4f(1.0f, 0.0f, 0.0f, 0.0f),
+		vec4f(0.0f, 1.0f, 0.0f, 0.0f),
+		vec4f(0.0f, 0.0f,1.0f, 0.0f),
+		vec4f(0.0f, 0.0f, 0.0f,1.0f)
 	);
 
 //////////////////////////////////////////////////////////
+// mat: Determinants & Inverses
+//////////////////////////////////////////////////////////
+
+template <class T>
+constexpr T matDeterminant(const mat<T, 1, 1>& m)
+{
+	return m[0][0];
+}
+
+template <class T>
+constexpr T matDeterminant(const mat<T, 2, 2>& m)
+{
+	return (m[0][0] * m[1][1]) - (m[0][1] * m[1][0]);
+}
+
+// Calculate determinant using the triple product
+template <class T>
+constexpr T matDeterminant(const mat<T, 3, 3>& m)
+{
+	return vec<T, 3>::DotProduct(vec<T, 3>::CrossProduct(m[0], m[1]), m[2]);
+}
+
+/**
+ *	2x2 sub-determinants shared by the 4x4 determinant & inverse.
+ *	rSubTop[] come from rows 0 & 1, rSubBot[] from rows 2 & 3, for the column
+ *	pairs (0,1) (0,2) (0,3) (1,2) (1,3) (2,3). Returns the 4x4 determinant
+ *	(Laplace expansion along the top two rows).
+ */
+template <class T>
+constexpr T matSubDeterminants(const mat<T, 4, 4>& m, T (&rSubTop)[6], T (&rSubBot)[6])
+{
+	rSubTop[0] = m[0][0] * m[1][1] - m[1][0] * m[0][1];
+	rSubTop[1] = m[0][0] * m[1][2] - m[1][0] * m[0][2];
+	rSubTop[2] = m[0][0] * m[1][3] - m[1][0] * m[0][3];
+	rSubTop[3] = m[0][1] * m[1][2] - m[1][1] * m[0][2];
+	rSubTop[4] = m[0][1] * m[1][3] - m[1][1] * m[0][3];
+	rSubTop[5] = m[0][2] * m[1][3] - m[1][2] * m[0][3];
+
+	rSubBot[0] = m[2][0] * m[3][1] - m[3][0] * m[2][1];
+	rSubBot[1] = m[2][0] * m[3][2] - m[3][0] * m[2][2];
+	rSubBot[2] = m[2][0] * m[3][3] - m[3][0] * m[2][3];
+	rSubBot[3] = m[2][1] * m[3][2] - m[3][1] * m[2][2];
+	rSubBot[4] = m[2][1] * m[3][3] - m[3][1] * m[2][3];
+	rSubBot[5] = m[2][2] * m[3][3] - m[3][2] * m[2][3];
+
+	return (rSubTop[0] * rSubBot[5] - rSubTop[1] * rSubBot[4] + rSubTop[2] * rSubBot[3]
+		  + rSubTop[3] * rSubBot[2] - rSubTop[4] * rSubBot[1] + rSubTop[5] * rSubBot[0]);
+}
+
+template <class T>
+constexpr T matDeterminant(const mat<T, 4, 4>& m)
+{
+	T sub_top[6] = {}, sub_bot[6] = {};
+	return matSubDeterminants(m, sub_top, sub_bot);
+}
+
+// Any other size: Laplace expansion along row 0
+template <class T, unsigned matSize>
+constexpr T matDeterminant(const mat<T, matSize, matSize>& m)
+{
+	T result = T(0);
+	for (unsigned c = 0; c < matSize; c++)
+	{
+		T sign = ((c % 2) == 0 ? T(1) : T(-1));
+		result += (sign * m[0][c] * matDeterminant(m.GetMinor(0, c)));
+	}
+	return result;
+}
+
+// Closed-form 4x4 inverse: adjugate entries built from the 12 shared 2x2 sub-determinants
+template <class T>
+T matInverse(const mat<T, 4, 4>& m, mat<T, 4, 4>& rInv)
+{
+	T s[6], c[6];
+	T det = matSubDeterminants(m, s, c);
+
+	rInv[0] = vec<T, 4>( m[1][1] * c[5] - m[1][2] * c[4] + m[1][3] * c[3],
+						-m[0][1] * c[5] + m[0][2] * c[4] - m[0][3] * c[3],
+						 m[3][1] * s[5] - m[3][2] * s[4] + m[3][3] * s[3],
+						-m[2][1] * s[5] + m[2][2] * s[4] - m[2][3] * s[3]);
+
+	rInv[1] = vec<T, 4>(-m[1][0] * c[5] + m[1][2] * c[2] - m[1][3] * c[1],
+						 m[0][0] * c[5] - m[0][2] * c[2] + m[0][3] * c[1],
+						-m[3][0] * s[5] + m[3][2] * s[2] - m[3][3] * s[1],
+						 m[2][0] * s[5] - m[2][2] * s[2] + m[2][3] * s[1]);
+
+	rInv[2] = vec<T, 4>( m[1][0] * c[4] - m[1][1] * c[2] + m[1][3] * c[0],
+						-m[0][0] * c[4] + m[0][1] * c[2] - m[0][3] * c[0],
+						 m[3][0] * s[4] - m[3][1] * s[2] + m[3][3] * s[0],
+						-m[2][0] * s[4] + m[2][1] * s[2] - m[2][3] * s[0]);
+
+	rInv[3] = vec<T, 4>(-m[1][0] * c[3] + m[1][1] * c[1] - m[1][2] * c[0],
+						 m[0][0] * c[3] - m[0][1] * c[1] + m[0][2] * c[0],
+						-m[3][0] * s[3] + m[3][1] * s[1] - m[3][2] * s[0],
+						 m[2][0] * s[3] - m[2][1] * s[1] + m[2][2] * s[0]);
+
+	rInv = (T(1) / det) * rInv;
+	return det;
+}
+
+// Any other size: transposed cofactors over the determinant
+template <class T, unsigned matSize>
+T matInverse(const mat<T, matSize, matSize>& m, mat<T, matSize, matSize>& rInv)
+{
+	T det = matDeterminant(m);
+	rInv = (T(1) / det) * m.GetCofactorsMatrix().GetTranspose();
+	return det;
+}
+
+template <class T, unsigned numRows, unsigned numCols>
+constexpr mat<T, numRows - 1, numCols - 1> mat<T, numRows, numCols>::GetMinor(int row, int col) const
+{
+	static_assert(numRows == numCols && numRows >= 2, "Minors require a square matrix (2x2 or larger)");
+	mat<T, numRows - 1, numCols - 1> minor_mat;
+
+	int minor_r = 0;
+	for (int r = 0; r < (int)numRows; r++)
+	{
+		// Skip to next iteration if we're in a cut row
+		if (r == row)
+		{
+			continue;
+		}
+
+		int minor_c = 0;
+		for (int c = 0; c < (int)numCols; c++)
+		{
+			// Skip to next iteration if we're in a cut col
+			if (c == col)
+			{
+				continue;
+			}
+			minor_mat[minor_r][minor_c] = m_rows[r][c];
+			minor_c++;
+		}
+		minor_r++;
+	}
+
+	return minor_mat;
+}
+
+template <class T, unsigned numRows, unsigned numCols>
+constexpr mat<T, numRows, numCols> mat<T, numRows, numCols>::GetCofactorsMatrix() const
+{
+	mat mat_cofactors;
+
+	for (unsigned c = 0; c < numCols; c++)
+	{
+		for (unsigned r = 0; r < numRows; r++)
+		{
+			T sign = (((r + c) % 2) == 0 ? T(1) : T(-1));
+			mat_cofactors[r][c] = sign * matDeterminant(GetMinor(r, c));
+		}
+	}
+
+	return mat_cofactors;
+}
+
+template <class T, unsigned numRows, unsigned numCols>
+constexpr T mat<T, numRows, numCols>::GetDeterminant() const
+{
+	static_assert(numRows == numCols, "Determinants require a square matrix");
+	return matDeterminant(*this);
+}
+
+template <class T, unsigned numRows, unsigned numCols>
+bool mat<T, numRows, numCols>::TryGetInverse(mat& rMatResult, T fEpsilon /*= T(MAT_SINGULAR_EPSILON)*/, T* pDeterminant /*= NULL*/) const
+{
+	static_assert(numRows == numCols, "Inverses require a square matrix");
+	mat mat_inv;
+	T mat_determinant = matInverse(*this, mat_inv);
+
+	if (pDeterminant != NULL)
+	{
+		*pDeterminant = mat_determinant;
+	}
+
+	bool b_inverse_exists = (fabs(mat_determinant) > fEpsilon);
+	if (b_inverse_exists)
+	{
+		rMatResult = mat_inv;
+	}
+	return b_inverse_exists;
+}
+
+template <class T, unsigned numRows, unsigned numCols>
+bool mat<T, numRows, numCols>::TryGetInverseAffine(mat& rMatResult, T fEpsilon /*= T(MAT_SINGULAR_EPSILON)*/, T* pDeterminant /*= NULL*/) const
+{
+	static_assert(numRows == 4 && numCols == 4, "Affine inverses are only defined for 4x4 matrices");
+	typedef vec<T, 3> vec3_t;
+
+	vec3_t row0(m_rows[0][0], m_rows[0][1], m_rows[0][2]);
+	vec3_t row1(m_rows[1][0], m_rows[1][1], m_rows[1][2]);
+	vec3_t row2(m_rows[2][0], m_rows[2][1], m_rows[2][2]);
+	vec3_t translation(m_rows[0][3], m_rows[1][3], m_rows[2][3]);
+
+	// Columns of the inverse 3x3 are the cross products of row pairs, over the triple product
+	vec3_t cross12 = vec3_t::CrossProduct(row1, row2);
+	T mat_determinant = vec3_t::DotProduct(row0, cross12);
+	if (pDeterminant != NULL)
+	{
+		*pDeterminant = mat_determinant;
+	}
+
+	if (fabs(mat_determinant) <= fEpsilon)
+	{
+		return false;
+	}
+
+	T inv_det = T(1) / mat_determinant;
+	vec3_t inv_cols[3] =
+	{
+		inv_det * cross12,
+		inv_det * vec3_t::CrossProduct(row2, row0),
+		inv_det * vec3_t::CrossProduct(row0, row1)
+	};
+
+	for (int r = 0; r < 3; r++)
+	{
+		vec3_t inv_row(inv_cols[0][r], inv_cols[1][r], inv_cols[2][r]);
+		rMatResult[r] = row_t(inv_row[0], inv_row[1], inv_row[2], -vec3_t::DotProduct(inv_row, translation));
+	}
+	rMatResult[3] = row_t(T(0), T(0), T(0), T(1));
+
+	return true;
+}
+
+template <class T, unsigned numRows, unsigned numCols>
+mat<T, numRows, numCols> mat<T, numRows, numCols>::GetInverseRigid() const
+{
+	static_assert(numRows == 4 && numCols == 4, "Rigid inverses are only defined for 4x4 matrices");
+	typedef vec<T, 3> vec3_t;
+
+	vec3_t translation(m_rows[0][3], m_rows[1][3], m_rows[2][3]);
+
+	mat mat_result;
+	for (int r = 0; r < 3; r++)
+	{
+		// Row r of the transposed rotation is column r of the original
+		vec3_t rot_row(m_rows[0][r], m_rows[1][r], m_rows[2][r]);
+		mat_result[r] = row_t(rot_row[0], rot_row[1], rot_row[2], -vec3_t::DotProduct(rot_row, translation));
+	}
+	mat_result[3] = row_t(T(0), T(0), T(0), T(1));
+
+	return mat_result;
+}
+
+//////////////////////////////////////////////////////////
+// mat: 3D MANIPULATION
+//////////////////////////////////////////////////////////
+
+template <class T, unsigned numRows, unsigned numCols>
+constexpr mat<T, numRows, numCols> mat<T, numRows, numCols>::GetMatrixScale(T fScale)
+{
+	static_assert(numRows == numCols && numRows >= 3, "3D builders require a 3x3 or 4x4 matrix");
+	mat mat_scale = GetIdentity();
+
+	// Set the X/Y/Z diagonal values to desired scale value
+	for (int i = 0; i < 3; i++)
+	{
+		mat_scale[i][i] = fScale;
+	}
+
+	return mat_scale;
+}
+
+template <class T, unsigned numRows, unsigned numCols>
+constexpr mat<T, numRows, numCols> mat<T, numRows, numCols>::GetMatrixRotX(T fSin, T fCos)
+{
+	static_assert(numRows == numCols && numRows >= 3, "3D builders require a 3x3 or 4x4 matrix");
+	mat mat_rot = GetIdentity();
+
+	mat_rot[1][1] = fCos;
+	mat_rot[2][2] = fCos;
+	mat_rot[1][2] = -fSin;
+	mat_rot[2][1] = fSin;
+
+	return mat_rot;
+}
+
+template <class T, unsigned numRows, unsigned numCols>
+constexpr mat<T, numRows, numCols> mat<T, numRows, numCols>::GetMatrixRotY(T fSin, T fCos)
+{
+	static_assert(numRows == numCols && numRows >= 3, "3D builders require a 3x3 or 4x4 matrix");
+	mat mat_rot = GetIdentity();
+
+	mat_rot[0][0] = fCos;
+	mat_rot[2][2] = fCos;
+	mat_rot[0][2] = fSin;
+	mat_rot[2][0] = -fSin;
+
+	return mat_rot;
+}
+
+template <class T, unsigned numRows, unsigned numCols>
+constexpr mat<T, numRows, numCols> mat<T, numRows, numCols>::GetMatrixRotZ(T fSin, T fCos)
+{
+	static_assert(numRows == numCols && numRows >= 3, "3D builders require a 3x3 or 4x4 matrix");
+	mat mat_rot = GetIdentity();
+
+	mat_rot[0][0] = fCos;
+	mat_rot[1][1] = fCos;
+	mat_rot[0][1] = -fSin;
+	mat_rot[1][0] = fSin;
+
+	return mat_rot;
+}
+
+template <class T, unsigned numRows, unsigned numCols>
+mat<T, numRows, numCols> mat<T, numRows, numCols>::GetMatrixRotXD(T fRotXDegrees)
+{
+	T rot_sin, rot_cos;
+	SinCosD(fRotXDegrees, rot_sin, rot_cos);
+	return GetMatrixRotX(rot_sin, rot_cos);
+}
 
+template <class T, unsigned numRows, unsigned numCols>
+mat<T, numRows, numCols> mat<T, numRows, numCols>::GetMatrixRotYD(T fRotYDegrees)
+{
+	T rot_sin, rot_cos;
+	SinCosD(fRotYDegrees, rot_sin, rot_cos);
+	return GetMatrixRotY(rot_sin, rot_cos);
+}
+
+template <class T, unsigned numRows, unsigned numCols>
+mat<T, numRows, numCols> mat<T, numRows, numCols>::GetMatrixRotZD(T fRotZDegrees)
+{
+	T rot_sin, rot_cos;
+	SinCosD(fRotZDegrees, rot_sin, rot_cos);
+	return GetMatrixRotZ(rot_sin, rot_cos);
+}
+
+template <class T, unsigned numRows, unsigned numCols>
+constexpr mat<T, numRows, numCols> mat<T, numRows, numCols>::GetMatrixScale(T fScaleX, T fScaleY, T fScaleZ)
+{
+	static_assert(numRows == numCols && numRows >= 3, "3D builders require a 3x3 or 4x4 matrix");
+	mat mat_scale = GetIdentity();
+
+	mat_scale[0][0] = fScaleX;
+	mat_scale[1][1] = fScaleY;
+	mat_scale[2][2] = fScaleZ;
+
+	return mat_scale;
+}
+
+//////////////////////////////////////////////////////////
+// mat: CAMERA & PROJECTION
 //////////////////////////////////////////////////////////
-// CLASS: mat44
-// 4x4 matrix
 
-class mat44
+template <class T, unsigned numRows, unsigned numCols>
+constexpr mat<T, numRows, numCols> mat<T, numRows, numCols>::GetMatrixTranslation(T fX, T fY, T fZ)
 {
-protected:
-	/////////////////////////////////////////
-	// Properties
-	vec4f m_rows[4];
+	static_assert(numRows == 4 && numCols == 4, "Translations require a 4x4 matrix");
+	mat mat_translation = GetIdentity();
 
-public:
-	/////////////////////////////////////////
-	// Setup & Initialization
-	mat44(vec4f r0 = vec4f(), vec4f r1 = vec4f(), vec4f r2 = vec4f(), vec4f r3 = vec4f());
+	mat_translation[0][3] = fX;
+	mat_translation[1][3] = fY;
+	mat_translation[2][3] = fZ;
 
-	// Accessor: Row
-	vec4f operator[](int idx) const;
-	vec4f& operator[](int idx);
-	// Accessor: Col
-	vec4f GetColumn(int idx) const;
+	return mat_translation;
+}
 
-	/////////////////////////////////////////
-	// Matrix Calculations
-	mat44 GetTranspose() const;
-	mat33 GetMinor(int row, int col) const;
-	mat44 GetCofactorsMatrix() const;
-	float GetDeterminant() const;
-	bool TryGetInverse(mat44& rMatResult) const;
+template <class T, unsigned numRows, unsigned numCols>
+constexpr mat<T, numRows, numCols> mat<T, numRows, numCols>::GetMatrixView(vec<T, 3> right, vec<T, 3> up, vec<T, 3> back, vec<T, 3> eye)
+{
+	static_assert(numRows == 4 && numCols == 4, "View matrices require a 4x4 matrix");
+	typedef vec<T, 3> vec3_t;
 
-	/////////////////////////////////////////
-	// 3D Manipulation
-	static mat44 GetMatrixRotXD(float fRotXDegrees);
-	static mat44 GetMatrixRotYD(float fRotYDegrees);
-	static mat44 GetMatrixRotZD(float fRotZDegrees);
-	static mat44 GetMatrixScale(float fScale);
+	// Inverse of the camera's rigid transform: basis vectors as rows, translation rotated & negated
+	return mat
+	(
+		row_t(right[0], right[1], right[2], -vec3_t::DotProduct(right, eye)),
+		row_t(up[0], up[1], up[2], -vec3_t::DotProduct(up, eye)),
+		row_t(back[0], back[1], back[2], -vec3_t::DotProduct(back, eye)),
+		row_t(T(0), T(0), T(0), T(1))
+	);
+}
 
-	/////////////////////////////////////////
-	// DEBUG
-	void Print() const;
+template <class T, unsigned numRows, unsigned numCols>
+mat<T, numRows, numCols> mat<T, numRows, numCols>::GetMatrixLookAt(vec<T, 3> eye, vec<T, 3> target, vec<T, 3> up)
+{
+	typedef vec<T, 3> vec3_t;
 
-};
+	vec3_t back = eye - target;
+	back.Normalize();
+	vec3_t right = vec3_t::CrossProduct(up, back);
+	right.Normalize();
+	vec3_t up_ortho = vec3_t::CrossProduct(back, right);
 
-// mat44: Operator Overloads
-mat44 operator+(const mat44 m1, const mat44 m2);
-mat44 operator-(const mat44 m1, const mat44 m2);
-mat44 operator*(const float fScalar, const mat44 mat);
+	return GetMatrixView(right, up_ortho, back, eye);
+}
 
+template <class T, unsigned numRows, unsigned numCols>
+constexpr mat<T, numRows, numCols> mat<T, numRows, numCols>::GetMatrixPerspective(T fYScale, T fAspect, T fNear, T fFar, bool bDepthZeroToOne /*= false*/)
+{
+	static_assert(numRows == 4 && numCols == 4, "Projections require a 4x4 matrix");
+	T depth_scale = (bDepthZeroToOne ? fFar : (fFar + fNear)) / (fNear - fFar);
+	T depth_offset = (bDepthZeroToOne ? T(1) : T(2)) * fFar * fNear / (fNear - fFar);
+
+	return mat
+	(
+		row_t(fYScale / fAspect, T(0), T(0), T(0)),
+		row_t(T(0), fYScale, T(0), T(0)),
+		row_t(T(0), T(0), depth_scale, depth_offset),
+		row_t(T(0), T(0), T(-1), T(0))
+	);
+}
 
-// 4x4 matrix  * column vec4 = column vec4
-vec4f operator*(const mat44 m1, const vec4f v1);
+template <class T, unsigned numRows, unsigned numCols>
+mat<T, numRows, numCols> mat<T, numRows, numCols>::GetMatrixPerspectiveD(T fFovYDegrees, T fAspect, T fNear, T fFar, bool bDepthZeroToOne /*= false*/)
+{
+	// 1 / tan(fovY / 2) = cos / sin
+	T half_fov_sin, half_fov_cos;
+	SinCosD(fFovYDegrees * T(0.5), half_fov_sin, half_fov_cos);
+	return GetMatrixPerspective(half_fov_cos / half_fov_sin, fAspect, fNear, fFar, bDepthZeroToOne);
+}
 
-// 4x4 matrix  * 4x4 matrix = 4x4 matrix
-mat44 operator*(const mat44 m1, const mat44 m2);
+template <class T, unsigned numRows, unsigned numCols>
+constexpr mat<T, numRows, numCols> mat<T, numRows, numCols>::GetMatrixOrtho(T fLeft, T fRight, T fBottom, T fTop, T fNear, T fFar, bool bDepthZeroToOne /*= false*/)
+{
+	static_assert(numRows == 4 && numCols == 4, "Projections require a 4x4 matrix");
+	T depth_scale = (bDepthZeroToOne ? T(1) : T(2)) / (fNear - fFar);
+	T depth_offset = (bDepthZeroToOne ? fNear : (fFar + fNear)) / (fNear - fFar);
 
-// Global Identity Matrix
-const mat44 MAT44_IDENTITY
+	return mat
 	(
-		vec4f(1.0f, 0.0f, 0.0f, 0.0f),
-		vec4f(0.0f, 1.0f, 0.0f, 0.0f),
-		vec4f(0.0f, 0.0f,1.0f, 0.0f),
-		vec4f(0.0f, 0.0f, 0.0f,1.0f)
+		row_t(T(2) / (fRight - fLeft), T(0), T(0), -(fRight + fLeft) / (fRight - fLeft)),
+		row_t(T(0), T(2) / (fTop - fBottom), T(0), -(fTop + fBottom) / (fTop - fBottom)),
+		row_t(T(0), T(0), depth_scale, depth_offset),
+		row_t(T(0), T(0), T(0), T(1))
 	);
+}
+
+// Bulk transforms only exist for mat44 (specialized in mat.cpp)
+template <class T, unsigned numRows, unsigned numCols>
+void mat<T, numRows, numCols>::TransformPoints(const vec3f*, vec3f*, size_t) const
+{
+	static_assert(sizeof(T) == 0, "Bulk transforms are only available for mat44");
+}
+
+template <class T, unsigned numRows, unsigned numCols>
+void mat<T, numRows, numCols>::TransformDirections(const vec3f*, vec3f*, size_t) const
+{
+	static_assert(sizeof(T) == 0, "Bulk transforms are only available for mat44");
+}
+
+template <class T, unsigned numRows, unsigned numCols>
+void mat<T, numRows, numCols>::TransformVectors(const vec4f*, vec4f*, size_t) const
+{
+	static_assert(sizeof(T) == 0, "Bulk transforms are only available for mat44");
+}
+
+template <class T, unsigned numRows, unsigned numCols>
+void mat<T, numRows, numCols>::TransformPoints(const vec3fStream&, vec3fStream&) const
+{
+	static_assert(sizeof(T) == 0, "Bulk transforms are only available for mat44");
+}
+
+template <class T, unsigned numRows, unsigned numCols>
+void mat<T, numRows, numCols>::TransformDirections(const vec3fStream&, vec3fStream&) const
+{
+	static_assert(sizeof(T) == 0, "Bulk transforms are only available for mat44");
+}
 //////////////////////////////////////////////////////////
 
 
@@ -0,0 +1,53 @@
+/**
+ *	FILE: mat_kernels.inl
+ *	mat.cpp's batch kernels; included by simd_kernels.inl, once per instruction
+ *	set.
+ */
+
+/**
+ *	SoA kernel: the 12 affine matrix elements are broadcast into registers once
+ *	and S::WIDTH vectors are transformed per iteration.
+ */
+template <class S, bool bPoint>
+static void KernelTransformSoA(const float (&m)[4][4], const float* const* pIn, float* const* pOut, size_t begin, size_t end)
+{
+	typename S::type mat_lanes[3][4];
+	for (int r = 0; r < 3; r++)
+	{
+		for (int c = 0; c < 4; c++)
+		{
+			mat_lanes[r][c] = S::Set1(m[r][c]);
+		}
+	}
+
+	size_t i = begin;
+	for (; i + S::WIDTH <= end; i += S::WIDTH)
+	{
+		typename S::type x = S::Load(pIn[0] + i);
+		typename S::type y = S::Load(pIn[1] + i);
+		typename S::type z = S::Load(pIn[2] + i);
+
+		typename S::type result[3];
+		for (int r = 0; r < 3; r++)
+		{
+			result[r] = S::Add(S::Add(S::Mul(mat_lanes[r][0], x), S::Mul(mat_lanes[r][1], y)), S::Mul(mat_lanes[r][2], z));
+			if (bPoint)
+			{
+				result[r] = S::Add(result[r], mat_lanes[r][3]);
+			}
+		}
+
+		// Store after all loads so in-place transforms are safe
+		for (int r = 0; r < 3; r++)
+		{
+			S::Store(pOut[r] + i, result[r]);
+		}
+	}
+
+	if (i < end)
+	{
+		KernelTransformSoA<SimdScalar, bPoint>(m, pIn, pOut, i, end);
+	}
+}
+template <class S> static void KernelTransformPointsSoA(const float (&m)[4][4], const float* const* pIn, float* const* pOut, size_t begin, size_t end) { KernelTransformSoA<S, true>(m, pIn, pOut, begin, end); }
+template <class S> static void KernelTransformDirsSoA(const float (&m)[4][4], const float* const* pIn, float* const* pOut, size_t begin, size_t end) { KernelTransformSoA<S, false>(m, pIn, pOut, begin, end); }
@@ -1,4 +1,10 @@
 #include "math3d.h"
+#include "vecstream.h"
+#include "simd.h"
+#include "parallel.h"
+
+// Below this many pairs per thread, batch solvers stay on the calling thread
+#define MATH3D_BATCH_GRAIN		(1 << 14)
 
 /**
 *	Calculate directional vector for a missile moving at a given speed
@@ -16,8 +22,6 @@ vec3f GetTargetIntercept(vec3f posMsl, float fSpeedMsl, vec3f posTarget, vec3f v
 	vec3f vec_m2t = posTarget - posMsl;
 	// Convert to unit vector
 	vec3f uvec_m2t = (1.0f / vec_m2t.Mag()) * vec_m2t;
-	// Also, calculate the target velocity's magnitude for later
-	float mag_vt = velTarget.Mag();
 
 	///////////////////////////
 	// Next, project the target velocity onto the m2t vector to determine parallel (p) & orthogonal (o) component vectors
@@ -69,6 +73,27 @@ vec3f GetTargetIntercept(vec3f posMsl, float fSpeedMsl, vec3f posTarget, vec3f v
 	return ((1.0f / vel_msl.Mag()) * vel_msl);
 }
 
+// Batch kernels, one copy per instruction set (see simd_kernels.inl)
+#define SIMD_KERNEL_FILE "math3d_kernels.inl"
+#include "simd_kernels.inl"
+
+void GetTargetIntercepts(const vec3fStream& posMsl, const float* pSpeedMsl, const vec3fStream& posTarget, const vec3fStream& velTarget,
+						 vec3fStream& rDirResult, bool* pCanIntercept)
+{
+	size_t count = posMsl.Size();
+	rDirResult.Resize(count);
+
+	const float* p_pos_msl[3] = { posMsl.X(), posMsl.Y(), posMsl.Z() };
+	const float* p_pos_target[3] = { posTarget.X(), posTarget.Y(), posTarget.Z() };
+	const float* p_vel_target[3] = { velTarget.X(), velTarget.Y(), velTarget.Z() };
+	float* p_dir[3] = { rDirResult.X(), rDirResult.Y(), rDirResult.Z() };
+
+	ParallelFor(count, MATH3D_BATCH_GRAIN, [&](size_t begin, size_t end)
+	{
+		SIMD_DISPATCH(KernelTargetIntercept, (p_pos_msl, pSpeedMsl, p_pos_target, p_vel_target, p_dir, pCanIntercept, begin, end));
+	});
+}
+
 /**
 *	Calculates time until interception for two entities given their positions and velocities
 *	@return	Time until interception
@@ -105,6 +130,35 @@ vec3f GetInterceptPoint(vec3f pos1, vec3f vel1, vec3f pos2, vec3f vel2)
 	return point_intercept;
 }
 
+InterceptStatus SolveInterceptTime(vec3f pos1, vec3f vel1, vec3f pos2, vec3f vel2, float fRadius, float* pTime)
+{
+	// Single-lane run of the batch kernel so both always agree
+	const float* p_pos1[3] = { &pos1[0], &pos1[1], &pos1[2] };
+	const float* p_vel1[3] = { &vel1[0], &vel1[1], &vel1[2] };
+	const float* p_pos2[3] = { &pos2[0], &pos2[1], &pos2[2] };
+	const float* p_vel2[3] = { &vel2[0], &vel2[1], &vel2[2] };
+
+	InterceptStatus status;
+	simd_base::KernelInterceptTime<SimdScalar>(p_pos1, p_vel1, p_pos2, p_vel2, fRadius, pTime, &status, 0, 1);
+	return status;
+}
+
+void SolveInterceptTimes(const vec3fStream& pos1, const vec3fStream& vel1, const vec3fStream& pos2, const vec3fStream& vel2, float fRadius,
+						 float* pTime, InterceptStatus* pStatus)
+{
+	size_t count = pos1.Size();
+
+	const float* p_pos1[3] = { pos1.X(), pos1.Y(), pos1.Z() };
+	const float* p_vel1[3] = { vel1.X(), vel1.Y(), vel1.Z() };
+	const float* p_pos2[3] = { pos2.X(), pos2.Y(), pos2.Z() };
+	const float* p_vel2[3] = { vel2.X(), vel2.Y(), vel2.Z() };
+
+	ParallelFor(count, MATH3D_BATCH_GRAIN, [&](size_t begin, size_t end)
+	{
+		SIMD_DISPATCH(KernelInterceptTime, (p_pos1, p_vel1, p_pos2, p_vel2, fRadius, pTime, pStatus, begin, end));
+	});
+}
+
 /**
  * Detect if posCheck position is within the vision range of the sentry.
  * @param	posSentry	Position of sentry
@@ -131,6 +185,298 @@ bool IsWithinRange2D(vec2f posSentry, vec2f dirSentry, float rangeSentry, float
 	return (angle <= halfAngleSentry);
 }
 
+void GetVisibility2D(const vec2fStream& posSentries, const vec2fStream& dirSentries, const float* pRangeSentries, const float* pHalfAngleSentries,
+					 const vec2fStream& posTargets, uint32_t* pVisible)
+{
+	size_t num_sentries = posSentries.Size();
+	size_t num_targets = posTargets.Size();
+	size_t num_words = VISIBILITY_WORDS(num_targets);
+	if (num_targets == 0)
+	{
+		return;
+	}
+
+	// Split over sentries, keeping roughly MATH3D_BATCH_GRAIN checks per chunk
+	size_t grain_sentries = (num_targets < MATH3D_BATCH_GRAIN ? MATH3D_BATCH_GRAIN / num_targets : 1);
+	ParallelFor(num_sentries, grain_sentries, [&](size_t begin, size_t end)
+	{
+		for (size_t s = begin; s < end; s++)
+		{
+			uint32_t* p_row = pVisible + (s * num_words);
+			for (size_t w = 0; w < num_words; w++)
+			{
+				p_row[w] = 0;
+			}
+
+			// Negative half angles & zero-length directions see nothing (as in IsWithinRange2D(),
+			// where the angle comes out NaN)
+			float half_angle = pHalfAngleSentries[s];
+			float dir_x = dirSentries.X()[s];
+			float dir_y = dirSentries.Y()[s];
+			if (!(half_angle >= 0.0f) || !(((dir_x * dir_x) + (dir_y * dir_y)) > 0.0f))
+			{
+				continue;
+			}
+
+			float range = pRangeSentries[s];
+			float range_sq = range * range;
+
+			// Half angles of PI or more see in every direction (only range matters)
+			float cos_half = cosf(half_angle);
+			bool b_wide_angle = (cos_half < 0.0f);
+			float cos_sq_dir_sq = (half_angle < (float)M_PI ? (cos_half * cos_half) * ((dir_x * dir_x) + (dir_y * dir_y)) : INFINITY);
+
+			SIMD_DISPATCH(KernelVisibility2D, (posSentries.X()[s], posSentries.Y()[s], dir_x, dir_y, range_sq, cos_sq_dir_sq, b_wide_angle,
+											   posTargets.X(), posTargets.Y(), p_row, 0, num_targets));
+		}
+	});
+}
+
+//////////////////////////////////////////////////////////
+// 3D Visibility
+//////////////////////////////////////////////////////////
+
+// Same squared-magnitude test as KernelVisibility2D()
+bool IsWithinCone3D(vec3f posSentry, vec3f dirSentry, float rangeSentry, float halfAngleSentry, vec3f posCheck)
+{
+	if (!(halfAngleSentry >= 0.0f))
+	{
+		return false;
+	}
+
+	vec3f vec_distance = posCheck - posSentry;
+	float dist_sq = vec3f::DotProduct(vec_distance, vec_distance);
+	if (!(dist_sq > 0.0f) || dist_sq > (rangeSentry * rangeSentry))
+	{
+		return false;
+	}
+	if (halfAngleSentry >= (float)M_PI)
+	{
+		return true;
+	}
+	// Zero-length direction: sees nothing (as IsSphereWithinCone3D() & IsWithinRange2D())
+	if (!(vec3f::DotProduct(dirSentry, dirSentry) > 0.0f))
+	{
+		return false;
+	}
+
+	float dp = vec3f::DotProduct(dirSentry, vec_distance);
+	float cos_half = cosf(halfAngleSentry);
+	float limit_sq = (cos_half * cos_half) * vec3f::DotProduct(dirSentry, dirSentry) * dist_sq;
+	if (cos_half >= 0.0f)
+	{
+		return (dp >= 0.0f && (dp * dp) >= limit_sq);
+	}
+	return (dp >= 0.0f || (dp * dp) <= limit_sq);
+}
+
+/**
+ *	With the center split into along-axis (dp) & perpendicular (perp) distances, it is
+ *	inside the cone if dp sin >= perp cos. Otherwise its nearest point on the cone is on
+ *	the side (distance perp cos - dp sin) while dp cos + perp sin > 0, else the apex.
+ */
+bool IsSphereWithinCone3D(vec3f posSentry, vec3f dirSentry, float rangeSentry, float halfAngleSentry, vec3f center, float fRadius)
+{
+	if (!(halfAngleSentry >= 0.0f) || !(fRadius >= 0.0f))
+	{
+		return false;
+	}
+
+	vec3f vec_distance = center - posSentry;
+	float dist_sq = vec3f::DotProduct(vec_distance, vec_distance);
+	float reach = fabsf(rangeSentry) + fRadius;
+	if (dist_sq > (reach * reach))
+	{
+		return false;
+	}
+	// Sentry inside the sphere, or sees all around
+	if (dist_sq <= (fRadius * fRadius) || halfAngleSentry >= (float)M_PI)
+	{
+		return true;
+	}
+
+	float dir_mag = dirSentry.Mag();
+	if (!(dir_mag > 0.0f))
+	{
+		return false;
+	}
+
+	float dp = vec3f::DotProduct(dirSentry, vec_distance) / dir_mag;
+	float perp_sq = dist_sq - (dp * dp);
+	float perp = (perp_sq > 0.0f ? sqrtf(perp_sq) : 0.0f);
+	float cos_half = cosf(halfAngleSentry);
+	float sin_half = sinf(halfAngleSentry);
+	if ((dp * sin_half) >= (perp * cos_half))
+	{
+		return true;
+	}
+	if ((dp * cos_half) + (perp * sin_half) > 0.0f)
+	{
+		return ((perp * cos_half) - (dp * sin_half) <= fRadius);
+	}
+	return false;
+}
+
+bool IsAABBWithinCone3D(vec3f posSentry, vec3f dirSentry, float rangeSentry, float halfAngleSentry, vec3f boundsMin, vec3f boundsMax)
+{
+	vec3f center = 0.5f * (boundsMin + boundsMax);
+	float radius = 0.5f * (boundsMax - boundsMin).Mag();
+	return IsSphereWithinCone3D(posSentry, dirSentry, rangeSentry, halfAngleSentry, center, radius);
+}
+
+// Signed distance from the plane (positive: inside)
+static inline float GetPlaneDistance(const vec4f& plane, float x, float y, float z)
+{
+	return ((plane[0] * x + plane[1] * y) + plane[2] * z) + plane[3];
+}
+
+//////////////////////////////////////////////////////////
+// CLASS: Frustum
+//////////////////////////////////////////////////////////
+
+Frustum::Frustum()
+{
+	for (int p = 0; p < FRUSTUM_NUM_PLANES; p++)
+	{
+		m_planes[p] = vec4f(0.0f, 0.0f, 0.0f, 0.0f);
+	}
+}
+
+Frustum::Frustum(const mat44& viewProj, bool bDepthZeroToOne /*= false*/)
+{
+	SetFromMatrix(viewProj, bDepthZeroToOne);
+}
+
+// :NOTE: Gribb & Hartmann: -w <= x <= w becomes (row3 + row0).p >= 0 & (row3 - row0).p >= 0, etc.
+void Frustum::SetFromMatrix(const mat44& viewProj, bool bDepthZeroToOne /*= false*/)
+{
+	vec4f row0 = viewProj[0];
+	vec4f row1 = viewProj[1];
+	vec4f row2 = viewProj[2];
+	vec4f row3 = viewProj[3];
+
+	m_planes[0] = row3 + row0;	// Left
+	m_planes[1] = row3 - row0;	// Right
+	m_planes[2] = row3 + row1;	// Bottom
+	m_planes[3] = row3 - row1;	// Top
+	m_planes[4] = (bDepthZeroToOne ? row2 : row3 + row2);	// Near
+	m_planes[5] = row3 - row2;	// Far
+
+	// Normalize so plane distances are true distances (needed for sphere radii)
+	for (int p = 0; p < FRUSTUM_NUM_PLANES; p++)
+	{
+		vec4f& plane = m_planes[p];
+		float normal_mag = sqrtf((plane[0] * plane[0]) + (plane[1] * plane[1]) + (plane[2] * plane[2]));
+		if (normal_mag > 0.0f)
+		{
+			plane = (1.0f / normal_mag) * plane;
+		}
+	}
+}
+
+bool Frustum::ContainsPoint(vec3f p) const
+{
+	for (int i = 0; i < FRUSTUM_NUM_PLANES; i++)
+	{
+		if (GetPlaneDistance(m_planes[i], p.x(), p.y(), p.z()) < 0.0f)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+FrustumTest Frustum::TestSphere(vec3f center, float fRadius) const
+{
+	FrustumTest result = FRUSTUM_INSIDE;
+	for (int i = 0; i < FRUSTUM_NUM_PLANES; i++)
+	{
+		float dist = GetPlaneDistance(m_planes[i], center.x(), center.y(), center.z());
+		if (dist < -fRadius)
+		{
+			return FRUSTUM_OUTSIDE;
+		}
+		if (dist < fRadius)
+		{
+			result = FRUSTUM_INTERSECT;
+		}
+	}
+	return result;
+}
+
+FrustumTest Frustum::TestAABB(vec3f boundsMin, vec3f boundsMax, unsigned* pPlaneMask /*= NULL*/) const
+{
+	unsigned plane_mask = (pPlaneMask != NULL ? *pPlaneMask : FRUSTUM_ALL_PLANES);
+	for (int i = 0; i < FRUSTUM_NUM_PLANES; i++)
+	{
+		if ((plane_mask & (1u << i)) == 0)
+		{
+			continue;
+		}
+
+		// Corners farthest along (p) & against (n) the plane normal
+		const vec4f& plane = m_planes[i];
+		vec3f corner_p, corner_n;
+		for (int c = 0; c < 3; c++)
+		{
+			corner_p[c] = (plane[c] >= 0.0f ? boundsMax[c] : boundsMin[c]);
+			corner_n[c] = (plane[c] >= 0.0f ? boundsMin[c] : boundsMax[c]);
+		}
+
+		if (GetPlaneDistance(plane, corner_p.x(), corner_p.y(), corner_p.z()) < 0.0f)
+		{
+			return FRUSTUM_OUTSIDE;
+		}
+		if (GetPlaneDistance(plane, corner_n.x(), corner_n.y(), corner_n.z()) >= 0.0f)
+		{
+			plane_mask &= ~(1u << i);
+		}
+	}
+
+	if (pPlaneMask != NULL)
+	{
+		*pPlaneMask = plane_mask;
+	}
+	return (plane_mask == 0 ? FRUSTUM_INSIDE : FRUSTUM_INTERSECT);
+}
+
+// :NOTE: Split over whole output words so no two threads write the same word
+void Frustum::CullSpheres(const vec3fStream& centers, const float* pRadii, uint32_t* pVisible) const
+{
+	size_t count = centers.Size();
+	const float* p_x = centers.X();
+	const float* p_y = centers.Y();
+	const float* p_z = centers.Z();
+
+	ParallelFor(VISIBILITY_WORDS(count), MATH3D_BATCH_GRAIN / 32, [&](size_t wordBegin, size_t wordEnd)
+	{
+		for (size_t w = wordBegin; w < wordEnd; w++)
+		{
+			pVisible[w] = 0;
+		}
+
+		size_t end = (wordEnd * 32 < count ? wordEnd * 32 : count);
+		SIMD_DISPATCH(KernelCullSpheres, (m_planes, p_x, p_y, p_z, pRadii, pVisible, wordBegin * 32, end));
+	});
+}
+
+void Frustum::CullAABBs(const vec3fStream& boundsMin, const vec3fStream& boundsMax, uint32_t* pVisible) const
+{
+	size_t count = boundsMin.Size();
+	const float* p_min[3] = { boundsMin.X(), boundsMin.Y(), boundsMin.Z() };
+	const float* p_max[3] = { boundsMax.X(), boundsMax.Y(), boundsMax.Z() };
+
+	ParallelFor(VISIBILITY_WORDS(count), MATH3D_BATCH_GRAIN / 32, [&](size_t wordBegin, size_t wordEnd)
+	{
+		for (size_t w = wordBegin; w < wordEnd; w++)
+		{
+			pVisible[w] = 0;
+		}
+
+		size_t end = (wordEnd * 32 < count ? wordEnd * 32 : count);
+		SIMD_DISPATCH(KernelCullAABBs, (m_planes, p_min, p_max, pVisible, wordBegin * 32, end));
+	});
+}
 
 float Lerp(float f1, float f2, float t)
 {
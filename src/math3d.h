@@ -2,20 +2,136 @@
 #ifndef MATH3D_H
 #define MATH3D_H
 
+#include <stdint.h>
 #include "vec.h"
 #include "quat.h"
 
+class vec2fStream;
+class vec3fStream;
+
 // FILE: math3d.h
 // DESC: Applied 3D (& 2D for now) Math
 
 // 3D Target Intercept
 vec3f GetTargetIntercept(vec3f posMsl, float fSpeedMsl, vec3f posTarget, vec3f velTarget);
+// Batch GetTargetIntercept() over SoA pairs (SIMD across pairs, multithreaded over chunks).
+// All inputs hold posMsl.Size() entries; rDirResult is resized to match & pCanIntercept
+// receives one flag per pair (false: direction is the target's own heading).
+void GetTargetIntercepts(const vec3fStream& posMsl, const float* pSpeedMsl, const vec3fStream& posTarget, const vec3fStream& velTarget,
+						 vec3fStream& rDirResult, bool* pCanIntercept);
+// :NOTE: Only considers motion along the initial line between the entities & divides by zero
+// when they're parallel or coincident; prefer SolveInterceptTime()
 float GetInterceptTime(vec3f pos1, vec3f vel1, vec3f pos2, vec3f vel2);
 vec3f GetInterceptPoint(vec3f posSrc, vec3f velSrc, vec3f posTarget, vec3f velTarget);
 
+// Intercept Time (quadratic): earliest t >= 0 with |(pos2 + vel2 t) - (pos1 + vel1 t)| <= fRadius
+enum InterceptStatus
+{
+	INTERCEPT_OK = 0,				// Time is the earliest contact (0 if already within fRadius)
+	INTERCEPT_NO_RELATIVE_MOTION,	// Same velocity & not in contact: distance never changes (time 0)
+	INTERCEPT_DIVERGING,			// Moving apart: closest approach is now (time 0)
+	INTERCEPT_MISS,					// Closest approach is farther than fRadius (time of closest approach)
+};
+
+// Velocities closer than this (squared relative speed) count as no relative motion
+#define INTERCEPT_EPSILON	1.0e-12f
+
+/**
+ *	Solve |r + v t|^2 = fRadius^2 (r, v: relative position & velocity) for the earliest
+ *	non-negative root. Never produces NaN/inf for finite inputs: pTime always receives a
+ *	finite time (see InterceptStatus) & the status says whether it is a contact.
+ */
+InterceptStatus SolveInterceptTime(vec3f pos1, vec3f vel1, vec3f pos2, vec3f vel2, float fRadius, float* pTime);
+// Batch SolveInterceptTime() over SoA pairs; pTime & pStatus receive pos1.Size() entries
+void SolveInterceptTimes(const vec3fStream& pos1, const vec3fStream& vel1, const vec3fStream& pos2, const vec3fStream& vel2, float fRadius,
+						 float* pTime, InterceptStatus* pStatus);
+
 // 2D
 bool IsWithinRange2D(vec2f posSentry, vec2f dirSentry, float rangeSentry, float halfAngleSentry, vec2f posCheck);
 
+// Words per sentry in the GetVisibility2D() output (one bit per target)
+#define VISIBILITY_WORDS(numTargets)	(((numTargets) + 31) / 32)
+
+/**
+ *	Batch IsWithinRange2D(): every sentry against every target, without acos or sqrt
+ *	(dot product compared against cos(halfAngle) using squared magnitudes).
+ *	pRangeSentries & pHalfAngleSentries hold one value per sentry.
+ *	pVisible receives VISIBILITY_WORDS(posTargets.Size()) words per sentry, row after
+ *	row: bit (t % 32) of word (t / 32) in sentry s's row is set if target t is visible.
+ */
+void GetVisibility2D(const vec2fStream& posSentries, const vec2fStream& dirSentries, const float* pRangeSentries, const float* pHalfAngleSentries,
+					 const vec2fStream& posTargets, uint32_t* pVisible);
+
+// 3D
+// IsWithinRange2D() in 3D: point within range & within halfAngle of dirSentry
+bool IsWithinCone3D(vec3f posSentry, vec3f dirSentry, float rangeSentry, float halfAngleSentry, vec3f posCheck);
+// Any part of the sphere within the cone. :NOTE: The range is treated as a sphere around
+// the sentry grown by the radius, so spheres just past the range cap's rim may pass.
+bool IsSphereWithinCone3D(vec3f posSentry, vec3f dirSentry, float rangeSentry, float halfAngleSentry, vec3f center, float fRadius);
+// Conservative: tests the box's bounding sphere
+bool IsAABBWithinCone3D(vec3f posSentry, vec3f dirSentry, float rangeSentry, float halfAngleSentry, vec3f boundsMin, vec3f boundsMax);
+
+// Frustum test results
+enum FrustumTest
+{
+	FRUSTUM_OUTSIDE = 0,	// Entirely outside one plane
+	FRUSTUM_INTERSECT,		// Not rejected by any plane, but not inside all of them
+	FRUSTUM_INSIDE,			// Entirely inside every plane
+};
+
+#define FRUSTUM_NUM_PLANES	6
+#define FRUSTUM_ALL_PLANES	((1u << FRUSTUM_NUM_PLANES) - 1)
+
+/**
+ *	CLASS: Frustum
+ *	Six planes (left, right, bottom, top, near, far) pulled from a view-projection
+ *	matrix (column vectors: clip = viewProj * vec4f(p, 1)). Plane (a, b, c, d) is
+ *	normalized & faces inward: a point is inside when a x + b y + c z + d >= 0.
+ *
+ *	Hierarchical culling: TestAABB() takes a mask of the planes still worth testing
+ *	& clears the ones the box is entirely inside, so children of a box can skip them
+ *	(start from FRUSTUM_ALL_PLANES at the root; a mask of 0 means fully inside).
+ */
+class Frustum
+{
+protected:
+	vec4f m_planes[FRUSTUM_NUM_PLANES];
+
+public:
+	///////////////////////////////////
+	// Setup & Initialization
+	// Default: contains everything
+	Frustum();
+	/**
+	 *	@param	viewProj			View-projection matrix
+	 *	@param	bDepthZeroToOne		Clip-space depth range is [0, w] (Direct3D) instead of [-w, w] (OpenGL)
+	 */
+	explicit Frustum(const mat44& viewProj, bool bDepthZeroToOne = false);
+	void SetFromMatrix(const mat44& viewProj, bool bDepthZeroToOne = false);
+
+	///////////////////////////////////
+	// Getter/Setters
+	vec4f GetPlane(int idx) const
+	{
+		return m_planes[idx];
+	}
+
+	///////////////////////////////////
+	// Tests
+	bool ContainsPoint(vec3f p) const;
+	FrustumTest TestSphere(vec3f center, float fRadius) const;
+	FrustumTest TestAABB(vec3f boundsMin, vec3f boundsMax, unsigned* pPlaneMask = NULL) const;
+
+	/**
+	 *	Batch culling (SIMD across objects, multithreaded over chunks). pVisible receives
+	 *	VISIBILITY_WORDS(count) words: bit (i % 32) of word (i / 32) is set if object i is
+	 *	not outside (same as Test*() != FRUSTUM_OUTSIDE). Objects stop testing planes
+	 *	once a whole SIMD group has been rejected.
+	 */
+	void CullSpheres(const vec3fStream& centers, const float* pRadii, uint32_t* pVisible) const;
+	void CullAABBs(const vec3fStream& boundsMin, const vec3fStream& boundsMax, uint32_t* pVisible) const;
+};
+
 float Lerp(float f1, float f2, float t);
 vec2f Lerp2D(vec2f p0, vec2f p1, float t);
 vec3f Lerp3D(vec3f p0, vec3f p1, float t);
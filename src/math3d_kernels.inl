@@ -0,0 +1,277 @@
+/**
+ *	FILE: math3d_kernels.inl
+ *	math3d.cpp's batch kernels; included by simd_kernels.inl, once per
+ *	instruction set.
+ */
+
+/**
+ *	Batch kernel for GetTargetIntercept(): same construction (split the target velocity
+ *	into parts parallel & orthogonal to the line of sight, match the orthogonal part),
+ *	with the "can't intercept" case handled by lane selects instead of a branch.
+ *	:NOTE: Like GetTargetIntercept(), missile & target positions must differ.
+ */
+template <class S>
+static void KernelTargetIntercept(const float* const* pPosMsl, const float* pSpeedMsl, const float* const* pPosTarget, const float* const* pVelTarget,
+								  float* const* pDirOut, bool* pCanIntercept, size_t begin, size_t end)
+{
+	typedef typename S::type lane;
+	const lane one = S::Set1(1.0f);
+
+	size_t i = begin;
+	for (; i + S::WIDTH <= end; i += S::WIDTH)
+	{
+		lane m2t[3], vel_target[3];
+		for (int c = 0; c < 3; c++)
+		{
+			m2t[c] = S::Sub(S::Load(pPosTarget[c] + i), S::Load(pPosMsl[c] + i));
+			vel_target[c] = S::Load(pVelTarget[c] + i);
+		}
+		lane speed = S::Load(pSpeedMsl + i);
+
+		// Unit line of sight
+		lane m2t_inv_mag = S::Div(one, S::Sqrt(S::Add(S::Add(S::Mul(m2t[0], m2t[0]), S::Mul(m2t[1], m2t[1])), S::Mul(m2t[2], m2t[2]))));
+		for (int c = 0; c < 3; c++)
+		{
+			m2t[c] = S::Mul(m2t[c], m2t_inv_mag);
+		}
+
+		// Orthogonal target velocity (shared by the missile)
+		lane dot_vt_m2t = S::Add(S::Add(S::Mul(vel_target[0], m2t[0]), S::Mul(vel_target[1], m2t[1])), S::Mul(vel_target[2], m2t[2]));
+		lane vel_o[3];
+		for (int c = 0; c < 3; c++)
+		{
+			vel_o[c] = S::Sub(vel_target[c], S::Mul(dot_vt_m2t, m2t[c]));
+		}
+		lane mag_o_sq = S::Add(S::Add(S::Mul(vel_o[0], vel_o[0]), S::Mul(vel_o[1], vel_o[1])), S::Mul(vel_o[2], vel_o[2]));
+
+		// Intercept possible if the orthogonal speed doesn't exceed the missile speed;
+		// otherwise follow the target's heading
+		typename S::mask can_intercept = S::CmpLE(mag_o_sq, S::Mul(speed, speed));
+		lane mag_p = S::Sqrt(S::Max(S::Sub(S::Mul(speed, speed), mag_o_sq), S::Set1(0.0f)));
+
+		lane vel_msl[3];
+		for (int c = 0; c < 3; c++)
+		{
+			vel_msl[c] = S::Select(can_intercept, S::Add(vel_o[c], S::Mul(mag_p, m2t[c])), vel_target[c]);
+		}
+		lane msl_inv_mag = S::Div(one, S::Sqrt(S::Add(S::Add(S::Mul(vel_msl[0], vel_msl[0]), S::Mul(vel_msl[1], vel_msl[1])), S::Mul(vel_msl[2], vel_msl[2]))));
+		for (int c = 0; c < 3; c++)
+		{
+			S::Store(pDirOut[c] + i, S::Mul(vel_msl[c], msl_inv_mag));
+		}
+
+		int flags = S::MoveMask(can_intercept);
+		for (int lane_idx = 0; lane_idx < S::WIDTH; lane_idx++)
+		{
+			pCanIntercept[i + lane_idx] = (((flags >> lane_idx) & 1) != 0);
+		}
+	}
+
+	if (i < end)
+	{
+		KernelTargetIntercept<SimdScalar>(pPosMsl, pSpeedMsl, pPosTarget, pVelTarget, pDirOut, pCanIntercept, i, end);
+	}
+}
+
+/**
+ *	Quadratic intercept kernel: a t^2 + 2b t + c = 0 with a = v.v, b = r.v, c = r.r - R^2.
+ *	The earlier root is taken as c / (-b + sqrt(b^2 - ac)) to avoid cancellation.
+ *	Every case is computed for every lane & picked with masks.
+ */
+template <class S>
+static void KernelInterceptTime(const float* const* pPos1, const float* const* pVel1, const float* const* pPos2, const float* const* pVel2, float fRadius,
+								float* pTime, InterceptStatus* pStatus, size_t begin, size_t end)
+{
+	typedef typename S::type lane;
+	const lane zero = S::Set1(0.0f);
+	const lane epsilon = S::Set1(INTERCEPT_EPSILON);
+	const lane radius_sq = S::Set1(fRadius * fRadius);
+
+	size_t i = begin;
+	for (; i + S::WIDTH <= end; i += S::WIDTH)
+	{
+		lane r[3], v[3];
+		for (int c = 0; c < 3; c++)
+		{
+			r[c] = S::Sub(S::Load(pPos2[c] + i), S::Load(pPos1[c] + i));
+			v[c] = S::Sub(S::Load(pVel2[c] + i), S::Load(pVel1[c] + i));
+		}
+
+		lane a = S::Add(S::Add(S::Mul(v[0], v[0]), S::Mul(v[1], v[1])), S::Mul(v[2], v[2]));
+		lane b = S::Add(S::Add(S::Mul(r[0], v[0]), S::Mul(r[1], v[1])), S::Mul(r[2], v[2]));
+		lane c = S::Sub(S::Add(S::Add(S::Mul(r[0], r[0]), S::Mul(r[1], r[1])), S::Mul(r[2], r[2])), radius_sq);
+		lane disc = S::Sub(S::Mul(b, b), S::Mul(a, c));
+
+		typename S::mask in_contact = S::CmpLE(c, zero);
+		typename S::mask is_static = S::CmpLE(a, epsilon);
+		typename S::mask approaching = S::CmpLT(b, zero);
+		typename S::mask hit = S::CmpLE(zero, disc);
+
+		lane t_hit = S::Div(c, S::Add(S::Sub(zero, b), S::Sqrt(S::Max(disc, zero))));
+		lane t_closest = S::Div(S::Sub(zero, b), S::Max(a, epsilon));
+
+		lane t = S::Select(hit, t_hit, t_closest);
+		t = S::Select(approaching, t, zero);
+		t = S::Select(is_static, zero, t);
+		t = S::Select(in_contact, zero, t);
+		S::Store(pTime + i, t);
+
+		int bits_contact = S::MoveMask(in_contact);
+		int bits_static = S::MoveMask(is_static);
+		int bits_approaching = S::MoveMask(approaching);
+		int bits_hit = S::MoveMask(hit);
+		for (int lane_idx = 0; lane_idx < S::WIDTH; lane_idx++)
+		{
+			int bit = (1 << lane_idx);
+			InterceptStatus status = INTERCEPT_OK;
+			if (!(bits_contact & bit))
+			{
+				if (bits_static & bit)
+				{
+					status = INTERCEPT_NO_RELATIVE_MOTION;
+				}
+				else if (!(bits_approaching & bit))
+				{
+					status = INTERCEPT_DIVERGING;
+				}
+				else if (!(bits_hit & bit))
+				{
+					status = INTERCEPT_MISS;
+				}
+			}
+			pStatus[i + lane_idx] = status;
+		}
+	}
+
+	if (i < end)
+	{
+		KernelInterceptTime<SimdScalar>(pPos1, pVel1, pPos2, pVel2, fRadius, pTime, pStatus, i, end);
+	}
+}
+
+/**
+ *	Visibility of targets [begin, end) for one sentry. With d = target - sentry & c = cos(halfAngle):
+ *		angle <= halfAngle  <=>  dot(dir, d) >= c |dir| |d|
+ *	squared (no sqrt) as dot^2 >= c^2 |dir|^2 |d|^2 with dot >= 0 when c >= 0, or as
+ *	dot >= 0 || dot^2 <= c^2 |dir|^2 |d|^2 when c < 0. A target on top of the sentry is
+ *	never visible (IsWithinRange2D() gets NaN there).
+ */
+template <class S>
+static void KernelVisibility2D(float sentryX, float sentryY, float dirX, float dirY, float fRangeSq, float fCosSqDirSq, bool bWideAngle,
+							   const float* pTargetX, const float* pTargetY, uint32_t* pRow, size_t begin, size_t end)
+{
+	typedef typename S::type lane;
+	const lane zero = S::Set1(0.0f);
+	const lane sentry_x = S::Set1(sentryX);
+	const lane sentry_y = S::Set1(sentryY);
+	const lane dir_x = S::Set1(dirX);
+	const lane dir_y = S::Set1(dirY);
+	const lane range_sq = S::Set1(fRangeSq);
+	const lane cos_sq_dir_sq = S::Set1(fCosSqDirSq);
+
+	size_t i = begin;
+	for (; i + S::WIDTH <= end; i += S::WIDTH)
+	{
+		lane dist_x = S::Sub(S::Load(pTargetX + i), sentry_x);
+		lane dist_y = S::Sub(S::Load(pTargetY + i), sentry_y);
+		lane dist_sq = S::Add(S::Mul(dist_x, dist_x), S::Mul(dist_y, dist_y));
+		lane dp = S::Add(S::Mul(dir_x, dist_x), S::Mul(dir_y, dist_y));
+
+		typename S::mask in_range = S::And(S::CmpLE(dist_sq, range_sq), S::CmpLT(zero, dist_sq));
+		lane dp_sq = S::Mul(dp, dp);
+		lane limit_sq = S::Mul(cos_sq_dir_sq, dist_sq);
+
+		int bits;
+		if (bWideAngle)
+		{
+			bits = S::MoveMask(in_range) & (S::MoveMask(S::CmpLE(zero, dp)) | S::MoveMask(S::CmpLE(dp_sq, limit_sq)));
+		}
+		else
+		{
+			bits = S::MoveMask(S::And(in_range, S::And(S::CmpLE(zero, dp), S::CmpLE(limit_sq, dp_sq))));
+		}
+
+		pRow[i / 32] |= ((uint32_t)bits << (i % 32));
+	}
+
+	if (i < end)
+	{
+		KernelVisibility2D<SimdScalar>(sentryX, sentryY, dirX, dirY, fRangeSq, fCosSqDirSq, bWideAngle, pTargetX, pTargetY, pRow, i, end);
+	}
+}
+
+// Sphere i is visible if no plane is farther than its radius behind it
+template <class S>
+static void KernelCullSpheres(const vec4f* pPlanes, const float* pX, const float* pY, const float* pZ, const float* pRadius,
+							  uint32_t* pVisible, size_t begin, size_t end)
+{
+	typedef typename S::type lane;
+	const lane zero = S::Set1(0.0f);
+
+	size_t i = begin;
+	for (; i + S::WIDTH <= end; i += S::WIDTH)
+	{
+		lane x = S::Load(pX + i);
+		lane y = S::Load(pY + i);
+		lane z = S::Load(pZ + i);
+		lane neg_radius = S::Sub(zero, S::Load(pRadius + i));
+
+		typename S::mask visible;
+		for (int p = 0; p < FRUSTUM_NUM_PLANES; p++)
+		{
+			const vec4f& plane = pPlanes[p];
+			lane dist = S::Add(S::Add(S::Add(S::Mul(S::Set1(plane[0]), x), S::Mul(S::Set1(plane[1]), y)), S::Mul(S::Set1(plane[2]), z)), S::Set1(plane[3]));
+			typename S::mask in_front = S::CmpLE(neg_radius, dist);
+			visible = (p == 0 ? in_front : S::And(visible, in_front));
+
+			// Whole group rejected: skip the remaining planes
+			if (S::MoveMask(visible) == 0)
+			{
+				break;
+			}
+		}
+
+		pVisible[i / 32] |= ((uint32_t)S::MoveMask(visible) << (i % 32));
+	}
+
+	if (i < end)
+	{
+		KernelCullSpheres<SimdScalar>(pPlanes, pX, pY, pZ, pRadius, pVisible, i, end);
+	}
+}
+
+// Box i is visible if, for every plane, its corner farthest along the normal is in front
+template <class S>
+static void KernelCullAABBs(const vec4f* pPlanes, const float* const* pMin, const float* const* pMax, uint32_t* pVisible, size_t begin, size_t end)
+{
+	typedef typename S::type lane;
+	const lane zero = S::Set1(0.0f);
+
+	size_t i = begin;
+	for (; i + S::WIDTH <= end; i += S::WIDTH)
+	{
+		typename S::mask visible;
+		for (int p = 0; p < FRUSTUM_NUM_PLANES; p++)
+		{
+			const vec4f& plane = pPlanes[p];
+			lane x = S::Load((plane[0] >= 0.0f ? pMax[0] : pMin[0]) + i);
+			lane y = S::Load((plane[1] >= 0.0f ? pMax[1] : pMin[1]) + i);
+			lane z = S::Load((plane[2] >= 0.0f ? pMax[2] : pMin[2]) + i);
+			lane dist = S::Add(S::Add(S::Add(S::Mul(S::Set1(plane[0]), x), S::Mul(S::Set1(plane[1]), y)), S::Mul(S::Set1(plane[2]), z)), S::Set1(plane[3]));
+			typename S::mask in_front = S::CmpLE(zero, dist);
+			visible = (p == 0 ? in_front : S::And(visible, in_front));
+
+			if (S::MoveMask(visible) == 0)
+			{
+				break;
+			}
+		}
+
+		pVisible[i / 32] |= ((uint32_t)S::MoveMask(visible) << (i % 32));
+	}
+
+	if (i < end)
+	{
+		KernelCullAABBs<SimdScalar>(pPlanes, pMin, pMax, pVisible, i, end);
+	}
+}
@@ -0,0 +1,397 @@
+#include "parallel.h"
+
+// Includes: Standard
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Includes: Platform (worker pinning)
+#if defined _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// Chunks per participating thread: more than one, so threads that finish early have something to steal
+#define PARALLEL_CHUNKS_PER_THREAD	4
+// Pin each worker to one core (round-robin over the cores the process may run on). The calling
+// thread isn't pinned, so the first core is left for it.
+#define PARALLEL_PIN_WORKERS		1
+
+static std::atomic<unsigned> s_numThreads(0);	// 0: Use hardware thread count
+
+// > 0 while this thread runs a chunk: nested ParallelFor() calls run inline
+static thread_local unsigned s_parallelDepth = 0;
+
+unsigned GetParallelThreadCount()
+{
+	unsigned num_threads = s_numThreads.load(std::memory_order_relaxed);
+	if (num_threads == 0)
+	{
+		// :NOTE: Queried once; hardware_concurrency() can cost a few microseconds per call (it may read /sys)
+		static const unsigned s_numHardware = std::thread::hardware_concurrency();
+		return (s_numHardware > 0 ? (s_numHardware < PARALLEL_MAX_THREADS ? s_numHardware : PARALLEL_MAX_THREADS) : 1);
+	}
+	return num_threads;
+}
+
+void SetParallelThreadCount(unsigned numThreads)
+{
+	s_numThreads = (numThreads < PARALLEL_MAX_THREADS ? numThreads : PARALLEL_MAX_THREADS);
+}
+
+//////////////////////////////////////////////////////////
+// Jobs
+//////////////////////////////////////////////////////////
+
+/**
+ *	One ParallelFor() call. Chunks [0, numChunks) start out split evenly between the
+ *	participants' ranges. Each participant pops chunks off the front of its own range;
+ *	once that's empty it steals the back half of another participant's range.
+ *
+ *	A range is packed as (begin << 32 | end) in one atomic, so pops & steals are a
+ *	single compare-exchange. (The packed value fully describes the range's chunks,
+ *	so a compare-exchange that succeeds after an A-B-A change is still correct.)
+ *
+ *	:NOTE: Shared (reference-counted) because a worker can pick a job up after the
+ *	caller has already returned; it then finds every range empty & never calls fnRange.
+ */
+struct ParallelJob
+{
+	// One range per participant, padded so neighbouring ranges don't share a cache line
+	struct Range
+	{
+		std::atomic<uint64_t> bounds;
+		char padding[64 - sizeof(std::atomic<uint64_t>)];
+	};
+
+	const std::function<void(size_t, size_t)>* pFnRange;
+	size_t chunkSize;			// count / numChunks
+	size_t chunkExtra;			// count % numChunks: the first chunkExtra chunks get one more index
+	uint32_t numChunks;
+	uint32_t numParticipants;	// Calling thread (participant 0) + workers
+	std::atomic<uint32_t> numChunksLeft;	// Not yet completed
+	std::unique_ptr<Range[]> ranges;
+
+	static uint64_t PackRange(uint32_t begin, uint32_t end)
+	{
+		return ((uint64_t)begin << 32) | end;
+	}
+
+	// Pop the first chunk of participant idx's own range
+	bool PopChunk(uint32_t idx, uint32_t* pChunk)
+	{
+		std::atomic<uint64_t>& bounds = ranges[idx].bounds;
+		uint64_t packed = bounds.load(std::memory_order_acquire);
+		for (;;)
+		{
+			uint32_t begin = (uint32_t)(packed >> 32);
+			uint32_t end = (uint32_t)packed;
+			if (begin >= end)
+			{
+				return false;
+			}
+			if (bounds.compare_exchange_weak(packed, PackRange(begin + 1, end), std::memory_order_acq_rel, std::memory_order_acquire))
+			{
+				*pChunk = begin;
+				return true;
+			}
+		}
+	}
+
+	// Move the back half of the first non-empty range after idx's into idx's (empty) range
+	bool StealChunks(uint32_t idx)
+	{
+		for (uint32_t i = 1; i < numParticipants; i++)
+		{
+			std::atomic<uint64_t>& bounds = ranges[(idx + i) % numParticipants].bounds;
+			uint64_t packed = bounds.load(std::memory_order_acquire);
+			for (;;)
+			{
+				uint32_t begin = (uint32_t)(packed >> 32);
+				uint32_t end = (uint32_t)packed;
+				if (begin >= end)
+				{
+					break;
+				}
+
+				uint32_t mid = end - (end - begin + 1) / 2;
+				if (bounds.compare_exchange_weak(packed, PackRange(begin, mid), std::memory_order_acq_rel, std::memory_order_acquire))
+				{
+					// :NOTE: Only the owner refills its range, & only while it's empty (so no one else writes it)
+					ranges[idx].bounds.store(PackRange(mid, end), std::memory_order_release);
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	// Run chunks (own, then stolen) until there are none left to take
+	void Participate(uint32_t idx)
+	{
+		s_parallelDepth++;
+		uint32_t chunk;
+		for (;;)
+		{
+			if (!PopChunk(idx, &chunk))
+			{
+				if (!StealChunks(idx))
+				{
+					break;
+				}
+				continue;
+			}
+
+			size_t begin = (chunk * chunkSize) + (chunk < chunkExtra ? chunk : chunkExtra);
+			size_t end = begin + chunkSize + (chunk < chunkExtra ? 1 : 0);
+			(*pFnRange)(begin, end);
+			numChunksLeft.fetch_sub(1, std::memory_order_acq_rel);
+		}
+		s_parallelDepth--;
+	}
+};
+
+//////////////////////////////////////////////////////////
+// Worker pool
+//////////////////////////////////////////////////////////
+
+/**
+ *	CLASS: ParallelPool
+ *	Persistent worker threads, each with its own queue of jobs to join. Grows (never
+ *	shrinks) to the largest thread count asked for; workers stop at program exit.
+ */
+class ParallelPool
+{
+protected:
+	struct Work
+	{
+		std::shared_ptr<ParallelJob> job;
+		uint32_t idxParticipant;
+	};
+
+	struct Worker
+	{
+		std::thread thread;
+		std::mutex mutex;
+		std::condition_variable cv;
+		std::deque<Work> queue;
+		bool bStop;
+
+		Worker() : bStop(false) {}
+	};
+
+	std::mutex m_mutexGrow;
+	std::unique_ptr<Worker> m_workers[PARALLEL_MAX_THREADS];
+	std::atomic<unsigned> m_numWorkers;
+	std::vector<unsigned> m_cpus;	// Cores this process may run on (for pinning)
+
+	static void RunWorker(Worker* pWorker, int cpu)
+	{
+		PinThread(cpu);
+		for (;;)
+		{
+			Work work;
+			{
+				std::unique_lock<std::mutex> lock(pWorker->mutex);
+				pWorker->cv.wait(lock, [pWorker]() { return pWorker->bStop || !pWorker->queue.empty(); });
+				if (pWorker->queue.empty())
+				{
+					return;
+				}
+				work = pWorker->queue.front();
+				pWorker->queue.pop_front();
+			}
+			work.job->Participate(work.idxParticipant);
+		}
+	}
+
+	static void PinThread(int cpu)
+	{
+#if PARALLEL_PIN_WORKERS
+		if (cpu < 0)
+		{
+			return;
+		}
+#if defined _WIN32
+		if (cpu < (int)(8 * sizeof(DWORD_PTR)))
+		{
+			SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu);
+		}
+#elif defined __linux__
+		cpu_set_t cpu_set;
+		CPU_ZERO(&cpu_set);
+		CPU_SET(cpu, &cpu_set);
+		pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+#endif
+#else
+		(void)cpu;
+#endif
+	}
+
+	void InitCpus()
+	{
+#if defined _WIN32
+		DWORD_PTR mask_process, mask_system;
+		if (GetProcessAffinityMask(GetCurrentProcess(), &mask_process, &mask_system))
+		{
+			for (unsigned cpu = 0; cpu < 8 * sizeof(DWORD_PTR); cpu++)
+			{
+				if ((mask_process >> cpu) & 1)
+				{
+					m_cpus.push_back(cpu);
+				}
+			}
+		}
+#elif defined __linux__
+		cpu_set_t cpu_set;
+		CPU_ZERO(&cpu_set);
+		if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0)
+		{
+			for (unsigned cpu = 0; cpu < CPU_SETSIZE; cpu++)
+			{
+				if (CPU_ISSET(cpu, &cpu_set))
+				{
+					m_cpus.push_back(cpu);
+				}
+			}
+		}
+#endif
+	}
+
+public:
+	ParallelPool() : m_numWorkers(0)
+	{
+		InitCpus();
+	}
+
+	~ParallelPool()
+	{
+		unsigned num_workers = m_numWorkers.load();
+		for (unsigned i = 0; i < num_workers; i++)
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_workers[i]->mutex);
+				m_workers[i]->bStop = true;
+			}
+			m_workers[i]->cv.notify_one();
+		}
+		for (unsigned i = 0; i < num_workers; i++)
+		{
+			m_workers[i]->thread.join();
+		}
+	}
+
+	// Start workers until there are at least numWorkers
+	void Reserve(unsigned numWorkers)
+	{
+		if (m_numWorkers.load(std::memory_order_acquire) >= numWorkers)
+		{
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutexGrow);
+		unsigned num_workers = m_numWorkers.load(std::memory_order_relaxed);
+		for (; num_workers < numWorkers; num_workers++)
+		{
+			// Worker i on the (i + 1)th allowed core, wrapping around
+			int cpu = (m_cpus.size() > 1 ? (int)m_cpus[(num_workers + 1) % m_cpus.size()] : -1);
+			m_workers[num_workers].reset(new Worker());
+			m_workers[num_workers]->thread = std::thread(RunWorker, m_workers[num_workers].get(), cpu);
+		}
+		m_numWorkers.store(num_workers, std::memory_order_release);
+	}
+
+	// Have worker idxWorker (< Reserve()d count) join the job as participant idxParticipant
+	void Post(unsigned idxWorker, const std::shared_ptr<ParallelJob>& job, uint32_t idxParticipant)
+	{
+		Worker& worker = *m_workers[idxWorker];
+		{
+			std::lock_guard<std::mutex> lock(worker.mutex);
+			Work work = { job, idxParticipant };
+			worker.queue.push_back(work);
+		}
+		worker.cv.notify_one();
+	}
+};
+
+static ParallelPool& GetParallelPool()
+{
+	static ParallelPool s_pool;
+	return s_pool;
+}
+
+//////////////////////////////////////////////////////////
+// ParallelFor
+//////////////////////////////////////////////////////////
+
+void ParallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& fnRange)
+{
+	if (count == 0)
+	{
+		return;
+	}
+	if (grainSize == 0)
+	{
+		grainSize = 1;
+	}
+
+	// Determine how many chunks we can make without going under the grain size
+	size_t num_threads = GetParallelThreadCount();
+	size_t num_chunks = (count + grainSize - 1) / grainSize;
+	if (num_chunks > num_threads * PARALLEL_CHUNKS_PER_THREAD)
+	{
+		num_chunks = num_threads * PARALLEL_CHUNKS_PER_THREAD;
+	}
+	size_t num_participants = (num_chunks < num_threads ? num_chunks : num_threads);
+
+	// Not worth waking workers (or already inside a chunk): run on the caller
+	if (num_participants <= 1 || s_parallelDepth > 0)
+	{
+		fnRange(0, count);
+		return;
+	}
+
+	std::shared_ptr<ParallelJob> job = std::make_shared<ParallelJob>();
+	job->pFnRange = &fnRange;
+	job->chunkSize = count / num_chunks;
+	job->chunkExtra = count % num_chunks;
+	job->numChunks = (uint32_t)num_chunks;
+	job->numParticipants = (uint32_t)num_participants;
+	job->numChunksLeft.store((uint32_t)num_chunks, std::memory_order_relaxed);
+	job->ranges.reset(new ParallelJob::Range[num_participants]);
+
+	// Spread the chunks evenly over the participants
+	for (size_t i = 0; i < num_participants; i++)
+	{
+		uint32_t begin = (uint32_t)(i * num_chunks / num_participants);
+		uint32_t end = (uint32_t)((i + 1) * num_chunks / num_participants);
+		job->ranges[i].bounds.store(ParallelJob::PackRange(begin, end), std::memory_order_relaxed);
+	}
+
+	ParallelPool& pool = GetParallelPool();
+	pool.Reserve((unsigned)num_participants - 1);
+	for (uint32_t i = 1; i < num_participants; i++)
+	{
+		pool.Post(i - 1, job, i);
+	}
+
+	// Calling thread is participant 0, then waits for chunks still running on workers
+	job->Participate(0);
+	while (job->numChunksLeft.load(std::memory_order_acquire) != 0)
+	{
+		std::this_thread::yield();
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+#ifndef __PARALLEL_H__
+#define __PARALLEL_H__
+
+/**
+ *	FILE: parallel.h
+ *	Minimal helpers for splitting bulk math jobs across threads.
+ *
+ *	ParallelFor() runs on a persistent pool of worker threads (started on first
+ *	use, pinned one per core) instead of spawning threads per call. Each call is
+ *	split into a few chunks per thread; every thread works through its own share
+ *	& then steals the back half of a busier thread's share, so uneven chunks
+ *	still finish together.
+ */
+
+// Includes: Standard
+#include <stddef.h>
+#include <functional>
+
+// Upper limit on SetParallelThreadCount() (calling thread included)
+#define PARALLEL_MAX_THREADS	256
+
+// Number of threads ParallelFor() may use, the calling thread included (defaults to the hardware thread count)
+unsigned GetParallelThreadCount();
+// 0: hardware thread count. Calls already running keep the count they started with.
+void SetParallelThreadCount(unsigned numThreads);
+
+/**
+ *	Split the index range [0, count) into contiguous chunks of at least
+ *	grainSize indices and call fnRange(begin, end) for each chunk, spread
+ *	across the calling thread & the pool's workers. Small ranges run entirely
+ *	on the calling thread, as do ParallelFor() calls made from inside fnRange.
+ *	Returns once every chunk has completed.
+ */
+void ParallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& fnRange);
+
+#endif // #ifndef __PARALLEL_H__
@@ -1,8 +1,12 @@
 #include "quat.h"
+#include "vecstream.h"
+#include "simd.h"
+#include "parallel.h"
+#include "trig.h"
 
 Quaternion::Quaternion(float i /*= 0.0f*/, float j /*= 0.0f*/, float k /*= 0.0f*/, float w /*= 0.0f*/) :
-	m_vecPure(i, j, k),
-	m_valReal(w)
+	m_valReal(w),
+	m_vecPure(i, j, k)
 {
 }
 
@@ -69,8 +73,8 @@ Quaternion Quaternion::GetInverse() const
 **/
 vec3f Quaternion::RotateVectorR(vec3f vecInitial, vec3f vecRot, float angleRadians)
 {
-	float cos_hrot = cos(angleRadians / 2.0f);
-	float sin_hrot = sin(angleRadians / 2.0f);
+	float sin_hrot, cos_hrot;
+	SinCos(angleRadians * 0.5f, sin_hrot, cos_hrot);
 
 	// Normalize vector
 	vecRot.Normalize();
@@ -97,6 +101,289 @@ vec3f Quaternion::RotateVectorD(vec3f vecInitial, vec3f vecRot, float angleDegre
 	return RotateVectorR(vecInitial, vecRot, DegreesToRadians(angleDegrees));
 }
 
+/**
+*	Build the unit rotation quaternion (sin(a/2) * axis, cos(a/2))
+*	@param	vecAxis			Vector to rotate around (normalized here)
+*	@param	angleRadians	How much to rotate around vecAxis (radians)
+*	@return rotation		Unit quaternion for RotateVector(s)()
+**/
+Quaternion Quaternion::GetRotationR(vec3f vecAxis, float angleRadians)
+{
+	float sin_hrot, cos_hrot;
+	SinCos(angleRadians * 0.5f, sin_hrot, cos_hrot);
+
+	vecAxis.Normalize();
+	return Quaternion(sin_hrot * vecAxis, cos_hrot);
+}
+
+// Reduces in degrees (see SinCosD()), so multiples of 180 degrees give exact quaternions
+Quaternion Quaternion::GetRotationD(vec3f vecAxis, float angleDegrees)
+{
+	float sin_hrot, cos_hrot;
+	SinCosD(angleDegrees * 0.5f, sin_hrot, cos_hrot);
+
+	vecAxis.Normalize();
+	return Quaternion(sin_hrot * vecAxis, cos_hrot);
+}
+
+// BULK ROTATION
+
+// Below this many elements per thread, bulk rotations/interpolations stay on the calling thread
+#define QUAT_BULK_GRAIN		(1 << 16)
+// AoS input is rotated in blocks of this many vectors, transposed to SoA on the stack
+#define QUAT_ROTATE_BLOCK		256
+
+static_assert(sizeof(vec3f) == 3 * sizeof(float), "Bulk rotations assume tightly packed vec3f");
+
+// Batch kernels, one copy per instruction set (see simd_kernels.inl)
+#define SIMD_KERNEL_FILE "quat_kernels.inl"
+#include "simd_kernels.inl"
+
+vec3f Quaternion::RotateVector(vec3f v) const
+{
+	const float qx = m_vecPure[0], qy = m_vecPure[1], qz = m_vecPure[2], qw = m_valReal;
+
+	float tx = (qy * v[2]) - (qz * v[1]);
+	float ty = (qz * v[0]) - (qx * v[2]);
+	float tz = (qx * v[1]) - (qy * v[0]);
+	tx += tx;
+	ty += ty;
+	tz += tz;
+
+	return vec3f((v[0] + (qw * tx)) + ((qy * tz) - (qz * ty)),
+				 (v[1] + (qw * ty)) + ((qz * tx) - (qx * tz)),
+				 (v[2] + (qw * tz)) + ((qx * ty) - (qy * tx)));
+}
+
+void Quaternion::RotateVectors(const vec3f* pVecs, vec3f* pResult, size_t count) const
+{
+	const float q[4] = { m_vecPure[0], m_vecPure[1], m_vecPure[2], m_valReal };
+	const float* p_vecs = reinterpret_cast<const float*>(pVecs);
+	float* p_result = reinterpret_cast<float*>(pResult);
+
+	ParallelFor(count, QUAT_BULK_GRAIN, [&](size_t begin, size_t end)
+	{
+		float block[3][QUAT_ROTATE_BLOCK];
+		float* p_block[3] = { block[0], block[1], block[2] };
+
+		for (size_t block_begin = begin; block_begin < end; block_begin += QUAT_ROTATE_BLOCK)
+		{
+			size_t block_count = end - block_begin;
+			if (block_count > QUAT_ROTATE_BLOCK)
+			{
+				block_count = QUAT_ROTATE_BLOCK;
+			}
+
+			// Deinterleave, rotate in place, reinterleave
+			const float* p_in = p_vecs + (block_begin * 3);
+			for (size_t i = 0; i < block_count; i++)
+			{
+				block[0][i] = p_in[i * 3 + 0];
+				block[1][i] = p_in[i * 3 + 1];
+				block[2][i] = p_in[i * 3 + 2];
+			}
+
+			SIMD_DISPATCH(KernelRotate, (q, p_block, p_block, 0, block_count));
+
+			float* p_out = p_result + (block_begin * 3);
+			for (size_t i = 0; i < block_count; i++)
+			{
+				p_out[i * 3 + 0] = block[0][i];
+				p_out[i * 3 + 1] = block[1][i];
+				p_out[i * 3 + 2] = block[2][i];
+			}
+		}
+	});
+}
+
+void Quaternion::RotateVectors(const vec3fStream& vecs, vec3fStream& rResult) const
+{
+	const float q[4] = { m_vecPure[0], m_vecPure[1], m_vecPure[2], m_valReal };
+
+	size_t count = vecs.Size();
+	rResult.Resize(count);
+
+	const float* p_in[3] = { vecs.X(), vecs.Y(), vecs.Z() };
+	float* p_out[3] = { rResult.X(), rResult.Y(), rResult.Z() };
+
+	ParallelFor(count, QUAT_BULK_GRAIN, [&](size_t begin, size_t end)
+	{
+		SIMD_DISPATCH(KernelRotate, (q, p_in, p_out, begin, end));
+	});
+}
+
+void Quaternion::GetRotationsD(const vec3fStream& axes, const float* pAnglesDegrees, vec4fStream& rResult)
+{
+	size_t count = axes.Size();
+	rResult.Resize(count);
+
+	const float* p_axes[3] = { axes.X(), axes.Y(), axes.Z() };
+	float* p_out[4] = { rResult.X(), rResult.Y(), rResult.Z(), rResult.W() };
+
+	ParallelFor(count, QUAT_BULK_GRAIN, [&](size_t begin, size_t end)
+	{
+		// Half angles into W, then sines into X & cosines over W (batched, so no libm calls)
+		for (size_t i = begin; i < end; i++)
+		{
+			p_out[3][i] = pAnglesDegrees[i] * 0.5f;
+		}
+		SinCosD(p_out[3] + begin, p_out[0] + begin, p_out[3] + begin, end - begin);
+
+		// Same operations as GetRotationD(): normalize the axis, then scale it by the sine
+		for (size_t i = begin; i < end; i++)
+		{
+			float x = p_axes[0][i], y = p_axes[1][i], z = p_axes[2][i];
+			float mag = sqrtf(((x * x) + (y * y)) + (z * z));
+			float sin_hrot = p_out[0][i];
+			p_out[0][i] = sin_hrot * (x / mag);
+			p_out[1][i] = sin_hrot * (y / mag);
+			p_out[2][i] = sin_hrot * (z / mag);
+		}
+	});
+}
+
+
+mat33 Quaternion::GetRotationMatrix33() const
+{
+	const float x = m_vecPure[0], y = m_vecPure[1], z = m_vecPure[2], w = m_valReal;
+
+	float xx = x * x, yy = y * y, zz = z * z;
+	float xy = x * y, xz = x * z, yz = y * z;
+	float wx = w * x, wy = w * y, wz = w * z;
+
+	return mat33
+	(
+		vec3f(1.0f - 2.0f * (yy + zz), 2.0f * (xy - wz), 2.0f * (xz + wy)),
+		vec3f(2.0f * (xy + wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz - wx)),
+		vec3f(2.0f * (xz - wy), 2.0f * (yz + wx), 1.0f - 2.0f * (xx + yy))
+	);
+}
+
+mat44 Quaternion::GetRotationMatrix44() const
+{
+	mat33 mat_rot = GetRotationMatrix33();
+	return mat44
+	(
+		vec4f(mat_rot[0][0], mat_rot[0][1], mat_rot[0][2], 0.0f),
+		vec4f(mat_rot[1][0], mat_rot[1][1], mat_rot[1][2], 0.0f),
+		vec4f(mat_rot[2][0], mat_rot[2][1], mat_rot[2][2], 0.0f),
+		vec4f(0.0f, 0.0f, 0.0f, 1.0f)
+	);
+}
+
+/**
+*	Extract the rotation of a matrix (Shepperd's method: divide by the largest of
+*	4w^2, 4x^2, 4y^2, 4z^2 so the result stays accurate for any angle)
+*	@param	matRot		Orthonormal rotation matrix
+*	@return rotation	Unit quaternion
+**/
+Quaternion Quaternion::GetRotationFromMatrix(const mat33& matRot)
+{
+	const mat33& m = matRot;
+	float trace = m[0][0] + m[1][1] + m[2][2];
+
+	Quaternion q_result;
+	if (trace > 0.0f)
+	{
+		float s = sqrtf(trace + 1.0f) * 2.0f;	// 4w
+		q_result = Quaternion((m[2][1] - m[1][2]) / s, (m[0][2] - m[2][0]) / s, (m[1][0] - m[0][1]) / s, 0.25f * s);
+	}
+	else if (m[0][0] > m[1][1] && m[0][0] > m[2][2])
+	{
+		float s = sqrtf(1.0f + m[0][0] - m[1][1] - m[2][2]) * 2.0f;	// 4x
+		q_result = Quaternion(0.25f * s, (m[0][1] + m[1][0]) / s, (m[0][2] + m[2][0]) / s, (m[2][1] - m[1][2]) / s);
+	}
+	else if (m[1][1] > m[2][2])
+	{
+		float s = sqrtf(1.0f + m[1][1] - m[0][0] - m[2][2]) * 2.0f;	// 4y
+		q_result = Quaternion((m[0][1] + m[1][0]) / s, 0.25f * s, (m[1][2] + m[2][1]) / s, (m[0][2] - m[2][0]) / s);
+	}
+	else
+	{
+		float s = sqrtf(1.0f + m[2][2] - m[0][0] - m[1][1]) * 2.0f;	// 4z
+		q_result = Quaternion((m[0][2] + m[2][0]) / s, (m[1][2] + m[2][1]) / s, 0.25f * s, (m[1][0] - m[0][1]) / s);
+	}
+
+	q_result.Normalize();
+	return q_result;
+}
+
+Quaternion Quaternion::GetRotationFromMatrix(const mat44& matRot)
+{
+	return GetRotationFromMatrix(mat33
+	(
+		vec3f(matRot[0][0], matRot[0][1], matRot[0][2]),
+		vec3f(matRot[1][0], matRot[1][1], matRot[1][2]),
+		vec3f(matRot[2][0], matRot[2][1], matRot[2][2])
+	));
+}
+
+
+// INTERPOLATION
+
+// Above this |cos(angle)| Slerp() falls back to a normalized lerp (sin(angle) ~ 0)
+#define QUAT_SLERP_LINEAR_THRESHOLD	0.9995f
+
+Quaternion Quaternion::Slerp(Quaternion q0, Quaternion q1, float t)
+{
+	float cos_theta = (q0.w() * q1.w()) + vec3f::DotProduct(q0.GetImaginaryVector(), q1.GetImaginaryVector());
+
+	// Take the shorter arc (q & -q are the same rotation)
+	if (cos_theta < 0.0f)
+	{
+		q1 = -1.0f * q1;
+		cos_theta = -cos_theta;
+	}
+
+	float weight0, weight1;
+	if (cos_theta > QUAT_SLERP_LINEAR_THRESHOLD)
+	{
+		weight0 = 1.0f - t;
+		weight1 = t;
+	}
+	else
+	{
+		float theta = acosf(cos_theta);
+		float sin_theta_inv = 1.0f / sinf(theta);
+		weight0 = sinf((1.0f - t) * theta) * sin_theta_inv;
+		weight1 = sinf(t * theta) * sin_theta_inv;
+	}
+
+	Quaternion q_result((weight0 * q0.GetImaginaryVector()) + (weight1 * q1.GetImaginaryVector()), (weight0 * q0.w()) + (weight1 * q1.w()));
+	q_result.Normalize();
+	return q_result;
+}
+
+Quaternion Quaternion::Nlerp(Quaternion q0, Quaternion q1, float t)
+{
+	// Single-lane run of the batch kernel so Nlerp() & the batched version always agree
+	float vals0[4] = { q0.i(), q0.j(), q0.k(), q0.w() };
+	float vals1[4] = { q1.i(), q1.j(), q1.k(), q1.w() };
+	float vals_result[4];
+
+	const float* p_quat0[4] = { &vals0[0], &vals0[1], &vals0[2], &vals0[3] };
+	const float* p_quat1[4] = { &vals1[0], &vals1[1], &vals1[2], &vals1[3] };
+	float* p_result[4] = { &vals_result[0], &vals_result[1], &vals_result[2], &vals_result[3] };
+	simd_base::KernelNlerp<SimdScalar>(p_quat0, p_quat1, t, p_result, 0, 1);
+
+	return Quaternion(vals_result[0], vals_result[1], vals_result[2], vals_result[3]);
+}
+
+void Quaternion::Nlerp(const vec4fStream& quats0, const vec4fStream& quats1, float t, vec4fStream& rResult)
+{
+	size_t count = quats0.Size();
+	rResult.Resize(count);
+
+	const float* p_quats0[4] = { quats0.X(), quats0.Y(), quats0.Z(), quats0.W() };
+	const float* p_quats1[4] = { quats1.X(), quats1.Y(), quats1.Z(), quats1.W() };
+	float* p_out[4] = { rResult.X(), rResult.Y(), rResult.Z(), rResult.W() };
+
+	ParallelFor(count, QUAT_BULK_GRAIN, [&](size_t begin, size_t end)
+	{
+		SIMD_DISPATCH(KernelNlerp, (p_quats0, p_quats1, t, p_out, begin, end));
+	});
+}
+
 
 Quaternion operator*(float fScalar, Quaternion q)
 {
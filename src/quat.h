@@ -2,7 +2,15 @@
 #ifndef __QUAT_H__
 #define __QUAT_H__
 
+#include <stddef.h>
 #include "vec.h"
+#include "mat.h"
+
+class vec3fStream;
+class vec4fStream;
+
+// Identity rotation (0i + 0j + 0k + 1)
+#define QUAT_IDENTITY	Quaternion(0.0f, 0.0f, 0.0f, 1.0f)
 
 class Quaternion
 {
@@ -75,6 +83,40 @@ public:
 
 	static vec3f RotateVectorR(vec3f vecInitial, vec3f vecRot, float angleRadians);
 	static vec3f RotateVectorD(vec3f vecInitial, vec3f vecRot, float angleDegrees);
+
+	// Unit quaternion rotating by an angle around vecAxis (vecAxis need not be normalized).
+	// Build once, then rotate any number of vectors with RotateVector(s)().
+	static Quaternion GetRotationR(vec3f vecAxis, float angleRadians);
+	static Quaternion GetRotationD(vec3f vecAxis, float angleDegrees);
+	// Batched GetRotationD(), one rotation per axis, as SoA (i, j, k, w) = (X, Y, Z, W).
+	// rResult is resized to axes.Size(); results match GetRotationD() exactly.
+	static void GetRotationsD(const vec3fStream& axes, const float* pAnglesDegrees, vec4fStream& rResult);
+
+	// Rotate by this (unit) quaternion using v + 2w(q x v) + 2q x (q x v),
+	// i.e. t = 2(q x v), v' = v + w*t + q x t: no Hamilton products or trig.
+	vec3f RotateVector(vec3f v) const;
+	// Bulk versions (SIMD & multithreaded for large counts); pResult/rResult may be the input.
+	// Results match RotateVector() exactly.
+	void RotateVectors(const vec3f* pVecs, vec3f* pResult, size_t count) const;
+	void RotateVectors(const vec3fStream& vecs, vec3fStream& rResult) const;
+
+	// Rotation matrix for this (unit) quaternion, for use with column vectors (mat * v)
+	mat33 GetRotationMatrix33() const;
+	mat44 GetRotationMatrix44() const;
+	// Unit quaternion from a pure rotation matrix (mat44: upper 3x3 only)
+	static Quaternion GetRotationFromMatrix(const mat33& matRot);
+	static Quaternion GetRotationFromMatrix(const mat44& matRot);
+
+	// Interpolation between unit quaternions (both take the shorter arc)
+	// Spherical linear interpolation: constant angular velocity
+	static Quaternion Slerp(Quaternion q0, Quaternion q1, float t);
+	// Normalized lerp with a correction polynomial on t, so the result tracks
+	// Slerp() closely (~1e-4 rad) without any trig
+	static Quaternion Nlerp(Quaternion q0, Quaternion q1, float t);
+	// Batched Nlerp() over SoA quaternions stored as (i, j, k, w) = (X, Y, Z, W).
+	// Streams must be the same size; rResult is resized & may be either input.
+	// Results match Nlerp() exactly.
+	static void Nlerp(const vec4fStream& quats0, const vec4fStream& quats1, float t, vec4fStream& rResult);
 };
 
 Quaternion operator*(float fScalar, Quaternion q);
@@ -0,0 +1,99 @@
+/**
+ *	FILE: quat_kernels.inl
+ *	quat.cpp's batch kernels; included by simd_kernels.inl, once per instruction
+ *	set.
+ */
+
+/**
+ *	SoA kernel: t = 2(q x v), v' = (v + w*t) + q x t, S::WIDTH vectors per iteration.
+ *	RotateVector() performs the same operations in the same order.
+ */
+template <class S>
+static void KernelRotate(const float (&q)[4], const float* const* pIn, float* const* pOut, size_t begin, size_t end)
+{
+	typename S::type qx = S::Set1(q[0]);
+	typename S::type qy = S::Set1(q[1]);
+	typename S::type qz = S::Set1(q[2]);
+	typename S::type qw = S::Set1(q[3]);
+
+	size_t i = begin;
+	for (; i + S::WIDTH <= end; i += S::WIDTH)
+	{
+		typename S::type x = S::Load(pIn[0] + i);
+		typename S::type y = S::Load(pIn[1] + i);
+		typename S::type z = S::Load(pIn[2] + i);
+
+		typename S::type tx = S::Sub(S::Mul(qy, z), S::Mul(qz, y));
+		typename S::type ty = S::Sub(S::Mul(qz, x), S::Mul(qx, z));
+		typename S::type tz = S::Sub(S::Mul(qx, y), S::Mul(qy, x));
+		tx = S::Add(tx, tx);
+		ty = S::Add(ty, ty);
+		tz = S::Add(tz, tz);
+
+		// Store after all loads so in-place rotations are safe
+		S::Store(pOut[0] + i, S::Add(S::Add(x, S::Mul(qw, tx)), S::Sub(S::Mul(qy, tz), S::Mul(qz, ty))));
+		S::Store(pOut[1] + i, S::Add(S::Add(y, S::Mul(qw, ty)), S::Sub(S::Mul(qz, tx), S::Mul(qx, tz))));
+		S::Store(pOut[2] + i, S::Add(S::Add(z, S::Mul(qw, tz)), S::Sub(S::Mul(qx, ty), S::Mul(qy, tx))));
+	}
+
+	if (i < end)
+	{
+		KernelRotate<SimdScalar>(q, pIn, pOut, i, end);
+	}
+}
+
+/**
+ *	Nlerp kernel with t corrected towards Slerp (polynomial fit in |cos(angle)|, see
+ *	"Approximating slerp", A. Kapoulkine). S::WIDTH quaternions per iteration.
+ */
+template <class S>
+static void KernelNlerp(const float* const* pQuats0, const float* const* pQuats1, float t, float* const* pOut, size_t begin, size_t end)
+{
+	typedef typename S::type lane;
+
+	// Uniform parts of the correction: ot = t + (t (t - 0.5) (t - 1)) * (A (t - 0.5)^2 + B)
+	const lane t_lanes = S::Set1(t);
+	const lane t_half_sq = S::Set1((t - 0.5f) * (t - 0.5f));
+	const lane t_cubic = S::Set1((t * (t - 0.5f)) * (t - 1.0f));
+
+	size_t i = begin;
+	for (; i + S::WIDTH <= end; i += S::WIDTH)
+	{
+		lane q0[4], q1[4];
+		for (int c = 0; c < 4; c++)
+		{
+			q0[c] = S::Load(pQuats0[c] + i);
+			q1[c] = S::Load(pQuats1[c] + i);
+		}
+
+		lane cos_theta = S::Add(S::Add(S::Add(S::Mul(q0[0], q1[0]), S::Mul(q0[1], q1[1])), S::Mul(q0[2], q1[2])), S::Mul(q0[3], q1[3]));
+		lane d = S::Abs(cos_theta);
+
+		lane A = S::Add(S::Set1(1.0904f), S::Mul(d, S::Add(S::Set1(-3.2452f), S::Mul(d, S::Sub(S::Set1(3.55645f), S::Mul(d, S::Set1(1.43519f)))))));
+		lane B = S::Add(S::Set1(0.848013f), S::Mul(d, S::Add(S::Set1(-1.06021f), S::Mul(d, S::Set1(0.215638f)))));
+		lane k = S::Add(S::Mul(A, t_half_sq), B);
+		lane t_corrected = S::Add(t_lanes, S::Mul(t_cubic, k));
+
+		lane result[4];
+		for (int c = 0; c < 4; c++)
+		{
+			// Shorter arc: negate q1 where cos(angle) < 0
+			lane q1_near = S::FlipSign(q1[c], cos_theta);
+			result[c] = S::Add(q0[c], S::Mul(t_corrected, S::Sub(q1_near, q0[c])));
+		}
+
+		lane mag_sq = S::Add(S::Add(S::Add(S::Mul(result[0], result[0]), S::Mul(result[1], result[1])), S::Mul(result[2], result[2])), S::Mul(result[3], result[3]));
+		lane mag_inv = S::Div(S::Set1(1.0f), S::Sqrt(mag_sq));
+
+		// Store after all loads so in-place interpolation is safe
+		for (int c = 0; c < 4; c++)
+		{
+			S::Store(pOut[c] + i, S::Mul(result[c], mag_inv));
+		}
+	}
+
+	if (i < end)
+	{
+		KernelNlerp<SimdScalar>(pQuats0, pQuats1, t, pOut, i, end);
+	}
+}
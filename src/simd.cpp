@@ -0,0 +1,110 @@
+#include "simd.h"
+
+// Includes: Standard
+#include <stdlib.h>
+#if defined _MSC_VER
+#include <malloc.h>
+#endif
+
+#if defined SIMD_RUNTIME_DISPATCH && defined _MSC_VER
+#include <intrin.h>
+#endif
+
+#if defined SIMD_HAS_AVX512
+static const SimdLevel SIMD_LEVEL_COMPILED = SIMD_AVX512;
+#elif defined SIMD_HAS_AVX2
+static const SimdLevel SIMD_LEVEL_COMPILED = SIMD_AVX2;
+#elif defined SIMD_HAS_SSE
+static const SimdLevel SIMD_LEVEL_COMPILED = SIMD_SSE;
+#else
+static const SimdLevel SIMD_LEVEL_COMPILED = SIMD_SCALAR;
+#endif
+
+// Highest level this CPU (& OS, which has to save the wider registers) supports
+static SimdLevel DetectSimdLevel()
+{
+#if !defined SIMD_RUNTIME_DISPATCH
+	// Only what the compiler flags enabled was built, & the build targets this CPU
+	return SIMD_LEVEL_COMPILED;
+#elif defined _MSC_VER
+	int regs[4];
+	__cpuid(regs, 0);
+	int max_leaf = regs[0];
+	__cpuid(regs, 1);
+	bool b_os_ymm = false, b_os_zmm = false;
+	if ((regs[2] & (1 << 27)) != 0)	// OSXSAVE
+	{
+		unsigned long long xcr0 = _xgetbv(0);
+		b_os_ymm = ((xcr0 & 0x06) == 0x06);
+		b_os_zmm = ((xcr0 & 0xe6) == 0xe6);
+	}
+	if (max_leaf >= 7 && b_os_ymm)
+	{
+		__cpuidex(regs, 7, 0);
+		if (b_os_zmm && (regs[1] & (1 << 16)) != 0)
+		{
+			return SIMD_AVX512;
+		}
+		if ((regs[1] & (1 << 5)) != 0)
+		{
+			return SIMD_AVX2;
+		}
+	}
+	return SIMD_SSE;
+#else
+	// :NOTE: __builtin_cpu_supports() also checks the OS has enabled the registers
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f"))
+	{
+		return SIMD_AVX512;
+	}
+	if (__builtin_cpu_supports("avx2"))
+	{
+		return SIMD_AVX2;
+	}
+	return SIMD_SSE;
+#endif
+}
+
+SimdLevel GetSimdLevelMax()
+{
+	static const SimdLevel s_levelCpu = DetectSimdLevel();
+	return (s_levelCpu < SIMD_LEVEL_COMPILED ? s_levelCpu : SIMD_LEVEL_COMPILED);
+}
+
+// :NOTE: Reads as SIMD_SCALAR if used by another file's static initializers before this one runs
+static SimdLevel s_simdLevel = GetSimdLevelMax();
+
+SimdLevel GetSimdLevel()
+{
+	return s_simdLevel;
+}
+
+void SetSimdLevel(SimdLevel level)
+{
+	SimdLevel level_max = GetSimdLevelMax();
+	s_simdLevel = (level > level_max ? level_max : level);
+}
+
+void* AlignedAlloc(size_t numBytes)
+{
+#if defined _MSC_VER
+	return _aligned_malloc(numBytes, SIMD_ALIGNMENT);
+#else
+	void* p_mem = NULL;
+	if (posix_memalign(&p_mem, SIMD_ALIGNMENT, numBytes) != 0)
+	{
+		return NULL;
+	}
+	return p_mem;
+#endif
+}
+
+void AlignedFree(void* pMem)
+{
+#if defined _MSC_VER
+	_aligned_free(pMem);
+#else
+	free(pMem);
+#endif
+}
@@ -0,0 +1,286 @@
+#pragma once
+#ifndef __SIMD_H__
+#define __SIMD_H__
+
+/**
+ *	FILE: simd.h
+ *	Instruction set detection & helpers shared by the batch (stream) kernels.
+ *	Every batch kernel has a scalar version plus SSE/AVX2/AVX-512 versions where
+ *	the compiler supports them; GetSimdLevel() picks which one runs.
+ *
+ *	With runtime dispatch (SIMD_RUNTIME_DISPATCH; on by default for x86 GCC,
+ *	Clang & MSVC) the AVX2 & AVX-512 kernels are compiled into every build
+ *	whatever the -m/arch flags, and GetSimdLevelMax() only reports the ones the
+ *	CPU running the program supports. One binary built for the SSE2 baseline
+ *	therefore runs the widest kernels each machine has. Define
+ *	SIMD_NO_RUNTIME_DISPATCH to only use what the compiler flags enable.
+ *
+ *	GCC & Clang only allow an instruction set's intrinsics in code compiled
+ *	for it, so there each file's kernels live in a separate file that
+ *	simd_kernels.inl compiles once per instruction set, in its own namespace
+ *	(simd_base, simd_avx2, simd_avx512). Only the kernels are built for the
+ *	wider sets; everything else, including inline functions from headers,
+ *	stays baseline code that any x86-64 CPU can run.
+ */
+
+// Includes: Standard
+#include <stddef.h>
+#include <math.h>
+
+// Instruction sets available to this translation unit
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#define SIMD_HAS_SSE
+#include <emmintrin.h>
+#endif
+
+#if defined SIMD_HAS_SSE && !defined SIMD_NO_RUNTIME_DISPATCH && (defined __GNUC__ || defined _MSC_VER)
+#define SIMD_RUNTIME_DISPATCH
+#endif
+
+#if defined SIMD_RUNTIME_DISPATCH && defined __GNUC__
+// Wide kernels are compiled in target regions (see simd_kernels.inl)
+#define SIMD_KERNEL_COPIES
+#define SIMD_TARGET_AVX2	__attribute__((target("avx2")))
+#define SIMD_TARGET_AVX512	__attribute__((target("avx512f")))
+#if defined __clang__
+#define SIMD_TARGET_BEGIN_AVX2		_Pragma("clang attribute push(__attribute__((target(\"avx2\"))), apply_to = function)")
+#define SIMD_TARGET_BEGIN_AVX512	_Pragma("clang attribute push(__attribute__((target(\"avx512f\"))), apply_to = function)")
+#define SIMD_TARGET_END				_Pragma("clang attribute pop")
+#else
+#define SIMD_TARGET_BEGIN_AVX2		_Pragma("GCC push_options") _Pragma("GCC target(\"avx2\")")
+#define SIMD_TARGET_BEGIN_AVX512	_Pragma("GCC push_options") _Pragma("GCC target(\"avx512f\")")
+#define SIMD_TARGET_END				_Pragma("GCC pop_options")
+#endif
+#else
+#define SIMD_TARGET_AVX2
+#define SIMD_TARGET_AVX512
+#endif
+
+// Wraps every copy of the kernels.
+// :NOTE: GCC fuses a * b + c into an FMA by default wherever FMA is available (-march=native,
+// & the AVX-512 target implies it), which would make the copies disagree in the last bit.
+#if defined __GNUC__ && !defined __clang__
+#define SIMD_KERNELS_BEGIN	_Pragma("GCC push_options") _Pragma("GCC optimize(\"fp-contract=off\")")
+#define SIMD_KERNELS_END	_Pragma("GCC pop_options")
+#else
+#define SIMD_KERNELS_BEGIN
+#define SIMD_KERNELS_END
+#endif
+
+#if defined __AVX2__ || defined SIMD_RUNTIME_DISPATCH
+#define SIMD_HAS_AVX2
+#endif
+
+// :NOTE: MSVC has the AVX-512 intrinsics from VS 2017 15.3
+#if defined __AVX512F__ || (defined SIMD_RUNTIME_DISPATCH && (!defined _MSC_VER || _MSC_VER >= 1911))
+#define SIMD_HAS_AVX512
+#endif
+
+#if defined SIMD_HAS_AVX2 || defined SIMD_HAS_AVX512
+#if defined __GNUC__ && !defined __clang__ && __GNUC__ == 12
+// :NOTE: GCC 12 wrongly warns about _mm512_undefined_ps() inside the AVX-512 intrinsics (bug 105593)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+#else
+#include <immintrin.h>
+#endif
+#endif
+
+// Alignment (in bytes) of stream storage: enough for aligned 512-bit loads
+#define SIMD_ALIGNMENT	64
+// Widest kernel (in floats); stream capacities are padded to a multiple of this
+#define SIMD_WIDTH_MAX	16
+
+enum SimdLevel
+{
+	SIMD_SCALAR = 0,
+	SIMD_SSE,
+	SIMD_AVX2,
+	SIMD_AVX512,
+};
+
+// Highest level both compiled into the library & supported by this CPU
+SimdLevel GetSimdLevelMax();
+// Level the batch kernels currently run at
+SimdLevel GetSimdLevel();
+// Override the kernel level (clamped to GetSimdLevelMax()). Mostly useful
+// for forcing the scalar path when testing or benchmarking.
+void SetSimdLevel(SimdLevel level);
+
+// Aligned heap allocation (SIMD_ALIGNMENT bytes)
+void* AlignedAlloc(size_t numBytes);
+void AlignedFree(void* pMem);
+
+/////////////////////////////////////////
+// Lane wrappers
+// Kernels are written once as templates over one of these wrappers so the
+// scalar, SSE, AVX2 & AVX-512 versions perform exactly the same sequence of IEEE
+// operations (and therefore give bit-identical results).
+// Comparisons return a per-lane mask for Select()/And()/MoveMask() instead of
+// branching; MoveMask() packs lane i's result into bit i.
+
+struct SimdScalar
+{
+	typedef float type;
+	typedef bool mask;
+	enum { WIDTH = 1 };
+
+	static type Load(const float* p)			{ return *p; }
+	static void Store(float* p, type v)			{ *p = v; }
+	static type Set1(float f)					{ return f; }
+	static type Add(type a, type b)				{ return a + b; }
+	static type Sub(type a, type b)				{ return a - b; }
+	static type Mul(type a, type b)				{ return a * b; }
+	static type Div(type a, type b)				{ return a / b; }
+	static type Sqrt(type a)					{ return sqrtf(a); }
+	static type Abs(type a)						{ return fabsf(a); }
+	// a with its sign flipped wherever signSrc has its sign bit set
+	static type FlipSign(type a, type signSrc)	{ return (signbit(signSrc) ? -a : a); }
+	static type Min(type a, type b)				{ return (a < b ? a : b); }
+	static type Max(type a, type b)				{ return (a > b ? a : b); }
+
+	static mask CmpLT(type a, type b)			{ return (a < b); }
+	static mask CmpLE(type a, type b)			{ return (a <= b); }
+	static mask CmpGT(type a, type b)			{ return (a > b); }
+	static mask And(mask a, mask b)				{ return (a && b); }
+	static mask Or(mask a, mask b)				{ return (a || b); }
+	static type Select(mask m, type a, type b)	{ return (m ? a : b); }	// a where m is set, else b
+	static int MoveMask(mask m)					{ return (m ? 1 : 0); }
+};
+
+#if defined SIMD_HAS_SSE
+struct SimdSSE
+{
+	typedef __m128 type;
+	typedef __m128 mask;
+	enum { WIDTH = 4 };
+
+	static type Load(const float* p)			{ return _mm_loadu_ps(p); }
+	static void Store(float* p, type v)			{ _mm_storeu_ps(p, v); }
+	static type Set1(float f)					{ return _mm_set1_ps(f); }
+	static type Add(type a, type b)				{ return _mm_add_ps(a, b); }
+	static type Sub(type a, type b)				{ return _mm_sub_ps(a, b); }
+	static type Mul(type a, type b)				{ return _mm_mul_ps(a, b); }
+	static type Div(type a, type b)				{ return _mm_div_ps(a, b); }
+	static type Sqrt(type a)					{ return _mm_sqrt_ps(a); }
+	static type Abs(type a)						{ return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+	static type FlipSign(type a, type signSrc)	{ return _mm_xor_ps(a, _mm_and_ps(_mm_set1_ps(-0.0f), signSrc)); }
+	static type Min(type a, type b)				{ return _mm_min_ps(a, b); }
+	static type Max(type a, type b)				{ return _mm_max_ps(a, b); }
+
+	static mask CmpLT(type a, type b)			{ return _mm_cmplt_ps(a, b); }
+	static mask CmpLE(type a, type b)			{ return _mm_cmple_ps(a, b); }
+	static mask CmpGT(type a, type b)			{ return _mm_cmpgt_ps(a, b); }
+	static mask And(mask a, mask b)				{ return _mm_and_ps(a, b); }
+	static mask Or(mask a, mask b)				{ return _mm_or_ps(a, b); }
+	static type Select(mask m, type a, type b)	{ return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+	static int MoveMask(mask m)					{ return _mm_movemask_ps(m); }
+};
+#endif
+
+#if defined SIMD_HAS_AVX2
+struct SimdAVX2
+{
+	typedef __m256 type;
+	typedef __m256 mask;
+	enum { WIDTH = 8 };
+
+	SIMD_TARGET_AVX2 static type Load(const float* p)				{ return _mm256_loadu_ps(p); }
+	SIMD_TARGET_AVX2 static void Store(float* p, type v)				{ _mm256_storeu_ps(p, v); }
+	SIMD_TARGET_AVX2 static type Set1(float f)						{ return _mm256_set1_ps(f); }
+	SIMD_TARGET_AVX2 static type Add(type a, type b)					{ return _mm256_add_ps(a, b); }
+	SIMD_TARGET_AVX2 static type Sub(type a, type b)					{ return _mm256_sub_ps(a, b); }
+	SIMD_TARGET_AVX2 static type Mul(type a, type b)					{ return _mm256_mul_ps(a, b); }
+	SIMD_TARGET_AVX2 static type Div(type a, type b)					{ return _mm256_div_ps(a, b); }
+	SIMD_TARGET_AVX2 static type Sqrt(type a)						{ return _mm256_sqrt_ps(a); }
+	SIMD_TARGET_AVX2 static type Abs(type a)							{ return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+	SIMD_TARGET_AVX2 static type FlipSign(type a, type signSrc)		{ return _mm256_xor_ps(a, _mm256_and_ps(_mm256_set1_ps(-0.0f), signSrc)); }
+	SIMD_TARGET_AVX2 static type Min(type a, type b)					{ return _mm256_min_ps(a, b); }
+	SIMD_TARGET_AVX2 static type Max(type a, type b)					{ return _mm256_max_ps(a, b); }
+
+	SIMD_TARGET_AVX2 static mask CmpLT(type a, type b)				{ return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+	SIMD_TARGET_AVX2 static mask CmpLE(type a, type b)				{ return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+	SIMD_TARGET_AVX2 static mask CmpGT(type a, type b)				{ return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+	SIMD_TARGET_AVX2 static mask And(mask a, mask b)					{ return _mm256_and_ps(a, b); }
+	SIMD_TARGET_AVX2 static mask Or(mask a, mask b)					{ return _mm256_or_ps(a, b); }
+	SIMD_TARGET_AVX2 static type Select(mask m, type a, type b)		{ return _mm256_blendv_ps(b, a, m); }
+	SIMD_TARGET_AVX2 static int MoveMask(mask m)						{ return _mm256_movemask_ps(m); }
+};
+#endif
+
+#if defined SIMD_HAS_AVX512
+// :NOTE: Sticks to AVX-512F (no DQ), so bitwise float ops go through the integer forms
+struct SimdAVX512
+{
+	typedef __m512 type;
+	typedef __mmask16 mask;
+	enum { WIDTH = 16 };
+
+	SIMD_TARGET_AVX512 static type Load(const float* p)				{ return _mm512_loadu_ps(p); }
+	SIMD_TARGET_AVX512 static void Store(float* p, type v)			{ _mm512_storeu_ps(p, v); }
+	SIMD_TARGET_AVX512 static type Set1(float f)					{ return _mm512_set1_ps(f); }
+	SIMD_TARGET_AVX512 static type Add(type a, type b)				{ return _mm512_add_ps(a, b); }
+	SIMD_TARGET_AVX512 static type Sub(type a, type b)				{ return _mm512_sub_ps(a, b); }
+	SIMD_TARGET_AVX512 static type Mul(type a, type b)				{ return _mm512_mul_ps(a, b); }
+	SIMD_TARGET_AVX512 static type Div(type a, type b)				{ return _mm512_div_ps(a, b); }
+	SIMD_TARGET_AVX512 static type Sqrt(type a)						{ return _mm512_sqrt_ps(a); }
+	SIMD_TARGET_AVX512 static type Abs(type a)						{ return _mm512_castsi512_ps(_mm512_andnot_si512(_mm512_set1_epi32(0x80000000), _mm512_castps_si512(a))); }
+	SIMD_TARGET_AVX512 static type FlipSign(type a, type signSrc)
+	{
+		__m512i sign = _mm512_and_si512(_mm512_set1_epi32(0x80000000), _mm512_castps_si512(signSrc));
+		return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a), sign));
+	}
+	SIMD_TARGET_AVX512 static type Min(type a, type b)				{ return _mm512_min_ps(a, b); }
+	SIMD_TARGET_AVX512 static type Max(type a, type b)				{ return _mm512_max_ps(a, b); }
+
+	SIMD_TARGET_AVX512 static mask CmpLT(type a, type b)			{ return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+	SIMD_TARGET_AVX512 static mask CmpLE(type a, type b)			{ return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ); }
+	SIMD_TARGET_AVX512 static mask CmpGT(type a, type b)			{ return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+	SIMD_TARGET_AVX512 static mask And(mask a, mask b)				{ return (mask)(a & b); }
+	SIMD_TARGET_AVX512 static mask Or(mask a, mask b)				{ return (mask)(a | b); }
+	SIMD_TARGET_AVX512 static type Select(mask m, type a, type b)	{ return _mm512_mask_blend_ps(m, b, a); }
+	SIMD_TARGET_AVX512 static int MoveMask(mask m)					{ return (int)m; }
+};
+#endif
+
+/**
+ *	Run KERNEL<lane wrapper>ARGS at the current SIMD level. KERNEL must be
+ *	defined in a file included through simd_kernels.inl.
+ *	Example: SIMD_DISPATCH(KernelAdd, (pA, pB, pResult, 0, count));
+ */
+#if defined SIMD_KERNEL_COPIES
+#define SIMD_NS_AVX2	simd_avx2
+#define SIMD_NS_AVX512	simd_avx512
+#else
+#define SIMD_NS_AVX2	simd_base
+#define SIMD_NS_AVX512	simd_base
+#endif
+
+#if defined SIMD_HAS_AVX512
+#define SIMD_CASE_AVX512(KERNEL, ARGS)	case SIMD_AVX512: SIMD_NS_AVX512::KERNEL<SimdAVX512> ARGS; break;
+#else
+#define SIMD_CASE_AVX512(KERNEL, ARGS)
+#endif
+#if defined SIMD_HAS_AVX2
+#define SIMD_CASE_AVX2(KERNEL, ARGS)	case SIMD_AVX2: SIMD_NS_AVX2::KERNEL<SimdAVX2> ARGS; break;
+#else
+#define SIMD_CASE_AVX2(KERNEL, ARGS)
+#endif
+#if defined SIMD_HAS_SSE
+#define SIMD_CASE_SSE(KERNEL, ARGS)		case SIMD_SSE: simd_base::KERNEL<SimdSSE> ARGS; break;
+#else
+#define SIMD_CASE_SSE(KERNEL, ARGS)
+#endif
+
+#define SIMD_DISPATCH(KERNEL, ARGS)						\
+	switch (GetSimdLevel())								\
+	{													\
+		SIMD_CASE_AVX512(KERNEL, ARGS)					\
+		SIMD_CASE_AVX2(KERNEL, ARGS)					\
+		SIMD_CASE_SSE(KERNEL, ARGS)						\
+		default: simd_base::KERNEL<SimdScalar> ARGS; break;	\
+	}
+
+#endif // #ifndef __SIMD_H__
@@ -0,0 +1,47 @@
+/**
+ *	FILE: simd_kernels.inl
+ *	Compiles the batch kernels in SIMD_KERNEL_FILE once for the baseline
+ *	instruction set (namespace simd_base: the scalar & SSE kernels) and, with
+ *	GCC/Clang runtime dispatch, once more for each wider set with the compiler
+ *	targeting it (simd_avx2, simd_avx512). SIMD_DISPATCH() picks the copy.
+ *
+ *	Usage, in the .cpp that owns the kernels:
+ *		#define SIMD_KERNEL_FILE "vecstream_kernels.inl"
+ *		#include "simd_kernels.inl"
+ *
+ *	The kernel file has no include guard & no #includes of its own: it only
+ *	holds (static) kernel templates & their helpers.
+ */
+
+#if !defined SIMD_KERNEL_FILE
+#error Define SIMD_KERNEL_FILE before including simd_kernels.inl
+#endif
+
+SIMD_KERNELS_BEGIN
+namespace simd_base
+{
+#include SIMD_KERNEL_FILE
+}
+SIMD_KERNELS_END
+
+#if defined SIMD_KERNEL_COPIES
+SIMD_TARGET_BEGIN_AVX2
+SIMD_KERNELS_BEGIN
+namespace simd_avx2
+{
+#include SIMD_KERNEL_FILE
+}
+SIMD_KERNELS_END
+SIMD_TARGET_END
+
+SIMD_TARGET_BEGIN_AVX512
+SIMD_KERNELS_BEGIN
+namespace simd_avx512
+{
+#include SIMD_KERNEL_FILE
+}
+SIMD_KERNELS_END
+SIMD_TARGET_END
+#endif
+
+#undef SIMD_KERNEL_FILE
@@ -0,0 +1,478 @@
+#include "spatial.h"
+#include "math3d.h"
+
+// Includes: Standard
+#include <algorithm>
+#include <limits.h>
+
+//////////////////////////////////////////////////////////
+// CLASS: SpatialGrid2D
+//////////////////////////////////////////////////////////
+
+SpatialGrid2D::SpatialGrid2D(float fCellSize) :
+	m_cellSize(fCellSize),
+	m_invCellSize(1.0f / fCellSize),
+	m_count(0)
+{
+}
+
+int SpatialGrid2D::GetCellCoord(float f) const
+{
+	// Clamp so far-away (or infinite) coordinates still land in an edge cell
+	float cell = floorf(f * m_invCellSize);
+	if (!(cell > (float)INT_MIN))
+	{
+		return INT_MIN;
+	}
+	if (cell >= (float)INT_MAX)
+	{
+		return INT_MAX;
+	}
+	return (int)cell;
+}
+
+void SpatialGrid2D::RemoveFromCell(uint64_t key, uint32_t id)
+{
+	std::unordered_map<uint64_t, std::vector<uint32_t> >::iterator it_cell = m_cells.find(key);
+	std::vector<uint32_t>& cell_ids = it_cell->second;
+	for (size_t i = 0; i < cell_ids.size(); i++)
+	{
+		if (cell_ids[i] == id)
+		{
+			cell_ids[i] = cell_ids.back();
+			cell_ids.pop_back();
+			break;
+		}
+	}
+
+	if (cell_ids.empty())
+	{
+		m_cells.erase(it_cell);
+	}
+}
+
+void SpatialGrid2D::Set(uint32_t id, vec2f pos)
+{
+	if (id >= m_positions.size())
+	{
+		m_positions.resize(id + 1);
+		m_cellKeys.resize(id + 1);
+		m_bPresent.resize(id + 1, false);
+	}
+
+	uint64_t key = GetCellKey(GetCellCoord(pos.x), GetCellCoord(pos.y));
+	m_positions[id] = pos;
+	if (m_bPresent[id])
+	{
+		// Still in the same cell: nothing else to do
+		if (m_cellKeys[id] == key)
+		{
+			return;
+		}
+		RemoveFromCell(m_cellKeys[id], id);
+	}
+	else
+	{
+		m_bPresent[id] = true;
+		m_count++;
+	}
+
+	m_cellKeys[id] = key;
+	m_cells[key].push_back(id);
+}
+
+void SpatialGrid2D::Remove(uint32_t id)
+{
+	if (!Contains(id))
+	{
+		return;
+	}
+
+	RemoveFromCell(m_cellKeys[id], id);
+	m_bPresent[id] = false;
+	m_count--;
+}
+
+void SpatialGrid2D::Clear()
+{
+	m_cells.clear();
+	m_positions.clear();
+	m_cellKeys.clear();
+	m_bPresent.clear();
+	m_count = 0;
+}
+
+template <class Fn>
+void SpatialGrid2D::VisitCandidates(vec2f center, float radius, Fn fnVisit) const
+{
+	if (!(radius >= 0.0f))
+	{
+		return;
+	}
+
+	int cell_min_x = GetCellCoord(center.x - radius);
+	int cell_max_x = GetCellCoord(center.x + radius);
+	int cell_min_y = GetCellCoord(center.y - radius);
+	int cell_max_y = GetCellCoord(center.y + radius);
+
+	// :NOTE: Covering more cells than are occupied? Then walking the occupied cells is cheaper.
+	double num_cells = ((double)cell_max_x - cell_min_x + 1.0) * ((double)cell_max_y - cell_min_y + 1.0);
+	if (num_cells > (double)m_cells.size())
+	{
+		for (std::unordered_map<uint64_t, std::vector<uint32_t> >::const_iterator it_cell = m_cells.begin(); it_cell != m_cells.end(); ++it_cell)
+		{
+			int cell_x = (int)(uint32_t)(it_cell->first >> 32);
+			int cell_y = (int)(uint32_t)(it_cell->first);
+			if (cell_x < cell_min_x || cell_x > cell_max_x || cell_y < cell_min_y || cell_y > cell_max_y)
+			{
+				continue;
+			}
+			for (size_t i = 0; i < it_cell->second.size(); i++)
+			{
+				fnVisit(it_cell->second[i]);
+			}
+		}
+		return;
+	}
+
+	for (int cell_x = cell_min_x; ; cell_x++)
+	{
+		for (int cell_y = cell_min_y; ; cell_y++)
+		{
+			std::unordered_map<uint64_t, std::vector<uint32_t> >::const_iterator it_cell = m_cells.find(GetCellKey(cell_x, cell_y));
+			if (it_cell != m_cells.end())
+			{
+				for (size_t i = 0; i < it_cell->second.size(); i++)
+				{
+					fnVisit(it_cell->second[i]);
+				}
+			}
+
+			// :NOTE: Checked here rather than in the loop condition so INT_MAX can't overflow
+			if (cell_y == cell_max_y)
+			{
+				break;
+			}
+		}
+		if (cell_x == cell_max_x)
+		{
+			break;
+		}
+	}
+}
+
+void SpatialGrid2D::QueryRadius(vec2f center, float radius, std::vector<uint32_t>& rIds) const
+{
+	float radius_sq = radius * radius;
+	VisitCandidates(center, radius, [&](uint32_t id)
+	{
+		vec2f vec_distance = m_positions[id] - center;
+		if (vec2f::DotProduct(vec_distance, vec_distance) <= radius_sq)
+		{
+			rIds.push_back(id);
+		}
+	});
+}
+
+void SpatialGrid2D::QueryCone(vec2f posSentry, vec2f dirSentry, float rangeSentry, float halfAngleSentry, std::vector<uint32_t>& rIds) const
+{
+	// :NOTE: IsWithinRange2D() only uses the squared range, so a negative range acts like its magnitude
+	VisitCandidates(posSentry, fabsf(rangeSentry), [&](uint32_t id)
+	{
+		if (IsWithinRange2D(posSentry, dirSentry, rangeSentry, halfAngleSentry, m_positions[id]))
+		{
+			rIds.push_back(id);
+		}
+	});
+}
+
+//////////////////////////////////////////////////////////
+// CLASS: BVH3D
+//////////////////////////////////////////////////////////
+
+// Squared distance from p to the box (0 inside)
+static float GetDistanceSqToBox(vec3f p, vec3f boundsMin, vec3f boundsMax)
+{
+	float dist_sq = 0.0f;
+	for (int c = 0; c < 3; c++)
+	{
+		float d = (p[c] < boundsMin[c] ? boundsMin[c] - p[c] : (p[c] > boundsMax[c] ? p[c] - boundsMax[c] : 0.0f));
+		dist_sq += d * d;
+	}
+	return dist_sq;
+}
+
+BVH3D::BVH3D()
+{
+}
+
+void BVH3D::Build(const vec3f* pPositions, const vec3f* pVelocities, size_t count)
+{
+	m_positions.assign(pPositions, pPositions + count);
+	if (pVelocities != NULL)
+	{
+		m_velocities.assign(pVelocities, pVelocities + count);
+	}
+	else
+	{
+		m_velocities.assign(count, vec3f(0.0f, 0.0f, 0.0f));
+	}
+
+	m_ids.resize(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		m_ids[i] = (uint32_t)i;
+	}
+
+	m_nodes.clear();
+	if (count == 0)
+	{
+		return;
+	}
+	m_nodes.reserve(2 * ((count + BVH_LEAF_SIZE - 1) / BVH_LEAF_SIZE));
+	m_nodes.push_back(Node());
+	BuildNode(0, 0, (uint32_t)count);
+}
+
+void BVH3D::BuildNode(uint32_t idxNode, uint32_t first, uint32_t count)
+{
+	if (count <= BVH_LEAF_SIZE)
+	{
+		m_nodes[idxNode].first = first;
+		m_nodes[idxNode].count = count;
+		FitNode(m_nodes[idxNode]);
+		return;
+	}
+
+	// Split at the median along the longest axis of the positions
+	vec3f pos_min = m_positions[m_ids[first]];
+	vec3f pos_max = pos_min;
+	for (uint32_t i = first + 1; i < first + count; i++)
+	{
+		vec3f pos = m_positions[m_ids[i]];
+		for (int c = 0; c < 3; c++)
+		{
+			pos_min[c] = std::min(pos_min[c], pos[c]);
+			pos_max[c] = std::max(pos_max[c], pos[c]);
+		}
+	}
+	vec3f extent = pos_max - pos_min;
+	int axis = (extent.x() >= extent.y() ? (extent.x() >= extent.z() ? 0 : 2) : (extent.y() >= extent.z() ? 1 : 2));
+
+	uint32_t count_left = count / 2;
+	std::nth_element(m_ids.begin() + first, m_ids.begin() + first + count_left, m_ids.begin() + first + count, [&](uint32_t a, uint32_t b)
+	{
+		return (m_positions[a][axis] < m_positions[b][axis]);
+	});
+
+	// :NOTE: m_nodes may reallocate below, so only index it
+	uint32_t idx_left = (uint32_t)m_nodes.size();
+	m_nodes.push_back(Node());
+	m_nodes.push_back(Node());
+	m_nodes[idxNode].first = idx_left;
+	m_nodes[idxNode].count = 0;
+
+	BuildNode(idx_left, first, count_left);
+	BuildNode(idx_left + 1, first + count_left, count - count_left);
+
+	// Children are fitted: merge them
+	const Node& left = m_nodes[idx_left];
+	const Node& right = m_nodes[idx_left + 1];
+	Node& node = m_nodes[idxNode];
+	for (int c = 0; c < 3; c++)
+	{
+		node.boundsMin[c] = std::min(left.boundsMin[c], right.boundsMin[c]);
+		node.boundsMax[c] = std::max(left.boundsMax[c], right.boundsMax[c]);
+	}
+	node.maxSpeed = std::max(left.maxSpeed, right.maxSpeed);
+}
+
+void BVH3D::FitNode(Node& rNode) const
+{
+	rNode.boundsMin = m_positions[m_ids[rNode.first]];
+	rNode.boundsMax = rNode.boundsMin;
+	rNode.maxSpeed = 0.0f;
+	for (uint32_t i = rNode.first; i < rNode.first + rNode.count; i++)
+	{
+		vec3f pos = m_positions[m_ids[i]];
+		for (int c = 0; c < 3; c++)
+		{
+			rNode.boundsMin[c] = std::min(rNode.boundsMin[c], pos[c]);
+			rNode.boundsMax[c] = std::max(rNode.boundsMax[c], pos[c]);
+		}
+		rNode.maxSpeed = std::max(rNode.maxSpeed, m_velocities[m_ids[i]].Mag());
+	}
+}
+
+void BVH3D::Update(uint32_t id, vec3f pos, vec3f vel)
+{
+	m_positions[id] = pos;
+	m_velocities[id] = vel;
+}
+
+void BVH3D::Refit()
+{
+	// Children come after their parent, so a reverse walk fits children first
+	for (size_t i = m_nodes.size(); i-- > 0; )
+	{
+		Node& node = m_nodes[i];
+		if (node.count > 0)
+		{
+			FitNode(node);
+			continue;
+		}
+
+		const Node& left = m_nodes[node.first];
+		const Node& right = m_nodes[node.first + 1];
+		for (int c = 0; c < 3; c++)
+		{
+			node.boundsMin[c] = std::min(left.boundsMin[c], right.boundsMin[c]);
+			node.boundsMax[c] = std::max(left.boundsMax[c], right.boundsMax[c]);
+		}
+		node.maxSpeed = std::max(left.maxSpeed, right.maxSpeed);
+	}
+}
+
+void BVH3D::QuerySphere(vec3f center, float radius, std::vector<uint32_t>& rIds) const
+{
+	if (m_nodes.empty() || !(radius >= 0.0f))
+	{
+		return;
+	}
+
+	float radius_sq = radius * radius;
+	std::vector<uint32_t> stack(1, 0);
+	while (!stack.empty())
+	{
+		const Node& node = m_nodes[stack.back()];
+		stack.pop_back();
+		if (GetDistanceSqToBox(center, node.boundsMin, node.boundsMax) > radius_sq)
+		{
+			continue;
+		}
+
+		if (node.count == 0)
+		{
+			stack.push_back(node.first);
+			stack.push_back(node.first + 1);
+			continue;
+		}
+
+		for (uint32_t i = node.first; i < node.first + node.count; i++)
+		{
+			vec3f vec_distance = m_positions[m_ids[i]] - center;
+			if (vec3f::DotProduct(vec_distance, vec_distance) <= radius_sq)
+			{
+				rIds.push_back(m_ids[i]);
+			}
+		}
+	}
+}
+
+bool BVH3D::QueryNearestIntercept(vec3f pos, vec3f vel, float fRadius, uint32_t* pId, float* pTime) const
+{
+	if (m_nodes.empty())
+	{
+		return false;
+	}
+
+	// Lower bound on the contact time with anything in a node: the gap to its box
+	// closes no faster than the mover's speed plus the node's max speed
+	float speed = vel.Mag();
+	auto get_min_time = [&](const Node& node) -> float
+	{
+		float gap = sqrtf(GetDistanceSqToBox(pos, node.boundsMin, node.boundsMax)) - fRadius;
+		if (gap <= 0.0f)
+		{
+			return 0.0f;
+		}
+		float closing_speed = speed + node.maxSpeed;
+		return (closing_speed > 0.0f ? gap / closing_speed : INFINITY);
+	};
+
+	bool b_found = false;
+	float best_time = INFINITY;
+	uint32_t best_id = 0;
+
+	std::vector<uint32_t> stack(1, 0);
+	while (!stack.empty())
+	{
+		const Node& node = m_nodes[stack.back()];
+		stack.pop_back();
+		if (!(get_min_time(node) < best_time))
+		{
+			continue;
+		}
+
+		if (node.count == 0)
+		{
+			// Visit the child that could be reached sooner first (pushed last)
+			uint32_t idx_near = node.first;
+			uint32_t idx_far = node.first + 1;
+			if (get_min_time(m_nodes[idx_far]) < get_min_time(m_nodes[idx_near]))
+			{
+				std::swap(idx_near, idx_far);
+			}
+			stack.push_back(idx_far);
+			stack.push_back(idx_near);
+			continue;
+		}
+
+		for (uint32_t i = node.first; i < node.first + node.count; i++)
+		{
+			uint32_t id = m_ids[i];
+			float time;
+			if (SolveInterceptTime(pos, vel, m_positions[id], m_velocities[id], fRadius, &time) == INTERCEPT_OK && time < best_time)
+			{
+				b_found = true;
+				best_time = time;
+				best_id = id;
+			}
+		}
+	}
+
+	if (b_found)
+	{
+		*pId = best_id;
+		*pTime = best_time;
+	}
+	return b_found;
+}
+
+void BVH3D::QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& rIds) const
+{
+	if (m_nodes.empty())
+	{
+		return;
+	}
+
+	// (node, planes still to test)
+	std::vector<std::pair<uint32_t, unsigned> > stack(1, std::make_pair(0u, FRUSTUM_ALL_PLANES));
+	while (!stack.empty())
+	{
+		const Node& node = m_nodes[stack.back().first];
+		unsigned plane_mask = stack.back().second;
+		stack.pop_back();
+
+		FrustumTest result = frustum.TestAABB(node.boundsMin, node.boundsMax, &plane_mask);
+		if (result == FRUSTUM_OUTSIDE)
+		{
+			continue;
+		}
+
+		if (node.count == 0)
+		{
+			stack.push_back(std::make_pair(node.first, plane_mask));
+			stack.push_back(std::make_pair(node.first + 1, plane_mask));
+			continue;
+		}
+
+		for (uint32_t i = node.first; i < node.first + node.count; i++)
+		{
+			if (result == FRUSTUM_INSIDE || frustum.ContainsPoint(m_positions[m_ids[i]]))
+			{
+				rIds.push_back(m_ids[i]);
+			}
+		}
+	}
+}
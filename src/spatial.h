@@ -0,0 +1,181 @@
+#pragma once
+#ifndef __SPATIAL_H__
+#define __SPATIAL_H__
+
+/**
+ *	FILE: spatial.h
+ *	Broadphase structures for sentry & intercept queries: a uniform hash grid
+ *	over 2D positions & a bounding volume hierarchy (BVH) over moving 3D
+ *	points. Each query only hands candidates near the query to the narrow-phase
+ *	functions in math3d.h (IsWithinRange2D(), SolveInterceptTime()) instead of
+ *	testing every pair.
+ *
+ *	Entities are identified by caller-chosen ids, typically their index in the
+ *	caller's own arrays.
+ */
+
+// Includes: Standard
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include <unordered_map>
+
+// Includes: Project
+#include "vec.h"
+
+class Frustum;
+
+// Max entities per BVH leaf
+#define BVH_LEAF_SIZE		4
+
+/**
+ *	CLASS: SpatialGrid2D
+ *	Uniform grid of square cells, stored sparsely (only occupied cells exist).
+ *	Moving an entity only touches the grid when it changes cell.
+ *	Pick a cell size near the typical query range: much smaller means visiting
+ *	many cells per query, much larger means many candidates per cell.
+ */
+class SpatialGrid2D
+{
+protected:
+	///////////////////////////////////
+	// Properties
+	float m_cellSize;
+	float m_invCellSize;
+	std::unordered_map<uint64_t, std::vector<uint32_t> > m_cells;	// Cell key -> ids in that cell
+	std::vector<vec2f> m_positions;		// By id
+	std::vector<uint64_t> m_cellKeys;	// By id: current cell
+	std::vector<bool> m_bPresent;		// By id: inserted & not removed
+	size_t m_count;
+
+public:
+	///////////////////////////////////
+	// Setup & Initialization
+	explicit SpatialGrid2D(float fCellSize);
+
+	///////////////////////////////////
+	// Getter/Setters
+	size_t Size() const
+	{
+		return m_count;
+	}
+
+	bool Contains(uint32_t id) const
+	{
+		return (id < m_bPresent.size() && m_bPresent[id]);
+	}
+
+	// Insert entity id at pos, or move it there if already present
+	void Set(uint32_t id, vec2f pos);
+	void Remove(uint32_t id);
+	void Clear();
+
+	///////////////////////////////////
+	// Queries (ids are appended to rIds, in no particular order)
+	// Entities within radius of center (distance <= radius)
+	void QueryRadius(vec2f center, float radius, std::vector<uint32_t>& rIds) const;
+	// Entities a sentry can see: same result as IsWithinRange2D() for every entity
+	void QueryCone(vec2f posSentry, vec2f dirSentry, float rangeSentry, float halfAngleSentry, std::vector<uint32_t>& rIds) const;
+
+protected:
+	uint64_t GetCellKey(int cellX, int cellY) const
+	{
+		return ((uint64_t)(uint32_t)cellX << 32) | (uint64_t)(uint32_t)cellY;
+	}
+
+	int GetCellCoord(float f) const;
+	void RemoveFromCell(uint64_t key, uint32_t id);
+
+	// Calls fnVisit(id) for every entity in cells overlapping the square around center
+	template <class Fn>
+	void VisitCandidates(vec2f center, float radius, Fn fnVisit) const;
+};
+
+/**
+ *	CLASS: BVH3D
+ *	Binary tree of axis-aligned boxes over points with velocities, built by
+ *	median splits. Each node also keeps the max speed below it, which bounds
+ *	how soon anything inside it can be reached (for QueryNearestIntercept()).
+ *
+ *	Moving entities: Update() each changed entity, then Refit() once before
+ *	querying. Refitting keeps the tree shape, so rebuild (Build()) when
+ *	entities have moved far from where they started.
+ */
+class BVH3D
+{
+protected:
+	struct Node
+	{
+		vec3f boundsMin;
+		vec3f boundsMax;
+		float maxSpeed;		// Max |velocity| of the entities below
+		uint32_t first;		// Leaf: first slot in m_ids; inner: index of left child (right is first + 1)
+		uint32_t count;		// Leaf: number of entities; inner: 0
+	};
+
+	///////////////////////////////////
+	// Properties
+	std::vector<Node> m_nodes;			// Root first; children always after their parent
+	std::vector<uint32_t> m_ids;		// Entity ids in leaf order
+	std::vector<vec3f> m_positions;		// By id
+	std::vector<vec3f> m_velocities;	// By id
+
+public:
+	///////////////////////////////////
+	// Setup & Initialization
+	BVH3D();
+
+	/**
+	 *	Build over count entities (ids 0..count-1)
+	 *	@param	pPositions		Positions
+	 *	@param	pVelocities		Velocities (NULL: all stationary)
+	 *	@param	count			Number of entities
+	 */
+	void Build(const vec3f* pPositions, const vec3f* pVelocities, size_t count);
+
+	///////////////////////////////////
+	// Getter/Setters
+	size_t Size() const
+	{
+		return m_positions.size();
+	}
+
+	vec3f GetPosition(uint32_t id) const
+	{
+		return m_positions[id];
+	}
+
+	vec3f GetVelocity(uint32_t id) const
+	{
+		return m_velocities[id];
+	}
+
+	// Move an entity; bounds are stale until Refit()
+	void Update(uint32_t id, vec3f pos, vec3f vel);
+	// Recompute every node's bounds & max speed bottom-up
+	void Refit();
+
+	///////////////////////////////////
+	// Queries
+	// Entities within radius of center (ids appended to rIds, in no particular order)
+	void QuerySphere(vec3f center, float radius, std::vector<uint32_t>& rIds) const;
+	/**
+	 *	Entity contacted first by a mover (see SolveInterceptTime(): contact is within fRadius)
+	 *	@param	pos		Mover position
+	 *	@param	vel		Mover velocity
+	 *	@param	fRadius	Contact distance
+	 *	@param	pId		Receives the id of the entity contacted first
+	 *	@param	pTime	Receives the time of contact
+	 *	@return	False if no entity is ever contacted (pId & pTime untouched)
+	 */
+	bool QueryNearestIntercept(vec3f pos, vec3f vel, float fRadius, uint32_t* pId, float* pTime) const;
+	// Entities inside the frustum (ids appended to rIds). Planes a node is entirely inside
+	// are skipped below it, & nodes entirely inside are taken without per-entity tests.
+	void QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& rIds) const;
+
+protected:
+	void BuildNode(uint32_t idxNode, uint32_t first, uint32_t count);
+	void FitNode(Node& rNode) const;
+};
+
+#endif // #ifndef __SPATIAL_H__
@@ -0,0 +1,210 @@
+#include "spline.h"
+#include "curve.h"
+#include "vecstream.h"
+#include "parallel.h"
+
+// Includes: Standard
+#include <algorithm>
+
+// Below this many samples per thread, bulk evaluation stays on the calling thread
+#define SPLINE_GRAIN		(1 << 14)
+
+// Horner evaluation of one segment: ((c0 t + c1) t + c2) t + c3 per axis
+static inline vec3f EvaluateSegment(const mat34& coeffs, float t)
+{
+	return vec3f
+	(
+		((coeffs[0][0] * t + coeffs[0][1]) * t + coeffs[0][2]) * t + coeffs[0][3],
+		((coeffs[1][0] * t + coeffs[1][1]) * t + coeffs[1][2]) * t + coeffs[1][3],
+		((coeffs[2][0] * t + coeffs[2][1]) * t + coeffs[2][2]) * t + coeffs[2][3]
+	);
+}
+
+//////////////////////////////////////////////////////////
+// CLASS: Spline3D
+//////////////////////////////////////////////////////////
+
+Spline3D::Spline3D(SplineType type, const vec3f* pControls, size_t numControls, const float* pKnots /*= NULL*/) :
+	m_type(type),
+	m_bUniform(pKnots == NULL)
+{
+	// Segment layout for this type
+	size_t num_segments = 0;
+	size_t stride = 1;
+	const mat44* p_basis = NULL;
+	switch (type)
+	{
+		case SPLINE_CATMULL_ROM:
+			num_segments = (numControls >= 4 ? numControls - 3 : 0);
+			p_basis = &MAT_CATMULL_ROM;
+			break;
+		case SPLINE_BSPLINE:
+			num_segments = (numControls >= 4 ? numControls - 3 : 0);
+			p_basis = &MAT_BSPLINE;
+			break;
+		case SPLINE_BEZIER_CUBE:
+			num_segments = (numControls >= 4 ? (numControls - 1) / 3 : 0);
+			stride = 3;
+			p_basis = &Bezier2DCube::MAT_CUBE;
+			break;
+		case SPLINE_BEZIER_QUAD:
+			num_segments = (numControls >= 3 ? (numControls - 1) / 2 : 0);
+			stride = 2;
+			break;
+	}
+
+	// Coefficients = (controls as columns, one row per axis) * basis
+	m_coeffs.resize(num_segments);
+	for (size_t i = 0; i < num_segments; i++)
+	{
+		const vec3f* p_seg = pControls + (i * stride);
+		if (type == SPLINE_BEZIER_QUAD)
+		{
+			mat33 geometry
+			(
+				vec3f(p_seg[0].x(), p_seg[1].x(), p_seg[2].x()),
+				vec3f(p_seg[0].y(), p_seg[1].y(), p_seg[2].y()),
+				vec3f(p_seg[0].z(), p_seg[1].z(), p_seg[2].z())
+			);
+			mat33 coeffs_quad = geometry * Bezier2DQuad::MAT_QUAD;
+			for (int r = 0; r < 3; r++)
+			{
+				m_coeffs[i][r] = vec4f(0.0f, coeffs_quad[r][0], coeffs_quad[r][1], coeffs_quad[r][2]);
+			}
+		}
+		else
+		{
+			mat34 geometry
+			(
+				vec4f(p_seg[0].x(), p_seg[1].x(), p_seg[2].x(), p_seg[3].x()),
+				vec4f(p_seg[0].y(), p_seg[1].y(), p_seg[2].y(), p_seg[3].y()),
+				vec4f(p_seg[0].z(), p_seg[1].z(), p_seg[2].z(), p_seg[3].z())
+			);
+			m_coeffs[i] = geometry * (*p_basis);
+		}
+	}
+
+	m_knots.resize(num_segments + 1);
+	for (size_t i = 0; i <= num_segments; i++)
+	{
+		m_knots[i] = (pKnots != NULL ? pKnots[i] : (num_segments > 0 ? (float)i / num_segments : 0.0f));
+	}
+}
+
+size_t Spline3D::GetSegment(float u, float* pT) const
+{
+	size_t num_segments = m_coeffs.size();
+	if (num_segments == 0 || !(u > m_knots.front()))
+	{
+		*pT = 0.0f;
+		return 0;
+	}
+	if (u >= m_knots.back())
+	{
+		*pT = 1.0f;
+		return num_segments - 1;
+	}
+
+	size_t idx_segment;
+	if (m_bUniform)
+	{
+		float u_scaled = u * num_segments;
+		idx_segment = (size_t)u_scaled;
+		if (idx_segment >= num_segments)
+		{
+			idx_segment = num_segments - 1;
+		}
+		*pT = u_scaled - (float)idx_segment;
+		return idx_segment;
+	}
+
+	// Last knot <= u
+	idx_segment = (size_t)(std::upper_bound(m_knots.begin(), m_knots.end(), u) - m_knots.begin()) - 1;
+	*pT = (u - m_knots[idx_segment]) / (m_knots[idx_segment + 1] - m_knots[idx_segment]);
+	return idx_segment;
+}
+
+// :NOTE: A spline without any segments evaluates to (0,0,0)
+vec3f Spline3D::GetSegmentPoint(size_t idxSegment, float t) const
+{
+	if (idxSegment >= m_coeffs.size())
+	{
+		return vec3f(0.0f, 0.0f, 0.0f);
+	}
+	return EvaluateSegment(m_coeffs[idxSegment], t);
+}
+
+vec3f Spline3D::GetPoint(float u) const
+{
+	float t;
+	size_t idx_segment = GetSegment(u, &t);
+	return GetSegmentPoint(idx_segment, t);
+}
+
+void Spline3D::GetPoints(const float* pU, vec3f* pResult, size_t count) const
+{
+	ParallelFor(count, SPLINE_GRAIN, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			pResult[i] = GetPoint(pU[i]);
+		}
+	});
+}
+
+void Spline3D::GetPoints(const float* pU, size_t count, vec3fStream& rResult) const
+{
+	rResult.Resize(count);
+	float* p_x = rResult.X();
+	float* p_y = rResult.Y();
+	float* p_z = rResult.Z();
+
+	ParallelFor(count, SPLINE_GRAIN, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			vec3f point = GetPoint(pU[i]);
+			p_x[i] = point.x();
+			p_y[i] = point.y();
+			p_z[i] = point.z();
+		}
+	});
+}
+
+void Spline3D::GetPointsUniform(vec3f* pResult, size_t count) const
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	size_t num_segments = m_coeffs.size();
+	float u_first = m_knots.front();
+	float u_step = (count > 1 ? (m_knots.back() - u_first) / (float)(count - 1) : 0.0f);
+
+	ParallelFor(count, SPLINE_GRAIN, [&](size_t begin, size_t end)
+	{
+		// One lookup per chunk, then walk the segments forward
+		float t;
+		size_t idx_segment = GetSegment(u_first + (u_step * begin), &t);
+		for (size_t i = begin; i < end; i++)
+		{
+			float u = (i + 1 == count ? m_knots.back() : u_first + (u_step * i));
+			while (idx_segment + 1 < num_segments && u >= m_knots[idx_segment + 1])
+			{
+				idx_segment++;
+			}
+
+			if (num_segments == 0)
+			{
+				pResult[i] = vec3f(0.0f, 0.0f, 0.0f);
+				continue;
+			}
+
+			float knot_low = m_knots[idx_segment];
+			t = (u - knot_low) / (m_knots[idx_segment + 1] - knot_low);
+			t = (t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t));
+			pResult[i] = EvaluateSegment(m_coeffs[idx_segment], t);
+		}
+	});
+}
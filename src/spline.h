@@ -0,0 +1,106 @@
+#pragma once
+#ifndef __SPLINE_H__
+#define __SPLINE_H__
+
+/**
+ *	FILE: spline.h
+ *	Multi-segment (piecewise cubic) 3D splines. Each segment's polynomial
+ *	coefficients are precomputed from its control points with a basis matrix
+ *	(same convention as Bezier2DQuad::MAT_QUAD/Bezier2DCube::MAT_CUBE), so a
+ *	sample is a segment lookup plus one Horner evaluation per axis.
+ */
+
+// Includes: Standard
+#include <stddef.h>
+#include <vector>
+
+// Includes: Project
+#include "vec.h"
+#include "mat.h"
+
+class vec3fStream;
+
+enum SplineType
+{
+	SPLINE_CATMULL_ROM = 0,	// Passes through controls 1..n-2; n-3 segments
+	SPLINE_BSPLINE,			// Uniform cubic B-spline (C2, approximating); n-3 segments
+	SPLINE_BEZIER_CUBE,		// Composite cubic Bezier: controls 3i..3i+3; (n-1)/3 segments
+	SPLINE_BEZIER_QUAD,		// Composite quadratic Bezier: controls 2i..2i+2; (n-1)/2 segments
+};
+
+// Catmull-Rom & uniform B-spline basis matrices (rows: control points, columns: t^3, t^2, t, 1)
+constexpr mat44 MAT_CATMULL_ROM
+(
+	vec4f(-0.5f, 1.0f, -0.5f, 0.0f),
+	vec4f(1.5f, -2.5f, 0.0f, 1.0f),
+	vec4f(-1.5f, 2.0f, 0.5f, 0.0f),
+	vec4f(0.5f, -0.5f, 0.0f, 0.0f)
+);
+
+constexpr mat44 MAT_BSPLINE
+(
+	vec4f(-1.0f / 6.0f, 3.0f / 6.0f, -3.0f / 6.0f, 1.0f / 6.0f),
+	vec4f(3.0f / 6.0f, -6.0f / 6.0f, 0.0f, 4.0f / 6.0f),
+	vec4f(-3.0f / 6.0f, 3.0f / 6.0f, 3.0f / 6.0f, 1.0f / 6.0f),
+	vec4f(1.0f / 6.0f, 0.0f, 0.0f, 0.0f)
+);
+
+/**
+ *	CLASS: Spline3D
+ *	Spline parameter u runs over the knots: segment i covers [knot i, knot i+1].
+ *	Without explicit knots these are uniform over [0, 1], and the segment is
+ *	found in O(1); otherwise by binary search. Knots only reparameterize time,
+ *	the shape of each segment is unchanged.
+ */
+class Spline3D
+{
+protected:
+	///////////////////////////////////
+	// Properties
+	SplineType m_type;
+	std::vector<mat34> m_coeffs;	// Per segment; row = axis, columns = t^3, t^2, t, 1
+	std::vector<float> m_knots;		// numSegments + 1 increasing values
+	bool m_bUniform;				// Knots are uniform over [0, 1]
+
+public:
+	///////////////////////////////////
+	// Setup & Initialization
+	/**
+	 *	@param	type			Spline type (see SplineType)
+	 *	@param	pControls		Control points
+	 *	@param	numControls		Number of control points (extra trailing controls that
+	 *							don't complete a segment are ignored)
+	 *	@param	pKnots			Optional increasing knot values, one more than the segment
+	 *							count (NULL: uniform over [0, 1])
+	 */
+	Spline3D(SplineType type, const vec3f* pControls, size_t numControls, const float* pKnots = NULL);
+
+	///////////////////////////////////
+	// Getter/Setters
+	SplineType GetType() const
+	{
+		return m_type;
+	}
+
+	size_t GetNumSegments() const
+	{
+		return m_coeffs.size();
+	}
+
+	// Segment containing u (clamped to the knot range); writes the local t in [0, 1] to pT
+	size_t GetSegment(float u, float* pT) const;
+
+	///////////////////////////////////
+	// Evaluation
+	vec3f GetPoint(float u) const;
+	vec3f GetSegmentPoint(size_t idxSegment, float t) const;
+
+	// Bulk: point j at pU[j] (rResult is resized to count). Multithreaded for large counts.
+	void GetPoints(const float* pU, vec3f* pResult, size_t count) const;
+	void GetPoints(const float* pU, size_t count, vec3fStream& rResult) const;
+	// count samples evenly spaced in u over the whole spline (first & last knots included);
+	// segments are walked in order so no per-sample lookup is needed
+	void GetPointsUniform(vec3f* pResult, size_t count) const;
+};
+
+#endif // #ifndef __SPLINE_H__
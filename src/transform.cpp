@@ -0,0 +1,65 @@
+#include "transform.h"
+
+//////////////////////////////////////////////////////////
+// CLASS: Transform
+// DESCR: TRS transform
+//////////////////////////////////////////////////////////
+
+/**
+*	Compose two transforms without going through mat44
+*	@param	tfParent	Outer transform (applied last)
+*	@param	tfChild		Inner transform (applied first)
+*	@return transform	tfParent(tfChild(p)) for any point p
+**/
+Transform Transform::Compose(const Transform& tfParent, const Transform& tfChild)
+{
+	return Transform
+	(
+		tfParent.TransformPoint(tfChild.m_translation),
+		tfParent.m_rotation * tfChild.m_rotation,
+		tfParent.m_scale * tfChild.m_scale
+	);
+}
+
+Transform Transform::GetInverse() const
+{
+	// p = T + s*R(p')  =>  p' = (1/s) * R^-1(p - T)
+	Quaternion rot_inv = m_rotation.GetConjugate();
+	float scale_inv = 1.0f / m_scale;
+
+	return Transform(-scale_inv * rot_inv.RotateVector(m_translation), rot_inv, scale_inv);
+}
+
+void Transform::Normalize()
+{
+	m_rotation.Normalize();
+}
+
+vec3f Transform::TransformPoint(vec3f point) const
+{
+	return m_translation + (m_scale * m_rotation.RotateVector(point));
+}
+
+vec3f Transform::TransformDirection(vec3f dir) const
+{
+	return m_scale * m_rotation.RotateVector(dir);
+}
+
+mat44 Transform::GetMatrix() const
+{
+	mat33 mat_rot = m_rotation.GetRotationMatrix33();
+
+	mat44 mat_result;
+	for (int r = 0; r < 3; r++)
+	{
+		mat_result[r] = vec4f(m_scale * mat_rot[r][0], m_scale * mat_rot[r][1], m_scale * mat_rot[r][2], m_translation[r]);
+	}
+	mat_result[3] = vec4f(0.0f, 0.0f, 0.0f, 1.0f);
+
+	return mat_result;
+}
+
+Transform operator*(const Transform& tfParent, const Transform& tfChild)
+{
+	return Transform::Compose(tfParent, tfChild);
+}
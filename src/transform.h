@@ -0,0 +1,93 @@
+#pragma once
+#ifndef __TRANSFORM_H__
+#define __TRANSFORM_H__
+
+/**
+ *	FILE: transform.h
+ *	Translate/Rotate/Scale transform stored as (vec3f, Quaternion, float).
+ *	Transforms compose & invert without building matrices; call GetMatrix()
+ *	only when vertices actually need transforming (e.g. mat44::TransformPoints).
+ *
+ *	Applied to a point p:  T + s * (R rotate p)
+ */
+
+// Includes: Project
+#include "vec.h"
+#include "mat.h"
+#include "quat.h"
+
+/**
+ *	CLASS: Transform
+ *	:NOTE: Scale is uniform so that the composition of two transforms is
+ *	always another TRS transform (non-uniform scale under rotation shears).
+ */
+class Transform
+{
+protected:
+	vec3f m_translation;
+	Quaternion m_rotation;	// Unit quaternion
+	float m_scale;
+
+public:
+	/////////////////////////////////////////
+	// Setup & Initialization
+	Transform(vec3f translation = vec3f(0.0f, 0.0f, 0.0f), Quaternion rotation = QUAT_IDENTITY, float fScale = 1.0f) :
+		m_translation(translation),
+		m_rotation(rotation),
+		m_scale(fScale)
+	{
+	}
+
+	/////////////////////////////////////////
+	// Accessors
+	vec3f GetTranslation() const
+	{
+		return m_translation;
+	}
+
+	void SetTranslation(vec3f translation)
+	{
+		m_translation = translation;
+	}
+
+	Quaternion GetRotation() const
+	{
+		return m_rotation;
+	}
+
+	void SetRotation(Quaternion rotation)
+	{
+		m_rotation = rotation;
+	}
+
+	float GetScale() const
+	{
+		return m_scale;
+	}
+
+	void SetScale(float fScale)
+	{
+		m_scale = fScale;
+	}
+
+	/////////////////////////////////////////
+	// Calculations
+
+	// Combined transform: apply tfChild first, then tfParent (same order as matParent * matChild)
+	static Transform Compose(const Transform& tfParent, const Transform& tfChild);
+	Transform GetInverse() const;
+
+	// Renormalize the rotation (call occasionally when composing long chains)
+	void Normalize();
+
+	vec3f TransformPoint(vec3f point) const;
+	vec3f TransformDirection(vec3f dir) const;
+
+	// Equivalent matrix: translation * rotation * scale
+	mat44 GetMatrix() const;
+};
+
+// Operator*: Same as Transform::Compose(tfParent, tfChild)
+Transform operator*(const Transform& tfParent, const Transform& tfChild);
+
+#endif // #ifndef __TRANSFORM_H__
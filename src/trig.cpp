@@ -0,0 +1,96 @@
+#include "trig.h"
+
+// Includes: Project
+#include "simd.h"
+#include "parallel.h"
+
+// Below this many angles per thread, the batched versions stay on the calling thread
+#define TRIG_BATCH_GRAIN		(1 << 14)
+// Table entries over [0, 45] degrees, plus one so interpolating at 45 stays in bounds
+#define TRIG_TABLE_SIZE			(45 * TRIG_TABLE_STEPS_PER_DEGREE + 1)
+
+// Batch kernels, one copy per instruction set (see simd_kernels.inl)
+#define SIMD_KERNEL_FILE "trig_kernels.inl"
+#include "simd_kernels.inl"
+
+//////////////////////////////////////////////////////////
+// Table mode
+//////////////////////////////////////////////////////////
+
+struct TrigTable
+{
+	float sins[TRIG_TABLE_SIZE];
+	float coss[TRIG_TABLE_SIZE];
+
+	TrigTable()
+	{
+		for (int i = 0; i < TRIG_TABLE_SIZE; i++)
+		{
+			double radians = ((double)i / TRIG_TABLE_STEPS_PER_DEGREE) * (M_PI / 180.0);
+			sins[i] = (float)sin(radians);
+			coss[i] = (float)cos(radians);
+		}
+	}
+};
+
+// :NOTE: Built on first use, so it's safe to call from other files' static initializers
+static const TrigTable& GetTrigTable()
+{
+	static const TrigTable s_table;
+	return s_table;
+}
+
+void SinCosTableD(float fDegrees, float& rSin, float& rCos)
+{
+	if (fabsf(fDegrees) > TRIG_DEGREES_MAX)
+	{
+		double radians = fmod((double)fDegrees, 360.0) * (M_PI / 180.0);
+		rSin = (float)sin(radians);
+		rCos = (float)cos(radians);
+		return;
+	}
+
+	// Same exact reduction as SinCosD(), to [-45, 45] degrees
+	float k = (fDegrees * TRIG_1_OVER_90 + TRIG_ROUND_MAGIC) - TRIG_ROUND_MAGIC;
+	float degrees = fDegrees - (k * 90.0f);
+
+	float pos = fabsf(degrees) * TRIG_TABLE_STEPS_PER_DEGREE;
+	int idx = (int)pos;
+	if (idx > TRIG_TABLE_SIZE - 2)
+	{
+		idx = TRIG_TABLE_SIZE - 2;	// (1 / 90) rounding can leave |degrees| a hair over 45
+	}
+	float t = pos - (float)idx;
+
+	const TrigTable& table = GetTrigTable();
+	float s = table.sins[idx] + ((table.sins[idx + 1] - table.sins[idx]) * t);
+	float c = table.coss[idx] + ((table.coss[idx + 1] - table.coss[idx]) * t);
+	SinCosToQuadrant(copysignf(s, degrees), c, GetQuadrant(k), rSin, rCos);	// sin is odd, cos even
+}
+
+//////////////////////////////////////////////////////////
+// Batched
+//////////////////////////////////////////////////////////
+
+void SinCos(const float* pRadians, float* pSin, float* pCos, size_t count)
+{
+	ParallelFor(count, TRIG_BATCH_GRAIN, [&](size_t begin, size_t end)
+	{
+		SIMD_DISPATCH(KernelSinCos, (pRadians, false, pSin, pCos, begin, end));
+	});
+}
+
+void SinCosD(const float* pDegrees, float* pSin, float* pCos, size_t count)
+{
+	ParallelFor(count, TRIG_BATCH_GRAIN, [&](size_t begin, size_t end)
+	{
+#if defined TRIG_USE_DEGREE_TABLE
+		for (size_t i = begin; i < end; i++)
+		{
+			SinCosTableD(pDegrees[i], pSin[i], pCos[i]);
+		}
+#else
+		SIMD_DISPATCH(KernelSinCos, (pDegrees, true, pSin, pCos, begin, end));
+#endif
+	});
+}
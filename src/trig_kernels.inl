@@ -0,0 +1,80 @@
+/**
+ *	FILE: trig_kernels.inl
+ *	trig.cpp's batch kernels; included by simd_kernels.inl, once per instruction
+ *	set.
+ */
+
+// Round to the nearest integer (|a| < 2^22), as in trig.h
+template <class S>
+static typename S::type TrigRound(typename S::type a)
+{
+	const typename S::type magic = S::Set1(TRIG_ROUND_MAGIC);
+	return S::Sub(S::Add(a, magic), magic);
+}
+
+/**
+ *	SinCos()/SinCosD() kernel, S::WIDTH angles per iteration: the same reduction &
+ *	polynomials as SinCosQuadrant(), with the quadrant's swaps & sign flips done by
+ *	lane selects. A vector with any lane out of range goes through the single
+ *	versions (which fall back to libm).
+ */
+template <class S>
+static void KernelSinCos(const float* pAngles, bool bDegrees, float* pSin, float* pCos, size_t begin, size_t end)
+{
+	typedef typename S::type lane;
+	const lane angle_max = S::Set1(bDegrees ? TRIG_DEGREES_MAX : TRIG_RADIANS_MAX);
+	const lane neg_zero = S::Set1(-0.0f);
+
+	size_t i = begin;
+	for (; i + S::WIDTH <= end; i += S::WIDTH)
+	{
+		lane angle = S::Load(pAngles + i);
+		if (S::MoveMask(S::CmpGT(S::Abs(angle), angle_max)) != 0)
+		{
+			for (size_t j = i; j < i + S::WIDTH; j++)
+			{
+				if (bDegrees)
+				{
+					SinCosD(pAngles[j], pSin[j], pCos[j]);
+				}
+				else
+				{
+					SinCos(pAngles[j], pSin[j], pCos[j]);
+				}
+			}
+			continue;
+		}
+
+		lane k, x;
+		if (bDegrees)
+		{
+			k = TrigRound<S>(S::Mul(angle, S::Set1(TRIG_1_OVER_90)));
+			x = S::Mul(S::Sub(angle, S::Mul(k, S::Set1(90.0f))), S::Set1(TRIG_PI_OVER_180));
+		}
+		else
+		{
+			k = TrigRound<S>(S::Mul(angle, S::Set1(TRIG_2_OVER_PI)));
+			x = S::Sub(S::Sub(S::Sub(angle, S::Mul(k, S::Set1(TRIG_PI_OVER_2_A))), S::Mul(k, S::Set1(TRIG_PI_OVER_2_B))), S::Mul(k, S::Set1(TRIG_PI_OVER_2_C)));
+		}
+		lane quadrant = S::Sub(k, S::Mul(S::Set1(4.0f), TrigRound<S>(S::Mul(S::Sub(k, S::Set1(1.5f)), S::Set1(0.25f)))));
+
+		lane z = S::Mul(x, x);
+		lane s = S::Add(S::Mul(S::Mul(S::Add(S::Mul(S::Add(S::Mul(S::Set1(TRIG_SIN_C2), z), S::Set1(TRIG_SIN_C1)), z), S::Set1(TRIG_SIN_C0)), z), x), x);
+		lane c = S::Add(S::Sub(S::Mul(S::Mul(S::Add(S::Mul(S::Add(S::Mul(S::Set1(TRIG_COS_C2), z), S::Set1(TRIG_COS_C1)), z), S::Set1(TRIG_COS_C0)), z), z), S::Mul(S::Set1(0.5f), z)), S::Set1(1.0f));
+
+		// Odd quadrants swap sin & cos; quadrants 2-3 negate sin, 1-2 negate cos
+		lane odd = S::Sub(quadrant, S::Mul(S::Set1(2.0f), TrigRound<S>(S::Sub(S::Mul(quadrant, S::Set1(0.5f)), S::Set1(0.25f)))));
+		typename S::mask b_odd = S::CmpGT(odd, S::Set1(0.5f));
+		lane sin_q = S::Select(b_odd, c, s);
+		lane cos_q = S::Select(b_odd, s, c);
+		typename S::mask b_neg_sin = S::CmpGT(quadrant, S::Set1(1.5f));
+		typename S::mask b_neg_cos = S::And(S::CmpGT(quadrant, S::Set1(0.5f)), S::CmpLT(quadrant, S::Set1(2.5f)));
+		S::Store(pSin + i, S::Select(b_neg_sin, S::FlipSign(sin_q, neg_zero), sin_q));
+		S::Store(pCos + i, S::Select(b_neg_cos, S::FlipSign(cos_q, neg_zero), cos_q));
+	}
+
+	if (i < end)
+	{
+		KernelSinCos<SimdScalar>(pAngles, bDegrees, pSin, pCos, i, end);
+	}
+}
@@ -4,297 +4,496 @@
 
 /**
  *	FILE: vec.h
- *	2D, 3D, and 4D vector implementations. 
+ *	2D, 3D, and 4D vector implementations.
  *	Written to study/reinforce 3D math knowledge.
+ *
+ *	Everything except the DEBUG printing is inline (& constexpr where
+ *	possible) so small vector math inlines across translation units and
+ *	constant vectors fold at compile time.
+ *
+ *	All vectors are instances of vec<T, vecSize>; vec2f/vec3f/vec4f (and
+ *	the double/int variants) are typedefs of it. Per-component loops are
+ *	unrolled at compile time via index sequences.
  */
 
 // Includes: Standard
 #define _USE_MATH_DEFINES
 #include <math.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <type_traits>
+#include <utility>
+
+// Includes: Project
+#include "simd.h"
 
 // DEGREES-TO-RADIAN FUNCTION :TODO: Put somewhere else
-static float DegreesToRadians(float fDegrees)
+constexpr float DegreesToRadians(float fDegrees)
 {
-	return (float)(fDegrees * (M_PI / 180.0f));
+	return fDegrees * (float)(M_PI / 180.0);
 }
 
-//#define __TEMPLATE_VEC__
-#if defined __TEMPLATE_VEC__
+/**
+ *	VEC_IS_CONSTANT_EVALUATED()
+ *	True while the compiler is evaluating a constant expression. The SIMD
+ *	specializations (float x4 & double x4) only take their intrinsic path at
+ *	runtime, so the same functions stay usable in constexpr contexts. If the
+ *	compiler can't tell the difference, the SIMD specializations are disabled
+ *	rather than losing constexpr support.
+ */
+#if defined __has_builtin
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define VEC_HAS_IS_CONSTANT_EVALUATED
+#endif
+#elif defined _MSC_VER && _MSC_VER >= 1925
+#define VEC_HAS_IS_CONSTANT_EVALUATED
+#endif
+
+#if defined VEC_HAS_IS_CONSTANT_EVALUATED && defined SIMD_HAS_SSE && !defined VEC_NO_SIMD
+#define VEC_SIMD
+#define VEC_IS_CONSTANT_EVALUATED()	__builtin_is_constant_evaluated()
+#endif
 
+template <class T, unsigned vecSize> class vec;
+
+// Wraps T so scalar arguments don't take part in template deduction (2 * vec3f still works)
+template <class T>
+struct vecScalar
+{
+	typedef T type;
+};
+
+/**
+ *	STRUCT: vecOps
+ *	Generic (compile-time unrolled) implementations of the component-wise
+ *	vector operations. Results are always accumulated in component order,
+ *	e.g. ((x1*x2 + y1*y2) + z1*z2), matching the SIMD specializations.
+ */
+template <class T, unsigned vecSize>
+struct vecOps
+{
+	typedef vec<T, vecSize> vec_t;
+
+	template <size_t... I>
+	static constexpr vec_t Add(const vec_t& v1, const vec_t& v2, std::index_sequence<I...>)
+	{
+		return vec_t((v1[I] + v2[I])...);
+	}
+
+	template <size_t... I>
+	static constexpr vec_t Sub(const vec_t& v1, const vec_t& v2, std::index_sequence<I...>)
+	{
+		return vec_t((v1[I] - v2[I])...);
+	}
+
+	template <size_t... I>
+	static constexpr vec_t Scale(const T fScalar, const vec_t& v, std::index_sequence<I...>)
+	{
+		return vec_t((fScalar * v[I])...);
+	}
+
+	// Dot product of the first numComps components
+	template <unsigned numComps>
+	static constexpr T Dot(const vec_t& v1, const vec_t& v2)
+	{
+		return DotStep(v1, v2, std::integral_constant<unsigned, numComps>());
+	}
+
+private:
+	static constexpr T DotStep(const vec_t& v1, const vec_t& v2, std::integral_constant<unsigned, 1>)
+	{
+		return (v1[0] * v2[0]);
+	}
+
+	template <unsigned numComps>
+	static constexpr T DotStep(const vec_t& v1, const vec_t& v2, std::integral_constant<unsigned, numComps>)
+	{
+		return (DotStep(v1, v2, std::integral_constant<unsigned, numComps - 1>()) + (v1[numComps - 1] * v2[numComps - 1]));
+	}
+};
+
+// True if every type in Args converts to T (used to constrain the component constructor)
+template <class T, class... Args>
+struct vecArgsConvertible;
+
+template <class T>
+struct vecArgsConvertible<T> : std::true_type
+{
+};
+
+template <class T, class Arg, class... Args>
+struct vecArgsConvertible<T, Arg, Args...> :
+	std::integral_constant<bool, std::is_arithmetic<typename std::decay<Arg>::type>::value && vecArgsConvertible<T, Args...>::value>
+{
+};
+
+/**
+ *	CLASS: vec<T, vecSize>
+ *	Fixed-size vector with the usual mathematical functions.
+ */
 template <class T, unsigned vecSize>
 class vec
 {
 protected:
+	///////////////////////////////////
+	// Properties
 	T m_vec[vecSize];
 
 public:
+	///////////////////////////////////
 	// Setup & Initialization
-	vec(...)
+	constexpr vec() :
+		m_vec{}
 	{
+	}
 
+	// Component constructor: vec3f(x, y, z); omitted trailing components are 0
+	template <class... Args, class = typename std::enable_if<(sizeof...(Args) >= 1) && (sizeof...(Args) <= vecSize) && vecArgsConvertible<T, Args...>::value>::type>
+	constexpr vec(Args... args) :
+		m_vec{ static_cast<T>(args)... }
+	{
 	}
-	vec();
 
-	// Maths
-	static T DotProduct(const vec<T,vecSize> v1, const vec<T,vecSize> v2)
+	///////////////////////////////////
+	// Getter/Setters
+	constexpr T operator[](int idx) const
 	{
-		int val_dp = 0;
-		for (int i = 0; i < vecSize; i++)
-		{
-			val_dp += (v1.m_vec[i] * v2.m_vec[i]);
-		}
-		return val_dp;
+		return m_vec[idx];
 	}
 
-	T GetNorm() const
+	constexpr T& operator[](int idx)
 	{
-		return sqrt(DotProduct(*this, *this)));
+		return m_vec[idx];
 	}
 
-	void Normalize()
+	// Raw component storage (for SIMD loads/stores)
+	constexpr const T* Data() const
 	{
-		T vec_norm = GetNorm();
-		for (int i = 0; i < vecSize; i++)
-		{
-			m_vec[i] /= vec_norm;
-		}
+		return m_vec;
 	}
-/*
-public:
-	
-	vec2f();
-	vec2f(float x, float y);
 
-	// Getter/Setters
-	float& x()
+	constexpr T* Data()
 	{
-		return m_x;
+		return m_vec;
 	}
 
-	float x() const
+	// Alternate accessors added for code readability.
+	constexpr T& x()
 	{
-		return m_x;
+		return m_vec[0];
 	}
 
-	void Normalize()
+	constexpr T x() const
 	{
-		float vec_norm = GetNorm();
-		m_x /= vec_norm;
-		m_y /= vec_norm;
+		return m_vec[0];
 	}
 
-	// Add
-	vec2f operator+(const vec2f v2) const
+	constexpr T& y()
 	{
-		return vec2f(m_x + v2.m_x, m_y + v2.m_y);
+		return m_vec[1];
 	}
-	// Subtract
-	vec2f operator-(const vec2f v2) const
+
+	constexpr T y() const
 	{
-		return vec2f(m_x - v2.m_x, m_y - v2.m_y);
+		return m_vec[1];
 	}
-	// Multiply (scalar)
-	vec2f operator*(const float fScalar) const
+
+	constexpr T& z()
 	{
-		return vec2f(fScalar * m_x, fScalar * m_y);
+		static_assert(vecSize >= 3, "vec has no z component");
+		return m_vec[2];
 	}
 
-#if defined _DEBUG
+	constexpr T z() const
+	{
+		static_assert(vecSize >= 3, "vec has no z component");
+		return m_vec[2];
+	}
+
+	constexpr T& w()
+	{
+		static_assert(vecSize >= 4, "vec has no w component");
+		return m_vec[3];
+	}
+
+	constexpr T w() const
+	{
+		static_assert(vecSize >= 4, "vec has no w component");
+		return m_vec[3];
+	}
+
+	///////////////////////////////////
+	// Math
+	static constexpr T DotProduct(const vec v1, const vec v2);
+
+	static constexpr vec CrossProduct(const vec v1, const vec v2)
+	{
+		static_assert(vecSize == 3, "CrossProduct is only defined for 3D vectors");
+		return vec
+		(
+			(v1.y() * v2.z()) - (v1.z() * v2.y()),
+			(v1.z() * v2.x()) - (v1.x() * v2.z()),
+			(v1.x() * v2.y()) - (v1.y() * v2.x())
+		);
+	}
+
+	// Magnitude
+	T Mag() const
+	{
+		return (T) sqrt(DotProduct(*this, *this));
+	}
+
+	void Normalize()
+	{
+		T vec_norm = Mag();	// :NOTE: Not verifying that our magnitude is > 0
+		NormalizeStep(vec_norm, std::make_index_sequence<vecSize>());
+	}
+
+	///////////////////////
 	// DEBUG
 	void Print()
 	{
-		printf("(%f, %f)\n", m_x, m_y);
-	}
+#if defined _DEBUG
+		printf("(");
+		for (unsigned i = 0; i < vecSize; i++)
+		{
+			printf((i + 1 < vecSize) ? "%f, " : "%f)\n", (double)m_vec[i]);
+		}
 #endif
-	*/
-};
+	}
 
-typedef vec<float, 2> vec2f;
-typedef vec<float, 3> vec3f;
-typedef vec<float, 4> vec4f;
+private:
+	template <size_t... I>
+	void NormalizeStep(T vecNorm, std::index_sequence<I...>)
+	{
+		int expand[] = { (m_vec[I] /= vecNorm, 0)... };
+		(void)expand;
+	}
+};
 
-#else
 /**
- *	CLASS: vec2f
+ *	CLASS: vec<T, 2>
  *	Super-basic 2D vector. Written somewhat sloppily since 2D
  *	vectors probably aren't as useful in 3D applications, other
  *	than as screen/UI coordinates, I guess.
+ *	Specialized so the components stay plain x/y members.
  */
-struct vec2f
+template <class T>
+class vec<T, 2>
 {
 // Member Variables
 public:
 	// Properties (Not using traditional notation for ease of use)
-	float x;
-	float y;
+	T x;
+	T y;
 
 // Member Functions
 public:
 	// Setup & Initialization
-	vec2f();
-	vec2f(float fX, float fY);
-
-	// Maths
-	static float DotProduct(const vec2f v1, const vec2f v2);
-	float Mag() const;	// Magnitude
-	void Normalize();
-
-	///////////////////////
-	// DEBUG
-	void Print();
-};
-// vec2f: Operator Overloads
-vec2f operator-(const vec2f v);
-vec2f operator+(const vec2f v1, const vec2f v2);
-vec2f operator-(const vec2f v1, const vec2f v2);
-vec2f operator*(const float fScalar, const vec2f vec);
-
-
-/**
- *	CLASS: vec3f
- *	3D vector class with the usual mathematical functions.
- */
-class vec3f
-{
-protected:
-	///////////////////////////////////
-	// Properties
-	float m_vec[3];
-
-public:
-	///////////////////////////////////
-	// Setup & Initialization
-	vec3f(float x = 0.0f, float y = 0.0f, float z = 0.0f);
-
-	///////////////////////////////////
-	// Getter/Setters
-	float operator[](int idx) const;
-	float& operator[](int idx);
-
-	// Alternate accessors added for code readability.
-	float& x()
+	constexpr vec() : vec(T(0), T(0))
 	{
-		return m_vec[0];
 	}
 
-	float x() const
+	constexpr vec(T fX, T fY) :
+		x(fX),
+		y(fY)
 	{
-		return m_vec[0];
 	}
 
-	float& y()
+	// Getter/Setters
+	constexpr T operator[](int idx) const
 	{
-		return m_vec[1];
+		return (idx == 0 ? x : y);
 	}
 
-	float y() const
+	constexpr T& operator[](int idx)
 	{
-		return m_vec[1];
+		return (idx == 0 ? x : y);
 	}
 
-	float& z()
+	// Maths
+	static constexpr T DotProduct(const vec v1, const vec v2)
 	{
-		return m_vec[2];
+		return (v1.x * v2.x + v1.y * v2.y);
 	}
 
-	float z() const
+	// Magnitude
+	T Mag() const
 	{
-		return m_vec[2];
+		return (T) sqrt(x * x + y * y);
 	}
 
-	///////////////////////////////////
-	// Math
-	static float DotProduct(const vec3f v1, const vec3f v2);
-	static vec3f CrossProduct(const vec3f v1, const vec3f v2);
-	float Mag() const; // Magnitude
-	void Normalize();
+	void Normalize()
+	{
+		T vec_norm = Mag();
+		x /= vec_norm;
+		y /= vec_norm;
+	}
 
 	///////////////////////
 	// DEBUG
-	void Print();
+	void Print()
+	{
+#if defined _DEBUG
+		printf("(%f, %f)\n", (double)x, (double)y);
+#endif
+	}
 };
 
-// vec3f: Operator Overloads
-vec3f operator-(const vec3f v);
-vec3f operator+(const vec3f v1, const vec3f v2);
-vec3f operator-(const vec3f v1, const vec3f v2);
-vec3f operator*(const float fScalar, const vec3f vec);
+// Vector types
+typedef vec<float, 2>	vec2f;
+typedef vec<float, 3>	vec3f;
+typedef vec<float, 4>	vec4f;
+typedef vec<double, 2>	vec2d;
+typedef vec<double, 3>	vec3d;
+typedef vec<double, 4>	vec4d;
+typedef vec<int, 2>		vec2i;
+typedef vec<int, 3>		vec3i;
+typedef vec<int, 4>		vec4i;
+
+//////////////////////////////////////////////////////////
+// vec: Generic Operator Overloads
+//////////////////////////////////////////////////////////
 
+template <class T, unsigned vecSize>
+constexpr T vec<T, vecSize>::DotProduct(const vec v1, const vec v2)
+{
+	return vecOps<T, vecSize>::template Dot<vecSize>(v1, v2);
+}
+
+// Operator Overload: Add
+template <class T, unsigned vecSize>
+constexpr vec<T, vecSize> operator+(const vec<T, vecSize> v1, const vec<T, vecSize> v2)
+{
+	return vecOps<T, vecSize>::Add(v1, v2, std::make_index_sequence<vecSize>());
+}
 
+// Operator Overload: Subtract
+template <class T, unsigned vecSize>
+constexpr vec<T, vecSize> operator-(const vec<T, vecSize> v1, const vec<T, vecSize> v2)
+{
+	return vecOps<T, vecSize>::Sub(v1, v2, std::make_index_sequence<vecSize>());
+}
 
-class vec4f
+// Operator Overload: Scalar Multiplication
+template <class T, unsigned vecSize>
+constexpr vec<T, vecSize> operator*(const typename vecScalar<T>::type fScalar, const vec<T, vecSize> v)
 {
-protected:
-	///////////////////////////////////
-	// Properties
-	float m_vec[4];
+	return vecOps<T, vecSize>::Scale(fScalar, v, std::make_index_sequence<vecSize>());
+}
 
-public:
-	///////////////////////////////////
-	// Setup & Initialization
-	vec4f(float x = 0.0f, float y = 0.0f, float z = 0.0f, float w = 0.0f);
+// Operator Overload: Negative
+template <class T, unsigned vecSize>
+constexpr vec<T, vecSize> operator-(const vec<T, vecSize> v)
+{
+	return (T(-1) * v);
+}
 
-	///////////////////////////////////
-	// Getter/Setters
-	float operator[](int idx) const;
-	float& operator[](int idx);
+//////////////////////////////////////////////////////////
+// vec: SIMD Specializations (float x4 & double x4)
+// Same operation order as the generic versions, so results are identical.
+//////////////////////////////////////////////////////////
 
-	float& x()
+#if defined VEC_SIMD
+template <>
+constexpr float vec<float, 4>::DotProduct(const vec v1, const vec v2)
+{
+	if (!VEC_IS_CONSTANT_EVALUATED())
 	{
-		return m_vec[0];
+		__m128 prod = _mm_mul_ps(_mm_loadu_ps(v1.Data()), _mm_loadu_ps(v2.Data()));
+		__m128 val_dp = _mm_add_ss(prod, _mm_shuffle_ps(prod, prod, _MM_SHUFFLE(1, 1, 1, 1)));
+		val_dp = _mm_add_ss(val_dp, _mm_movehl_ps(prod, prod));
+		val_dp = _mm_add_ss(val_dp, _mm_shuffle_ps(prod, prod, _MM_SHUFFLE(3, 3, 3, 3)));
+		return _mm_cvtss_f32(val_dp);
 	}
+	return vecOps<float, 4>::Dot<4>(v1, v2);
+}
 
-	float x() const
+constexpr vec4f operator+(const vec4f v1, const vec4f v2)
+{
+	if (!VEC_IS_CONSTANT_EVALUATED())
 	{
-		return m_vec[0];
+		vec4f v_result;
+		_mm_storeu_ps(v_result.Data(), _mm_add_ps(_mm_loadu_ps(v1.Data()), _mm_loadu_ps(v2.Data())));
+		return v_result;
 	}
+	return vecOps<float, 4>::Add(v1, v2, std::make_index_sequence<4>());
+}
 
-	float& y()
+constexpr vec4f operator-(const vec4f v1, const vec4f v2)
+{
+	if (!VEC_IS_CONSTANT_EVALUATED())
 	{
-		return m_vec[1];
+		vec4f v_result;
+		_mm_storeu_ps(v_result.Data(), _mm_sub_ps(_mm_loadu_ps(v1.Data()), _mm_loadu_ps(v2.Data())));
+		return v_result;
 	}
+	return vecOps<float, 4>::Sub(v1, v2, std::make_index_sequence<4>());
+}
 
-	float y() const
+constexpr vec4f operator*(const float fScalar, const vec4f v)
+{
+	if (!VEC_IS_CONSTANT_EVALUATED())
 	{
-		return m_vec[1];
+		vec4f v_result;
+		_mm_storeu_ps(v_result.Data(), _mm_mul_ps(_mm_set1_ps(fScalar), _mm_loadu_ps(v.Data())));
+		return v_result;
 	}
+	return vecOps<float, 4>::Scale(fScalar, v, std::make_index_sequence<4>());
+}
 
-	float& z()
+// double x4 as two SSE2 __m128d halves: (x, y) & (z, w)
+template <>
+constexpr double vec<double, 4>::DotProduct(const vec v1, const vec v2)
+{
+	if (!VEC_IS_CONSTANT_EVALUATED())
 	{
-		return m_vec[2];
+		__m128d prod_lo = _mm_mul_pd(_mm_loadu_pd(v1.Data()), _mm_loadu_pd(v2.Data()));
+		__m128d prod_hi = _mm_mul_pd(_mm_loadu_pd(v1.Data() + 2), _mm_loadu_pd(v2.Data() + 2));
+		__m128d val_dp = _mm_add_sd(prod_lo, _mm_unpackhi_pd(prod_lo, prod_lo));
+		val_dp = _mm_add_sd(val_dp, prod_hi);
+		val_dp = _mm_add_sd(val_dp, _mm_unpackhi_pd(prod_hi, prod_hi));
+		return _mm_cvtsd_f64(val_dp);
 	}
+	return vecOps<double, 4>::Dot<4>(v1, v2);
+}
 
-	float z() const
+constexpr vec4d operator+(const vec4d v1, const vec4d v2)
+{
+	if (!VEC_IS_CONSTANT_EVALUATED())
 	{
-		return m_vec[2];
+		vec4d v_result;
+		_mm_storeu_pd(v_result.Data(), _mm_add_pd(_mm_loadu_pd(v1.Data()), _mm_loadu_pd(v2.Data())));
+		_mm_storeu_pd(v_result.Data() + 2, _mm_add_pd(_mm_loadu_pd(v1.Data() + 2), _mm_loadu_pd(v2.Data() + 2)));
+		return v_result;
 	}
+	return vecOps<double, 4>::Add(v1, v2, std::make_index_sequence<4>());
+}
 
-	float& w()
+constexpr vec4d operator-(const vec4d v1, const vec4d v2)
+{
+	if (!VEC_IS_CONSTANT_EVALUATED())
 	{
-		return m_vec[3];
+		vec4d v_result;
+		_mm_storeu_pd(v_result.Data(), _mm_sub_pd(_mm_loadu_pd(v1.Data()), _mm_loadu_pd(v2.Data())));
+		_mm_storeu_pd(v_result.Data() + 2, _mm_sub_pd(_mm_loadu_pd(v1.Data() + 2), _mm_loadu_pd(v2.Data() + 2)));
+		return v_result;
 	}
+	return vecOps<double, 4>::Sub(v1, v2, std::make_index_sequence<4>());
+}
 
-	float w() const
+constexpr vec4d operator*(const double fScalar, const vec4d v)
+{
+	if (!VEC_IS_CONSTANT_EVALUATED())
 	{
-		return m_vec[3];
+		__m128d scalar = _mm_set1_pd(fScalar);
+		vec4d v_result;
+		_mm_storeu_pd(v_result.Data(), _mm_mul_pd(scalar, _mm_loadu_pd(v.Data())));
+		_mm_storeu_pd(v_result.Data() + 2, _mm_mul_pd(scalar, _mm_loadu_pd(v.Data() + 2)));
+		return v_result;
 	}
+	return vecOps<double, 4>::Scale(fScalar, v, std::make_index_sequence<4>());
+}
+#endif // #if defined VEC_SIMD
 
-	///////////////////////////////////
-	// Maths
-	static float DotProduct(const vec4f v1, const vec4f v2);
-	//static vec3f CrossProduct(const vec3f v1, const vec3f v2);
-	float Mag() const;	// Magnitude
-	void Normalize();
-
-	///////////////////////
-	// DEBUG
-	void Print();
-};
-
-// vec4f: Operator Overloads
-vec4f operator+(const vec4f v1, const vec4f v2);
-vec4f operator-(const vec4f v1, const vec4f v2);
-vec4f operator*(const float fScalar, const vec4f vec);
-#endif
-
-#endif // #ifndef __VEC_H__
\ No newline at end of file
+#endif // #ifndef __VEC_H__
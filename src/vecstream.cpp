@@ -0,0 +1,317 @@
+#include "vecstream.h"
+
+// Includes: Standard
+#include <string.h>
+#include <utility>
+
+// Batch kernels, one copy per instruction set (see simd_kernels.inl)
+#define SIMD_KERNEL_FILE "vecstream_kernels.inl"
+#include "simd_kernels.inl"
+
+//////////////////////////////////////////////////////////
+// CLASS: vecfStream (BASE)
+//////////////////////////////////////////////////////////
+
+// Round up to a multiple of the widest kernel so aligned full-width loads never run off the end
+static size_t PaddedCapacity(size_t size)
+{
+	return ((size + SIMD_WIDTH_MAX - 1) / SIMD_WIDTH_MAX) * SIMD_WIDTH_MAX;
+}
+
+template <unsigned numComps>
+vecfStream<numComps>::vecfStream(size_t size /*= 0*/) :
+	m_size(0),
+	m_capacity(0)
+{
+	for (unsigned c = 0; c < numComps; c++)
+	{
+		m_comps[c] = NULL;
+	}
+	Resize(size);
+}
+
+template <unsigned numComps>
+vecfStream<numComps>::vecfStream(const vecfStream& other) :
+	vecfStream(0)
+{
+	*this = other;
+}
+
+template <unsigned numComps>
+vecfStream<numComps>::vecfStream(vecfStream&& other) :
+	vecfStream(0)
+{
+	*this = std::move(other);
+}
+
+template <unsigned numComps>
+vecfStream<numComps>::~vecfStream()
+{
+	Release();
+}
+
+template <unsigned numComps>
+vecfStream<numComps>& vecfStream<numComps>::operator=(const vecfStream& other)
+{
+	if (this != &other)
+	{
+		Resize(other.m_size);
+		for (unsigned c = 0; c < numComps; c++)
+		{
+			memcpy(m_comps[c], other.m_comps[c], other.m_size * sizeof(float));
+		}
+	}
+	return *this;
+}
+
+template <unsigned numComps>
+vecfStream<numComps>& vecfStream<numComps>::operator=(vecfStream&& other)
+{
+	if (this != &other)
+	{
+		Release();
+		for (unsigned c = 0; c < numComps; c++)
+		{
+			m_comps[c] = other.m_comps[c];
+			other.m_comps[c] = NULL;
+		}
+		m_size = other.m_size;
+		m_capacity = other.m_capacity;
+		other.m_size = 0;
+		other.m_capacity = 0;
+	}
+	return *this;
+}
+
+template <unsigned numComps>
+void vecfStream<numComps>::Resize(size_t size)
+{
+	if (size > m_capacity)
+	{
+		size_t capacity = PaddedCapacity(size);
+		for (unsigned c = 0; c < numComps; c++)
+		{
+			float* p_comp = (float*)AlignedAlloc(capacity * sizeof(float));
+			if (m_comps[c] != NULL)
+			{
+				memcpy(p_comp, m_comps[c], m_size * sizeof(float));
+				AlignedFree(m_comps[c]);
+			}
+			m_comps[c] = p_comp;
+		}
+		m_capacity = capacity;
+	}
+
+	// Zero any newly exposed values (& the padding, to keep kernels away from garbage)
+	if (size > m_size)
+	{
+		for (unsigned c = 0; c < numComps; c++)
+		{
+			memset(m_comps[c] + m_size, 0, (m_capacity - m_size) * sizeof(float));
+		}
+	}
+	m_size = size;
+}
+
+template <unsigned numComps>
+void vecfStream<numComps>::Release()
+{
+	for (unsigned c = 0; c < numComps; c++)
+	{
+		AlignedFree(m_comps[c]);
+		m_comps[c] = NULL;
+	}
+	m_size = 0;
+	m_capacity = 0;
+}
+
+template class vecfStream<2>;
+template class vecfStream<3>;
+template class vecfStream<4>;
+
+//////////////////////////////////////////////////////////
+// CLASS: vec2fStream
+//////////////////////////////////////////////////////////
+
+vec2fStream::vec2fStream(size_t size /*= 0*/) :
+	vecfStream<2>(size)
+{
+}
+
+vec2fStream::vec2fStream(const vec2f* pVecs, size_t count) :
+	vecfStream<2>(count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		Set(i, pVecs[i]);
+	}
+}
+
+vec2f vec2fStream::Get(size_t idx) const
+{
+	return vec2f(m_comps[0][idx], m_comps[1][idx]);
+}
+
+void vec2fStream::Set(size_t idx, vec2f v)
+{
+	m_comps[0][idx] = v.x;
+	m_comps[1][idx] = v.y;
+}
+
+//////////////////////////////////////////////////////////
+// CLASS: vec3fStream
+//////////////////////////////////////////////////////////
+
+vec3fStream::vec3fStream(size_t size /*= 0*/) :
+	vecfStream<3>(size)
+{
+}
+
+vec3fStream::vec3fStream(const vec3f* pVecs, size_t count) :
+	vecfStream<3>(count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		Set(i, pVecs[i]);
+	}
+}
+
+vec3f vec3fStream::Get(size_t idx) const
+{
+	return vec3f(m_comps[0][idx], m_comps[1][idx], m_comps[2][idx]);
+}
+
+void vec3fStream::Set(size_t idx, vec3f v)
+{
+	m_comps[0][idx] = v.x();
+	m_comps[1][idx] = v.y();
+	m_comps[2][idx] = v.z();
+}
+
+void vec3fStream::Add(const vec3fStream& s1, const vec3fStream& s2, vec3fStream& rResult)
+{
+	size_t count = s1.Size();
+	rResult.Resize(count);
+	for (unsigned c = 0; c < 3; c++)
+	{
+		SIMD_DISPATCH(KernelAdd, (s1.m_comps[c], s2.m_comps[c], rResult.m_comps[c], 0, count));
+	}
+}
+
+void vec3fStream::Sub(const vec3fStream& s1, const vec3fStream& s2, vec3fStream& rResult)
+{
+	size_t count = s1.Size();
+	rResult.Resize(count);
+	for (unsigned c = 0; c < 3; c++)
+	{
+		SIMD_DISPATCH(KernelSub, (s1.m_comps[c], s2.m_comps[c], rResult.m_comps[c], 0, count));
+	}
+}
+
+void vec3fStream::Scale(const float fScalar, const vec3fStream& s, vec3fStream& rResult)
+{
+	size_t count = s.Size();
+	rResult.Resize(count);
+	for (unsigned c = 0; c < 3; c++)
+	{
+		SIMD_DISPATCH(KernelScale, (fScalar, s.m_comps[c], rResult.m_comps[c], 0, count));
+	}
+}
+
+void vec3fStream::CrossProduct(const vec3fStream& s1, const vec3fStream& s2, vec3fStream& rResult)
+{
+	size_t count = s1.Size();
+	rResult.Resize(count);
+	SIMD_DISPATCH(KernelCross, (s1.m_comps, s2.m_comps, rResult.m_comps, 0, count));
+}
+
+void vec3fStream::DotProduct(const vec3fStream& s1, const vec3fStream& s2, float* pResult)
+{
+	SIMD_DISPATCH(KernelDot3, (s1.m_comps, s2.m_comps, pResult, 0, s1.Size()));
+}
+
+void vec3fStream::Mag(float* pResult) const
+{
+	SIMD_DISPATCH(KernelMag3, (m_comps, pResult, 0, m_size));
+}
+
+void vec3fStream::Normalize()
+{
+	SIMD_DISPATCH(KernelNormalize3, (m_comps, 0, m_size));
+}
+
+//////////////////////////////////////////////////////////
+// CLASS: vec4fStream
+//////////////////////////////////////////////////////////
+
+vec4fStream::vec4fStream(size_t size /*= 0*/) :
+	vecfStream<4>(size)
+{
+}
+
+vec4fStream::vec4fStream(const vec4f* pVecs, size_t count) :
+	vecfStream<4>(count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		Set(i, pVecs[i]);
+	}
+}
+
+vec4f vec4fStream::Get(size_t idx) const
+{
+	return vec4f(m_comps[0][idx], m_comps[1][idx], m_comps[2][idx], m_comps[3][idx]);
+}
+
+void vec4fStream::Set(size_t idx, vec4f v)
+{
+	m_comps[0][idx] = v.x();
+	m_comps[1][idx] = v.y();
+	m_comps[2][idx] = v.z();
+	m_comps[3][idx] = v.w();
+}
+
+void vec4fStream::Add(const vec4fStream& s1, const vec4fStream& s2, vec4fStream& rResult)
+{
+	size_t count = s1.Size();
+	rResult.Resize(count);
+	for (unsigned c = 0; c < 4; c++)
+	{
+		SIMD_DISPATCH(KernelAdd, (s1.m_comps[c], s2.m_comps[c], rResult.m_comps[c], 0, count));
+	}
+}
+
+void vec4fStream::Sub(const vec4fStream& s1, const vec4fStream& s2, vec4fStream& rResult)
+{
+	size_t count = s1.Size();
+	rResult.Resize(count);
+	for (unsigned c = 0; c < 4; c++)
+	{
+		SIMD_DISPATCH(KernelSub, (s1.m_comps[c], s2.m_comps[c], rResult.m_comps[c], 0, count));
+	}
+}
+
+void vec4fStream::Scale(const float fScalar, const vec4fStream& s, vec4fStream& rResult)
+{
+	size_t count = s.Size();
+	rResult.Resize(count);
+	for (unsigned c = 0; c < 4; c++)
+	{
+		SIMD_DISPATCH(KernelScale, (fScalar, s.m_comps[c], rResult.m_comps[c], 0, count));
+	}
+}
+
+void vec4fStream::DotProduct(const vec4fStream& s1, const vec4fStream& s2, float* pResult)
+{
+	SIMD_DISPATCH(KernelDot4, (s1.m_comps, s2.m_comps, pResult, 0, s1.Size()));
+}
+
+void vec4fStream::Mag(float* pResult) const
+{
+	SIMD_DISPATCH(KernelMag4, (m_comps, pResult, 0, m_size));
+}
+
+void vec4fStream::Normalize()
+{
+	SIMD_DISPATCH(KernelNormalize4, (m_comps, 0, m_size));
+}
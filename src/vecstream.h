@@ -0,0 +1,171 @@
+#pragma once
+#ifndef __VECSTREAM_H__
+#define __VECSTREAM_H__
+
+/**
+ *	FILE: vecstream.h
+ *	Structure-of-arrays (SoA) containers for large batches of vec2f/vec3f/vec4f.
+ *	Each component lives in its own aligned array so whole streams can be
+ *	processed with SIMD kernels instead of one vector per function call.
+ *
+ *	Every batch operation has a scalar path that produces bit-identical
+ *	results to the SSE/AVX2 paths (see simd.h for selecting the path).
+ */
+
+// Includes: Standard
+#include <stddef.h>
+
+// Includes: Project
+#include "vec.h"
+#include "simd.h"
+
+/**
+ *	CLASS: vecfStream (BASE)
+ *	Owns numComps aligned float arrays of equal length. Capacity is always
+ *	padded to a multiple of SIMD_WIDTH_MAX so kernels may use aligned loads.
+ */
+template <unsigned numComps>
+class vecfStream
+{
+protected:
+	///////////////////////////////////
+	// Properties
+	float* m_comps[numComps];
+	size_t m_size;
+	size_t m_capacity;
+
+public:
+	///////////////////////////////////
+	// Setup & Initialization
+	explicit vecfStream(size_t size = 0);
+	vecfStream(const vecfStream& other);
+	vecfStream(vecfStream&& other);
+	~vecfStream();
+
+	vecfStream& operator=(const vecfStream& other);
+	vecfStream& operator=(vecfStream&& other);
+
+	///////////////////////////////////
+	// Getter/Setters
+	size_t Size() const
+	{
+		return m_size;
+	}
+
+	// Resize the stream; existing values are preserved, new values are zero
+	void Resize(size_t size);
+
+	// Raw component arrays (aligned to SIMD_ALIGNMENT)
+	float* Comp(unsigned idx)
+	{
+		return m_comps[idx];
+	}
+
+	const float* Comp(unsigned idx) const
+	{
+		return m_comps[idx];
+	}
+
+protected:
+	void Release();
+};
+
+/**
+ *	CLASS: vec2fStream
+ *	Batch of 2D vectors stored as separate x/y arrays.
+ */
+class vec2fStream : public vecfStream<2>
+{
+public:
+	///////////////////////////////////
+	// Setup & Initialization
+	explicit vec2fStream(size_t size = 0);
+	vec2fStream(const vec2f* pVecs, size_t count);
+
+	///////////////////////////////////
+	// Getter/Setters
+	vec2f Get(size_t idx) const;
+	void Set(size_t idx, vec2f v);
+
+	float* X()				{ return m_comps[0]; }
+	const float* X() const	{ return m_comps[0]; }
+	float* Y()				{ return m_comps[1]; }
+	const float* Y() const	{ return m_comps[1]; }
+};
+
+/**
+ *	CLASS: vec3fStream
+ *	Batch of 3D vectors stored as separate x/y/z arrays.
+ */
+class vec3fStream : public vecfStream<3>
+{
+public:
+	///////////////////////////////////
+	// Setup & Initialization
+	explicit vec3fStream(size_t size = 0);
+	vec3fStream(const vec3f* pVecs, size_t count);
+
+	///////////////////////////////////
+	// Getter/Setters
+	vec3f Get(size_t idx) const;
+	void Set(size_t idx, vec3f v);
+
+	float* X()				{ return m_comps[0]; }
+	const float* X() const	{ return m_comps[0]; }
+	float* Y()				{ return m_comps[1]; }
+	const float* Y() const	{ return m_comps[1]; }
+	float* Z()				{ return m_comps[2]; }
+	const float* Z() const	{ return m_comps[2]; }
+
+	///////////////////////////////////
+	// Batch Math
+	// :NOTE: rResult is resized to match the inputs and may alias either input.
+	static void Add(const vec3fStream& s1, const vec3fStream& s2, vec3fStream& rResult);
+	static void Sub(const vec3fStream& s1, const vec3fStream& s2, vec3fStream& rResult);
+	static void Scale(const float fScalar, const vec3fStream& s, vec3fStream& rResult);
+	static void CrossProduct(const vec3fStream& s1, const vec3fStream& s2, vec3fStream& rResult);
+	// pResult must hold s1.Size() floats
+	static void DotProduct(const vec3fStream& s1, const vec3fStream& s2, float* pResult);
+	void Mag(float* pResult) const;	// Magnitude of each vector
+	void Normalize();				// :NOTE: Not verifying that magnitudes are > 0 (same as vec3f)
+};
+
+/**
+ *	CLASS: vec4fStream
+ *	Batch of 4D vectors stored as separate x/y/z/w arrays.
+ */
+class vec4fStream : public vecfStream<4>
+{
+public:
+	///////////////////////////////////
+	// Setup & Initialization
+	explicit vec4fStream(size_t size = 0);
+	vec4fStream(const vec4f* pVecs, size_t count);
+
+	///////////////////////////////////
+	// Getter/Setters
+	vec4f Get(size_t idx) const;
+	void Set(size_t idx, vec4f v);
+
+	float* X()				{ return m_comps[0]; }
+	const float* X() const	{ return m_comps[0]; }
+	float* Y()				{ return m_comps[1]; }
+	const float* Y() const	{ return m_comps[1]; }
+	float* Z()				{ return m_comps[2]; }
+	const float* Z() const	{ return m_comps[2]; }
+	float* W()				{ return m_comps[3]; }
+	const float* W() const	{ return m_comps[3]; }
+
+	///////////////////////////////////
+	// Batch Math
+	// :NOTE: rResult is resized to match the inputs and may alias either input.
+	static void Add(const vec4fStream& s1, const vec4fStream& s2, vec4fStream& rResult);
+	static void Sub(const vec4fStream& s1, const vec4fStream& s2, vec4fStream& rResult);
+	static void Scale(const float fScalar, const vec4fStream& s, vec4fStream& rResult);
+	// pResult must hold s1.Size() floats
+	static void DotProduct(const vec4fStream& s1, const vec4fStream& s2, float* pResult);
+	void Mag(float* pResult) const;	// Magnitude of each vector
+	void Normalize();				// :NOTE: Not verifying that magnitudes are > 0 (same as vec4f)
+};
+
+#endif // #ifndef __VECSTREAM_H__
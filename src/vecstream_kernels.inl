@@ -0,0 +1,152 @@
+/**
+ *	FILE: vecstream_kernels.inl
+ *	vecstream.cpp's batch kernels; included by simd_kernels.inl, once per
+ *	instruction set.
+ */
+
+//////////////////////////////////////////////////////////
+// KERNELS
+// Each kernel processes [begin, end) with the given lane wrapper and
+// finishes any remainder with the scalar instantiation of itself.
+//////////////////////////////////////////////////////////
+
+template <class S>
+static void KernelAdd(const float* pA, const float* pB, float* pResult, size_t begin, size_t end)
+{
+	size_t i = begin;
+	for (; i + S::WIDTH <= end; i += S::WIDTH)
+	{
+		S::Store(pResult + i, S::Add(S::Load(pA + i), S::Load(pB + i)));
+	}
+	for (; i < end; i++)
+	{
+		pResult[i] = SimdScalar::Add(pA[i], pB[i]);
+	}
+}
+
+template <class S>
+static void KernelSub(const float* pA, const float* pB, float* pResult, size_t begin, size_t end)
+{
+	size_t i = begin;
+	for (; i + S::WIDTH <= end; i += S::WIDTH)
+	{
+		S::Store(pResult + i, S::Sub(S::Load(pA + i), S::Load(pB + i)));
+	}
+	for (; i < end; i++)
+	{
+		pResult[i] = SimdScalar::Sub(pA[i], pB[i]);
+	}
+}
+
+template <class S>
+static void KernelScale(const float fScalar, const float* pA, float* pResult, size_t begin, size_t end)
+{
+	typename S::type scalar = S::Set1(fScalar);
+
+	size_t i = begin;
+	for (; i + S::WIDTH <= end; i += S::WIDTH)
+	{
+		S::Store(pResult + i, S::Mul(scalar, S::Load(pA + i)));
+	}
+	for (; i < end; i++)
+	{
+		pResult[i] = SimdScalar::Mul(fScalar, pA[i]);
+	}
+}
+
+// Dot product of numComps-component vectors: ((x1*x2 + y1*y2) + z1*z2) [+ w1*w2]
+template <class S, unsigned numComps>
+static typename S::type LaneDot(const float* const* pA, const float* const* pB, size_t i)
+{
+	typename S::type val_dp = S::Mul(S::Load(pA[0] + i), S::Load(pB[0] + i));
+	for (unsigned c = 1; c < numComps; c++)
+	{
+		val_dp = S::Add(val_dp, S::Mul(S::Load(pA[c] + i), S::Load(pB[c] + i)));
+	}
+	return val_dp;
+}
+
+template <class S, unsigned numComps>
+static void KernelDot(const float* const* pA, const float* const* pB, float* pResult, size_t begin, size_t end)
+{
+	size_t i = begin;
+	for (; i + S::WIDTH <= end; i += S::WIDTH)
+	{
+		S::Store(pResult + i, LaneDot<S, numComps>(pA, pB, i));
+	}
+	for (; i < end; i++)
+	{
+		pResult[i] = LaneDot<SimdScalar, numComps>(pA, pB, i);
+	}
+}
+template <class S> static void KernelDot3(const float* const* pA, const float* const* pB, float* pResult, size_t begin, size_t end) { KernelDot<S, 3>(pA, pB, pResult, begin, end); }
+template <class S> static void KernelDot4(const float* const* pA, const float* const* pB, float* pResult, size_t begin, size_t end) { KernelDot<S, 4>(pA, pB, pResult, begin, end); }
+
+template <class S, unsigned numComps>
+static void KernelMag(const float* const* pA, float* pResult, size_t begin, size_t end)
+{
+	size_t i = begin;
+	for (; i + S::WIDTH <= end; i += S::WIDTH)
+	{
+		S::Store(pResult + i, S::Sqrt(LaneDot<S, numComps>(pA, pA, i)));
+	}
+	for (; i < end; i++)
+	{
+		pResult[i] = SimdScalar::Sqrt(LaneDot<SimdScalar, numComps>(pA, pA, i));
+	}
+}
+template <class S> static void KernelMag3(const float* const* pA, float* pResult, size_t begin, size_t end) { KernelMag<S, 3>(pA, pResult, begin, end); }
+template <class S> static void KernelMag4(const float* const* pA, float* pResult, size_t begin, size_t end) { KernelMag<S, 4>(pA, pResult, begin, end); }
+
+template <class S, unsigned numComps>
+static void LaneNormalize(float* const* pA, size_t i)
+{
+	const float* const* p_const = pA;
+	typename S::type vec_norm = S::Sqrt(LaneDot<S, numComps>(p_const, p_const, i));
+	for (unsigned c = 0; c < numComps; c++)
+	{
+		S::Store(pA[c] + i, S::Div(S::Load(pA[c] + i), vec_norm));
+	}
+}
+
+template <class S, unsigned numComps>
+static void KernelNormalize(float* const* pA, size_t begin, size_t end)
+{
+	size_t i = begin;
+	for (; i + S::WIDTH <= end; i += S::WIDTH)
+	{
+		LaneNormalize<S, numComps>(pA, i);
+	}
+	for (; i < end; i++)
+	{
+		LaneNormalize<SimdScalar, numComps>(pA, i);
+	}
+}
+template <class S> static void KernelNormalize3(float* const* pA, size_t begin, size_t end) { KernelNormalize<S, 3>(pA, begin, end); }
+template <class S> static void KernelNormalize4(float* const* pA, size_t begin, size_t end) { KernelNormalize<S, 4>(pA, begin, end); }
+
+template <class S>
+static void LaneCross(const float* const* pA, const float* const* pB, float* const* pResult, size_t i)
+{
+	typename S::type ax = S::Load(pA[0] + i), ay = S::Load(pA[1] + i), az = S::Load(pA[2] + i);
+	typename S::type bx = S::Load(pB[0] + i), by = S::Load(pB[1] + i), bz = S::Load(pB[2] + i);
+
+	// Same ordering as vec3f::CrossProduct
+	S::Store(pResult[0] + i, S::Sub(S::Mul(ay, bz), S::Mul(az, by)));
+	S::Store(pResult[1] + i, S::Sub(S::Mul(az, bx), S::Mul(ax, bz)));
+	S::Store(pResult[2] + i, S::Sub(S::Mul(ax, by), S::Mul(ay, bx)));
+}
+
+template <class S>
+static void KernelCross(const float* const* pA, const float* const* pB, float* const* pResult, size_t begin, size_t end)
+{
+	size_t i = begin;
+	for (; i + S::WIDTH <= end; i += S::WIDTH)
+	{
+		LaneCross<S>(pA, pB, pResult, i);
+	}
+	for (; i < end; i++)
+	{
+		LaneCross<SimdScalar>(pA, pB, pResult, i);
+	}
+}